@@ -14,6 +14,9 @@
 #include <iostream>
 #include <fstream>
 
+#include "ShaderProgram.h"
+#include "GLStateCache.h"
+
 // include bunny geometry //
 #include "bunny.h"
 
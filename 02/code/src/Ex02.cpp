@@ -9,8 +9,10 @@ void deleteShader();
 char* loadShaderSource(const char* fileName);
 GLuint loadShaderFile(const char* fileName, GLenum shaderType);
 GLuint shaderProgram = 0;
-GLint uniform_projectionMatrix;
-GLint uniform_modelViewMatrix;
+// active uniforms of the program, resolved once after linking //
+ShaderProgram shader;
+GLint uniform_projectionMatrix = -1;
+GLint uniform_modelViewMatrix = -1;
 
 // window controls //
 void updateGL();
@@ -72,7 +74,7 @@ int main (int argc, char **argv) {
 
 void initGL() {
 	glClearColor(0.0, 0.0, 0.0, 0.0);
-	glEnable(GL_DEPTH_TEST);
+	GLStateCache::enable(GL_DEPTH_TEST);
 }
 
 void initShader() {
@@ -121,11 +123,16 @@ void initShader() {
 
 	// set address of fragment color output //
 	glBindFragDataLocation(shaderProgram, 0, "color");
+
+	// look up the uniform locations once instead of every frame //
+	shader.setProgram(shaderProgram);
+	uniform_projectionMatrix = shader.getUniformLocation("projection");
+	uniform_modelViewMatrix = shader.getUniformLocation("modelview");
 }
 
 bool enableShader() {
 	if (shaderProgram > 0) {
-		glUseProgram(shaderProgram);
+		GLStateCache::useProgram(shaderProgram);
 	} else {
 		std::cout << "(enableShader) - Shader program not initialized." << std::endl;
 	}
@@ -133,14 +140,14 @@ bool enableShader() {
 }
 
 void disableShader() {
-	glUseProgram(0);
+	GLStateCache::useProgram(0);
 }
 
 void deleteShader() {
 	// use standard pipeline //
-	glUseProgram(0);
+	GLStateCache::useProgram(0);
 	// delete shader program //
-	glDeleteProgram(shaderProgram);
+	GLStateCache::deleteProgram(shaderProgram);
 	shaderProgram = 0;
 }
 
@@ -228,7 +235,7 @@ void initScene() {
 
 	// create VAO, bind it and define both AttribPointers
 	glGenVertexArrays(1, &bunnyVAO);
-	glBindVertexArray(bunnyVAO);
+	GLStateCache::bindVertexArray(bunnyVAO);
 
 	glBindBuffer(GL_ARRAY_BUFFER, bunnyVBO);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
@@ -246,7 +253,7 @@ void initScene() {
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, NUM_TRIANGLES*3*sizeof(GLint), triangles, GL_STATIC_DRAW);
 
 	// unbind active buffers
-	glBindVertexArray(0);
+	GLStateCache::bindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
@@ -254,17 +261,14 @@ void initScene() {
 void deleteScene() {
 	if (bunnyIBO != 0) glDeleteBuffers(1, &bunnyIBO);
 	if (bunnyVBO != 0) glDeleteBuffers(1, &bunnyVBO);
-	if (bunnyVAO != 0) glDeleteVertexArrays(1, &bunnyVAO);
+	if (bunnyVAO != 0) GLStateCache::deleteVertexArrays(1, &bunnyVAO);
 }
 
 void renderScene() {
 	if (bunnyVAO != 0) {
 		// bind bunnyVAO and draw it ;-)
-		glBindVertexArray(bunnyVAO);
+		GLStateCache::bindVertexArray(bunnyVAO);
 		glDrawElements(GL_TRIANGLES, NUM_TRIANGLES*3, GL_UNSIGNED_INT, 0);
-
-		// unbind active buffers //
-		glBindVertexArray(0);
 	}
 }
 
@@ -272,8 +276,8 @@ GLfloat rotAngle = 0;
 void updateGL() {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, false, glm::value_ptr(projectionMatrix));
-	glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "modelview"), 1, false, glm::value_ptr(modelViewMatrix));
+	glUniformMatrix4fv(uniform_projectionMatrix, 1, false, glm::value_ptr(projectionMatrix));
+	glUniformMatrix4fv(uniform_modelViewMatrix, 1, false, glm::value_ptr(modelViewMatrix));
 
 	// now the scene will be rendered //
 	renderScene();
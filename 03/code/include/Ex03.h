@@ -18,6 +18,8 @@
 // load bunny geometry //
 #include "bunny.h"
 #include "ObjLoader.h"
+#include "ShaderProgram.h"
+#include "GLStateCache.h"
 
 std::stack<glm::mat4> glm_ProjectionMatrix; 
 std::stack<glm::mat4> glm_ModelViewMatrix; 
@@ -9,8 +9,10 @@ void deleteShader();
 char* loadShaderSource(const char* fileName);
 GLuint loadShaderFile(const char* fileName, GLenum shaderType);
 GLuint shaderProgram = 0;
-GLint uniform_projectionMatrix;
-GLint uniform_modelViewMatrix;
+// active uniforms of the program, resolved once after linking //
+ShaderProgram shader;
+GLint uniform_projectionMatrix = -1;
+GLint uniform_modelViewMatrix = -1;
 
 // window controls //
 void updateGL();
@@ -72,7 +74,7 @@ int main (int argc, char **argv) {
 
 void initGL() {
   glClearColor(0.0, 0.0, 0.0, 0.0);
-  glEnable(GL_DEPTH_TEST);
+  GLStateCache::enable(GL_DEPTH_TEST);
 }
 
 void initShader() {
@@ -111,11 +113,16 @@ void initShader() {
   
   // set address of fragment color output //
   glBindFragDataLocation(shaderProgram, 0, "color");
+  
+  // look up the uniform locations once instead of for every object //
+  shader.setProgram(shaderProgram);
+  uniform_projectionMatrix = shader.getUniformLocation("projection");
+  uniform_modelViewMatrix = shader.getUniformLocation("modelview");
 }
 
 bool enableShader() {
   if (shaderProgram > 0) {
-    glUseProgram(shaderProgram);
+    GLStateCache::useProgram(shaderProgram);
   } else {
     std::cout << "(enableShader) - Shader program not initialized." << std::endl;
   }
@@ -123,14 +130,14 @@ bool enableShader() {
 }
 
 void disableShader() {
-  glUseProgram(0);
+  GLStateCache::useProgram(0);
 }
 
 void deleteShader() {
   // use standard pipeline //
-  glUseProgram(0);
+  GLStateCache::useProgram(0);
   // delete shader program //
-  glDeleteProgram(shaderProgram);
+  GLStateCache::deleteProgram(shaderProgram);
   shaderProgram = 0;
 }
 
@@ -190,7 +197,7 @@ void initScene() {
   if (bunnyVAO == 0) {
     glGenVertexArrays(1, &bunnyVAO);
   }
-  glBindVertexArray(bunnyVAO);
+  GLStateCache::bindVertexArray(bunnyVAO);
   
   glGenBuffers(2, bunnyVBOs);
   
@@ -213,7 +220,7 @@ void initScene() {
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, 3 * NUM_TRIANGLES * sizeof(GLint), triangles, GL_STATIC_DRAW);
   
   // unbind buffers //
-  glBindVertexArray(0);
+  GLStateCache::bindVertexArray(0);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
   glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
@@ -221,19 +228,16 @@ void initScene() {
 void deleteScene() {
   glDeleteBuffers(1, &bunnyIBO);
   glDeleteBuffers(2, bunnyVBOs);
-  glDeleteVertexArrays(1, &bunnyVAO);
+  GLStateCache::deleteVertexArrays(1, &bunnyVAO);
 }
 
 void renderScene() {
   if (bunnyVAO != 0) {
     // init vertex attribute arrays //
-    glBindVertexArray(bunnyVAO);
+    GLStateCache::bindVertexArray(bunnyVAO);
     
     // render VAO as triangles //
     glDrawElements(GL_TRIANGLES, 3 * NUM_TRIANGLES, GL_UNSIGNED_INT, (void*)0);
-    
-    // unbind buffers //
-    glBindVertexArray(0);
   } else {
     initScene();
   }
@@ -244,7 +248,7 @@ void updateGL() {
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   
   // projection matrix stays the same //
-  glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
+  glUniformMatrix4fv(uniform_projectionMatrix, 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
   
   // init scene graph by cloning the top entry, which can now be manipulated //
   glm_ModelViewMatrix.push(glm_ModelViewMatrix.top());
@@ -261,7 +265,7 @@ void updateGL() {
   //  - use glm_ModelViewMatrix.push(...) and glm_ModelViewMatrix.pop()   
   //  - apply new transformations by using: glm_ModelViewMatrix.top() *= glm::some_transformation(...);
   //  - right before rendering an object, upload the current state of the modelView matrix stack:
-  //    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "modelview"), 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+  //    glUniformMatrix4fv(uniform_modelViewMatrix, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
   
   // Variable sorgt für abwechselndes Zeichnen des Hasen und der Ringe
   bool bunny = true;
@@ -273,6 +277,9 @@ void updateGL() {
   // Bestimmt den Abstand zwischen den Objekten
   float factor = 0.25f;
 
+  // the mesh is looked up once, not for every copy //
+  MeshObj *sceneObject = objLoader.getMeshObj("scene");
+
   // Zwei Schleifen, die ein 5x5-Grid erzeugen
   for(float x=-20.0f; x<30.0f; x+=1.0f) {
       for(float z=-20.0f; z<30.0f; z+=1.0f) {
@@ -287,15 +294,15 @@ void updateGL() {
               // Die Bunnys sollen sich GEGEN den Uhrzeigersinn um die y-Achse drehen
               glm_ModelViewMatrix.top() *= glm::rotate(rotAngle, 0.f, 1.0f, 0.f);
               // Die aktuell oberste Matrix möchten wir zur Transformation nutzen
-              glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "modelview"), 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+              glUniformMatrix4fv(uniform_modelViewMatrix, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
               // Bunny zeichnen
               renderScene();
           } else {
               // Soll das andere Objekt gezeichnet werden, skaliere um Faktor 20 runter ...
               glm_ModelViewMatrix.top() *= glm::scale(1.0f/20.0f,1.0f/20.0f,1.0f/20.0f);
-              glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "modelview"), 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+              glUniformMatrix4fv(uniform_modelViewMatrix, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
               // ... und zeichne das "scene"-Objekt
-              objLoader.getMeshObj("scene")->render();
+              sceneObject->render();
           }
 
           // Hase und Ringe wechseln sich ab
@@ -15,7 +15,7 @@ MeshObj::~MeshObj() {
 	glDeleteBuffers(1, &mIBO);
 	glDeleteBuffers(1, &mVBO_position);
 	glDeleteBuffers(1, &mVBO_normal);
-	glDeleteVertexArrays(1, &mVAO);
+	GLStateCache::deleteVertexArrays(1, &mVAO);
 }
 
 void MeshObj::setData(const MeshData &meshData) {
@@ -37,7 +37,7 @@ void MeshObj::setData(const MeshData &meshData) {
 
 	// create VAO //
 	glGenVertexArrays(1, &mVAO);
-	glBindVertexArray(mVAO);
+	GLStateCache::bindVertexArray(mVAO);
 
 	// create and bind VBOs and upload data (one VBO per vertex attribute -> position, normal) //
 	glGenBuffers(1, &mVBO_position);
@@ -58,7 +58,7 @@ void MeshObj::setData(const MeshData &meshData) {
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndexCount * sizeof(GLuint), ind, GL_STATIC_DRAW);
 
 	// unbind buffers //
-	glBindVertexArray(0);
+	GLStateCache::bindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
@@ -71,9 +71,7 @@ void MeshObj::setData(const MeshData &meshData) {
 void MeshObj::render(void) {
 	if (mVAO != 0) {
 		// render your VAO //
-		glBindVertexArray(mVAO);
+		GLStateCache::bindVertexArray(mVAO);
 		glDrawElements(GL_TRIANGLES, mIndexCount ,GL_UNSIGNED_INT, 0);
-
-		glBindVertexArray(0);
 	}
 }
@@ -0,0 +1,51 @@
+#ifndef __SHADER_PROGRAM__
+#define __SHADER_PROGRAM__
+
+#include <GL/glew.h>
+
+#include <vector>
+#include <string>
+
+#include "GLStateCache.h"
+
+// #INFO# table of the active uniforms of a linked GLSL program //
+// the table is read once after linking (glGetActiveUniform) and sorted by a hash of the names -> a name is
+// resolved without any GL call or string map. the programs resolve their uniforms once into structs of
+// locations, per draw only these plain values are used. the program itself stays owned by the caller.
+class ShaderProgram {
+  public:
+    ShaderProgram();
+
+    // reads the active uniforms of the linked 'program', replaces the previous table //
+    void setProgram(GLuint program);
+    GLuint getProgram(void) const { return mProgram; }
+    void use(void) const { GLStateCache::useProgram(mProgram); }
+
+    // location of an active uniform, array elements as "name[i]", -1 if the uniform is not used by the program //
+    GLint getUniformLocation(const char *name) const;
+    GLuint getUniformCount(void) const { return mUniforms.size(); }
+
+    // FNV-1a hash of a uniform name //
+    static unsigned int hashName(const char *name) {
+      unsigned int hash = 2166136261u;
+      for (; *name != '\0'; ++name) {
+        hash = (hash ^ (unsigned char)*name) * 16777619u;
+      }
+      return hash;
+    }
+
+  private:
+    struct Uniform {
+      unsigned int hash;
+      std::string name;
+      GLint location;
+      static bool less(const Uniform &a, const Uniform &b) { return a.hash < b.hash || (a.hash == b.hash && a.name < b.name); }
+    };
+
+    void addUniform(const std::string &name, GLint location);
+
+    GLuint mProgram;
+    std::vector<Uniform> mUniforms;
+};
+
+#endif
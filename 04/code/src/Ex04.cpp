@@ -9,8 +9,12 @@ void deleteShader();
 char* loadShaderSource(const char* fileName);
 GLuint loadShaderFile(const char* fileName, GLenum shaderType);
 GLuint shaderProgram = 0;
-GLint uniform_projectionMatrix;
-GLint uniform_modelViewMatrix;
+// active uniforms of the program, resolved once after linking //
+ShaderProgram shader;
+GLint uniform_projectionMatrix = -1;
+GLint uniform_modelViewMatrix = -1;
+GLint uniform_useOverrideColor = -1;
+GLint uniform_overrideColor = -1;
 const float M_PI = 3.141592653;
 
 // window controls //
@@ -93,7 +97,7 @@ int main (int argc, char **argv) {
 
 void initGL() {
   glClearColor(0.0, 0.0, 0.0, 0.0);
-  glEnable(GL_DEPTH_TEST);
+  GLStateCache::enable(GL_DEPTH_TEST);
 }
 
 void initShader() {
@@ -140,11 +144,18 @@ void initShader() {
   
   // set address of fragment color output //
   glBindFragDataLocation(shaderProgram, 0, "color");
+  
+  // look up the uniform locations once instead of for every draw //
+  shader.setProgram(shaderProgram);
+  uniform_projectionMatrix = shader.getUniformLocation("projection");
+  uniform_modelViewMatrix = shader.getUniformLocation("modelview");
+  uniform_useOverrideColor = shader.getUniformLocation("use_override_color");
+  uniform_overrideColor = shader.getUniformLocation("override_color");
 }
 
 bool enableShader() {
   if (shaderProgram > 0) {
-    glUseProgram(shaderProgram);
+    GLStateCache::useProgram(shaderProgram);
   } else {
     std::cout << "(enableShader) - Shader program not initialized." << std::endl;
   }
@@ -152,14 +163,14 @@ bool enableShader() {
 }
 
 void disableShader() {
-  glUseProgram(0);
+  GLStateCache::useProgram(0);
 }
 
 void deleteShader() {
   // use standard pipeline //
-  glUseProgram(0);
+  GLStateCache::useProgram(0);
   // delete shader program //
-  glDeleteProgram(shaderProgram);
+  GLStateCache::deleteProgram(shaderProgram);
   shaderProgram = 0;
 }
 
@@ -247,7 +258,7 @@ void initScene() {
   if (cubeVAO == 0) {
     glGenVertexArrays(1, &cubeVAO);
   }
-  glBindVertexArray(cubeVAO);
+  GLStateCache::bindVertexArray(cubeVAO);
   
   // create and bind VBOs and upload data (one VBO per vertex attribute -> position, normal) //
   if (cubeVBO == 0) {
@@ -266,12 +277,12 @@ void initScene() {
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, 24 * sizeof(GLuint), &frustumIndices[0], GL_STATIC_DRAW);
   
   // unbind buffers //
-  glBindVertexArray(0);
+  GLStateCache::bindVertexArray(0);
 
 }
 
 void deleteScene() {
-  glDeleteVertexArrays(1, &cubeVAO);
+  GLStateCache::deleteVertexArrays(1, &cubeVAO);
   glDeleteBuffers(1, &cubeVBO);
   glDeleteBuffers(1, &cubeIBO);
 }
@@ -279,7 +290,7 @@ void deleteScene() {
 void renderScene() {
   glm_ModelViewMatrix.push(glm_ModelViewMatrix.top());
   // upload modelview matrix to shader //
-  glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "modelview"), 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+  glUniformMatrix4fv(uniform_modelViewMatrix, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
   
   // render 'scene.obj' //
   objLoader.getMeshObj("scene")->render();
@@ -311,13 +322,13 @@ void updateGL() {
   glViewport(0,0,512,512);
   
   // disable custom color in shader //
-  glUniform1i(glGetUniformLocation(shaderProgram, "use_override_color"), 0);
+  glUniform1i(uniform_useOverrideColor, 0);
   
   // get projection mat from camera controller (cameraView) and set it as top value of glm_ProjectionMatrix //
   glm_ProjectionMatrix.push(cameraView.getProjectionMat());
   
   // upload projection matrix to shader //
-  glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
+  glUniformMatrix4fv(uniform_projectionMatrix, 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
 
   glm_ProjectionMatrix.pop();
   
@@ -337,7 +348,7 @@ void updateGL() {
   //glm_ProjectionMatrix.top() = cameraView.getProjectionMat();
   
   // upload projection matrix to shader //
-  glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
+  glUniformMatrix4fv(uniform_projectionMatrix, 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
   
   // get modelview mat from camera controller //
   glm_ModelViewMatrix.top() = sceneView.getModelViewMat();
@@ -359,10 +370,10 @@ void updateGL() {
   glm_ModelViewMatrix.top() *= inversedModelViewMat;
   
   // upload modelview matrix configuration to shader just before rendering //
-  glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "modelview"), 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+  glUniformMatrix4fv(uniform_modelViewMatrix, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
   // use custom color for camera object //
-  glUniform1i(glGetUniformLocation(shaderProgram, "use_override_color"), 1);
-  glUniform3f(glGetUniformLocation(shaderProgram, "override_color"), 1, 0, 1);
+  glUniform1i(uniform_useOverrideColor, 1);
+  glUniform3f(uniform_overrideColor, 1, 0, 1);
   // render the camera object //
   objLoader.getMeshObj("camera")->render();
   
@@ -373,12 +384,12 @@ void updateGL() {
   glm_ModelViewMatrix.top() *= inversedProjectionMat;
   
   // upload modelview matrix configuration to shader just before rendering //
-  glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "modelview"), 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+  glUniformMatrix4fv(uniform_modelViewMatrix, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
   // use custom color for camera object //
-  glUniform1i(glGetUniformLocation(shaderProgram, "use_override_color"), 1);
-  glUniform3f(glGetUniformLocation(shaderProgram, "override_color"), 1, 0, 0);
+  glUniform1i(uniform_useOverrideColor, 1);
+  glUniform3f(uniform_overrideColor, 1, 0, 0);
   // render the frustum unit-cube 'cubeVAO' consisting of 12 edges each with two vertices (draw mode: GL_LINES) //
-  glBindVertexArray(cubeVAO);
+  GLStateCache::bindVertexArray(cubeVAO);
   glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, 0);
   
   // restore modelview matrix //
@@ -14,7 +14,7 @@ MeshObj::~MeshObj() {
   glDeleteBuffers(1, &mIBO);
   glDeleteBuffers(1, &mVBO_position);
   glDeleteBuffers(1, &mVBO_normal);
-  glDeleteVertexArrays(1, &mVAO);
+  GLStateCache::deleteVertexArrays(1, &mVAO);
 }
 
 void MeshObj::setData(const MeshData &meshData) {
@@ -38,7 +38,7 @@ void MeshObj::setData(const MeshData &meshData) {
   if (mVAO == 0) {
     glGenVertexArrays(1, &mVAO);
   }
-  glBindVertexArray(mVAO);
+  GLStateCache::bindVertexArray(mVAO);
   
   // create and bind VBOs and upload data (one VBO per available vertex attribute -> position, normal) //
   if (mVBO_position == 0) {
@@ -67,7 +67,7 @@ void MeshObj::setData(const MeshData &meshData) {
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndexCount * sizeof(GLuint), &indices[0], GL_STATIC_DRAW);
   
   // unbind buffers //
-  glBindVertexArray(0);
+  GLStateCache::bindVertexArray(0);
   
   // make sure to clean up temporarily allocated data, if neccessary //
   delete[] vertex_position;
@@ -80,8 +80,7 @@ void MeshObj::setData(const MeshData &meshData) {
 void MeshObj::render(void) {
   // render your VAO //
   if (mVAO != 0) {
-    glBindVertexArray(mVAO);
+    GLStateCache::bindVertexArray(mVAO);
     glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, (void*)0);
-    glBindVertexArray(0);
   }
 }
@@ -20,6 +20,8 @@
 
 #include "ObjLoader.h"
 #include "CameraController.h"
+#include "ShaderProgram.h"
+#include "GLStateCache.h"
 
 
 
@@ -10,8 +10,28 @@ char* loadShaderSource(const char* fileName);
 GLuint loadShaderFile(const char* fileName, GLenum shaderType);
 // the used shader program //
 GLuint shaderProgram = 0;
-// this map stores uniform locations of our shader program //
-std::map<std::string, GLint> uniformLocations;
+// active uniforms of the program, resolved once after linking //
+ShaderProgram shader;
+// these structs store the uniform locations of our shader program -> no lookups while rendering //
+struct UniformLocation_Light {
+  GLint ambient_color;
+  GLint diffuse_color;
+  GLint specular_color;
+  GLint position;
+};
+struct UniformLocation_Material {
+  GLint ambient_color;
+  GLint diffuse_color;
+  GLint specular_color;
+  GLint specular_shininess;
+};
+struct UniformLocations {
+  GLint projection;
+  GLint modelview;
+  UniformLocation_Light lightSource;
+  UniformLocation_Material material;
+};
+UniformLocations uniformLocations;
 
 // window controls //
 void updateGL();
@@ -107,7 +127,7 @@ int main (int argc, char **argv) {
 
 void initGL() {
   glClearColor(0.0, 0.0, 0.0, 0.0);
-  glEnable(GL_DEPTH_TEST);
+  GLStateCache::enable(GL_DEPTH_TEST);
 }
 
 void initShader() {
@@ -156,10 +176,11 @@ void initShader() {
   glBindFragDataLocation(shaderProgram, 0, "color");
   
   // get uniform locations for common variables //
-  uniformLocations["projection"] = glGetUniformLocation(shaderProgram, "projection");
-  uniformLocations["modelview"] = glGetUniformLocation(shaderProgram, "modelview");
+  shader.setProgram(shaderProgram);
+  uniformLocations.projection = shader.getUniformLocation("projection");
+  uniformLocations.modelview = shader.getUniformLocation("modelview");
   // TODO: insert the uniform locations for all light and material properties
-  // - insert then into the provided map 'uniformLocations' and give them a proper identifier
+  // - store them in the provided struct 'uniformLocations'
   // - when accessing a GLSL uniform within a struct (as used in the provided vertex shader),
   //   use the following technique: glGetUniformLocation(shaderID, "structName.propertyName")
   //   So, when having a struct 
@@ -168,20 +189,20 @@ void initShader() {
   //     uniform MyStruct MyStructUniform;
   //   you can get the location of MyVector by passing the string "MyStructUniform.MyVector" to
   //   glGetUniformLocation(...)
-  uniformLocations["lightSource.ambient_color"] = glGetUniformLocation(shaderProgram, "lightSource.ambient_color");
-  uniformLocations["lightSource.diffuse_color"] = glGetUniformLocation(shaderProgram, "lightSource.diffuse_color");
-  uniformLocations["lightSource.specular_color"] = glGetUniformLocation(shaderProgram, "lightSource.specular_color");
-  uniformLocations["lightSource.position"] = glGetUniformLocation(shaderProgram, "lightSource.position");
-
-  uniformLocations["material.ambient_color"] = glGetUniformLocation(shaderProgram, "material.ambient_color");
-  uniformLocations["material.diffuse_color"] = glGetUniformLocation(shaderProgram, "material.diffuse_color");
-  uniformLocations["material.specular_color"] = glGetUniformLocation(shaderProgram, "material.specular_color");
-  uniformLocations["material.specular_shininess"] = glGetUniformLocation(shaderProgram, "material.specular_shininess");
+  uniformLocations.lightSource.ambient_color = shader.getUniformLocation("lightSource.ambient_color");
+  uniformLocations.lightSource.diffuse_color = shader.getUniformLocation("lightSource.diffuse_color");
+  uniformLocations.lightSource.specular_color = shader.getUniformLocation("lightSource.specular_color");
+  uniformLocations.lightSource.position = shader.getUniformLocation("lightSource.position");
+
+  uniformLocations.material.ambient_color = shader.getUniformLocation("material.ambient_color");
+  uniformLocations.material.diffuse_color = shader.getUniformLocation("material.diffuse_color");
+  uniformLocations.material.specular_color = shader.getUniformLocation("material.specular_color");
+  uniformLocations.material.specular_shininess = shader.getUniformLocation("material.specular_shininess");
 }
 
 bool enableShader() {
   if (shaderProgram > 0) {
-    glUseProgram(shaderProgram);
+    GLStateCache::useProgram(shaderProgram);
   } else {
     std::cout << "(enableShader) - Shader program not initialized." << std::endl;
   }
@@ -189,14 +210,14 @@ bool enableShader() {
 }
 
 void disableShader() {
-  glUseProgram(0);
+  GLStateCache::useProgram(0);
 }
 
 void deleteShader() {
   // use standard pipeline //
-  glUseProgram(0);
+  GLStateCache::useProgram(0);
   // delete shader program //
-  glDeleteProgram(shaderProgram);
+  GLStateCache::deleteProgram(shaderProgram);
   shaderProgram = 0;
 }
 
@@ -329,25 +350,25 @@ void renderScene() {
   glm_ModelViewMatrix.push(glm_ModelViewMatrix.top());
   glm_ModelViewMatrix.top() *= glm::scale(glm::vec3(20.0));
   
-  glUniformMatrix4fv(uniformLocations["modelview"], 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+  glUniformMatrix4fv(uniformLocations.modelview, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
   
   // TODO: upload the properties of the currently chosen light source here //
   // - ambient, diffuse and specular color
   // - position
   // - use glm::value_ptr() to get a proper reference when uploading the values as a data vector //
-  glUniform3fv(uniformLocations["lightSource.ambient_color"], 1, glm::value_ptr(lights[lightIndex].ambient_color));
-  glUniform3fv(uniformLocations["lightSource.diffuse_color"], 1, glm::value_ptr(lights[lightIndex].diffuse_color));
-  glUniform3fv(uniformLocations["lightSource.specular_color"], 1, glm::value_ptr(lights[lightIndex].specular_color));
-  glUniform3fv(uniformLocations["lightSource.position"], 1, glm::value_ptr(lights[lightIndex].position));
+  glUniform3fv(uniformLocations.lightSource.ambient_color, 1, glm::value_ptr(lights[lightIndex].ambient_color));
+  glUniform3fv(uniformLocations.lightSource.diffuse_color, 1, glm::value_ptr(lights[lightIndex].diffuse_color));
+  glUniform3fv(uniformLocations.lightSource.specular_color, 1, glm::value_ptr(lights[lightIndex].specular_color));
+  glUniform3fv(uniformLocations.lightSource.position, 1, glm::value_ptr(lights[lightIndex].position));
   
   // TODO: upload the chosen material properties here //
   // - upload ambient, diffuse and specular color as 3d-vector
   // - upload shininess exponent as simple float value
   
-  glUniform3fv(uniformLocations["material.ambient_color"], 1, glm::value_ptr(materials[materialIndex].ambient_color));
-  glUniform3fv(uniformLocations["material.diffuse_color"], 1, glm::value_ptr(materials[materialIndex].diffuse_color));
-  glUniform3fv(uniformLocations["material.specular_color"], 1, glm::value_ptr(materials[materialIndex].specular_color));
-  glUniform1f(uniformLocations["material.specular_shininess"], materials[materialIndex].specular_shininess);
+  glUniform3fv(uniformLocations.material.ambient_color, 1, glm::value_ptr(materials[materialIndex].ambient_color));
+  glUniform3fv(uniformLocations.material.diffuse_color, 1, glm::value_ptr(materials[materialIndex].diffuse_color));
+  glUniform3fv(uniformLocations.material.specular_color, 1, glm::value_ptr(materials[materialIndex].specular_color));
+  glUniform1f(uniformLocations.material.specular_shininess, materials[materialIndex].specular_shininess);
   
   // render the actual object //
   objLoader.getMeshObj("bunny")->render();
@@ -365,7 +386,7 @@ void updateGL() {
   // get projection mat from camera controller //
   glm_ProjectionMatrix.top() = camera.getProjectionMat();
   // upload projection matrix //
-  glUniformMatrix4fv(uniformLocations["projection"], 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
+  glUniformMatrix4fv(uniformLocations.projection, 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
   
   // init scene graph by cloning the top entry, which can now be manipulated //
   // get modelview mat from camera controller //
@@ -20,6 +20,9 @@
 
 #include "ObjLoader.h"
 #include "CameraController.h"
+#include "ShaderProgram.h"
+#include "GLStateCache.h"
+#include "UniformBuffer.h"
 
 std::stack<glm::mat4> glm_ProjectionMatrix; 
 std::stack<glm::mat4> glm_ModelViewMatrix; 
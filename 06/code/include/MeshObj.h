@@ -7,6 +7,8 @@
 #include <vector>
 #include <stack>
 
+#include "GLStateCache.h"
+
 struct MeshData {
   // data vectors //
   std::vector<GLfloat> vertex_position;
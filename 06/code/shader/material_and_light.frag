@@ -15,11 +15,17 @@ struct Material {
 };
 
 // TODO: set up uniforms for multiple light sources //
-uniform LightSource ls[10];
-uniform int activeLightSources;
+// std140 block -> the application writes it with fixed offsets //
+layout(std140) uniform Lights {
+  LightSource ls[10];
+  int activeLightSources;
+};
 
-// uniform for the used material //
-uniform Material material;
+// table of all materials, the used one is selected by its index //
+layout(std140) uniform Materials {
+  Material materials[8];
+  int materialIndex;
+};
 //uniform LightSource lightsource;
 
 // fragment normal //
@@ -34,6 +40,7 @@ in vec3 lightVec[10];
 out vec4 color;
 
 void main() {
+  Material material = materials[materialIndex];
   // normalize the vectors passed from your vertex program here //
   vec3 E = normalize(eyeDir);
   vec3 N = normalize(vertexNormal);
@@ -11,8 +11,10 @@ struct LightSource {
 };
 
 // TODO: set up uniforms for multiple light sources //
-uniform LightSource ls[10];
-uniform int activeLightSources;
+layout(std140) uniform Lights {
+  LightSource ls[10];
+  int activeLightSources;
+};
 
 // vertex normal //
 out vec3 vertexNormal;
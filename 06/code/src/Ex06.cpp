@@ -11,18 +11,15 @@ char* loadShaderSource(const char* fileName);
 GLuint loadShaderFile(const char* fileName, GLenum shaderType);
 // the used shader program //
 GLuint shaderProgram = 0;
-// this map stores uniform locations of our shader program //
-std::map<std::string, GLint> uniformLocations;
-
-// this struct helps to keep light source parameter uniforms together //
-struct UniformLocation_Light {
-  GLint ambient_color;
-  GLint diffuse_color;
-  GLint specular_color;
-  GLint position;
+// active uniforms of the program, resolved once after linking //
+ShaderProgram shader;
+
+// this struct stores uniform locations of our shader program -> no lookups while rendering //
+struct UniformLocations {
+  GLint projection;
+  GLint modelview;
 };
-// this map stores the light source uniform locations as 'UniformLocation_Light' structs //
-std::map<std::string, UniformLocation_Light> uniformLocations_Lights;
+UniformLocations uniformLocations;
 
 // these structs are also used in the shader code  //
 // this helps to access the parameters more easily //
@@ -49,6 +46,41 @@ std::vector<Material> materials;
 unsigned int lightCount;
 std::vector<LightSource> lights;
 
+// light sources and materials live in std140 uniform blocks (see the shaders) //
+// they are written only after a light was toggled or another material was chosen
+const unsigned int maxLightCount = 10;
+const unsigned int maxMaterialCount = 8;
+enum UniformBlockBinding {
+  BINDING_LIGHTS = 0,
+  BINDING_MATERIALS
+};
+// std140 -> every vec3 starts at a multiple of 16 bytes //
+struct LightBlockEntry {
+  glm::vec3 ambient_color;
+  GLfloat padding0;
+  glm::vec3 diffuse_color;
+  GLfloat padding1;
+  glm::vec3 specular_color;
+  GLfloat padding2;
+  glm::vec3 position;
+  GLfloat padding3;
+};
+struct MaterialBlockEntry {
+  glm::vec3 ambient_color;
+  GLfloat padding0;
+  glm::vec3 diffuse_color;
+  GLfloat padding1;
+  glm::vec3 specular_color;
+  GLfloat specular_shininess;
+};
+// the light count / material index follow the arrays //
+const size_t activeLightSourcesOffset = maxLightCount * sizeof(LightBlockEntry);
+const size_t materialIndexOffset = maxMaterialCount * sizeof(MaterialBlockEntry);
+UniformBuffer lightBlock;
+UniformBuffer materialBlock;
+bool lightsChanged = true;
+bool materialChanged = true;
+
 // window controls //
 void updateGL();
 void idle();
@@ -121,22 +153,13 @@ int main (int argc, char **argv) {
 void toggleLightSource(unsigned int i) {
   if (i < lightCount) {
     lights[i].enabled = !lights[i].enabled;
+    lightsChanged = true;
   }
 }
 
 void initGL() {
   glClearColor(0.0, 0.0, 0.0, 0.0);
-  glEnable(GL_DEPTH_TEST);
-}
-
-std::string getUniformStructLocStr(const std::string &structName, const std::string &memberName, int arrayIndex = -1) {
-  std::stringstream sstr("");
-  sstr << structName;
-  if (arrayIndex >= 0) {
-    sstr << "[" << arrayIndex << "]";
-  }
-  sstr << "." << memberName;
-  return sstr.str();
+  GLStateCache::enable(GL_DEPTH_TEST);
 }
 
 void initShader() {
@@ -185,38 +208,17 @@ void initShader() {
   glBindFragDataLocation(shaderProgram, 0, "color");
   
   // get uniform locations for common variables //
-  uniformLocations["projection"] = glGetUniformLocation(shaderProgram, "projection");
-  uniformLocations["modelview"] = glGetUniformLocation(shaderProgram, "modelview");
-  // material unform locations //
-  uniformLocations["material.ambient"] = glGetUniformLocation(shaderProgram, "material.ambient_color");
-  uniformLocations["material.diffuse"] = glGetUniformLocation(shaderProgram, "material.diffuse_color");
-  uniformLocations["material.specular"] = glGetUniformLocation(shaderProgram, "material.specular_color");
-  uniformLocations["material.shininess"] = glGetUniformLocation(shaderProgram, "material.specular_shininess");
-
-  //save location of count of active lightsources:
-  uniformLocations["activeLightSources"] = glGetUniformLocation(shaderProgram, "activeLightSources");
-  
-  // TODO: store the uniform locations for all light source properties
-  // - create a 'UniformLocation_Light' struct to store the light source parameter uniforms 
-  // - insert this strut into the provided map 'uniformLocations_Lights' and give it a proper name
-  for(int i = 0; i < 10; i++)
-  {
-	  std::stringstream ident("light");
-	  ident << i;
-	  
-	  UniformLocation_Light ul;
-	  ul.ambient_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("ls", "ambient_color", i).c_str());
-	  ul.diffuse_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("ls", "diffuse_color", i).c_str());
-	  ul.specular_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("ls", "specular_color", i).c_str());
-	  ul.position = glGetUniformLocation(shaderProgram, getUniformStructLocStr("ls", "position", i).c_str());
-
-	  uniformLocations_Lights[ident.str()] = ul;
-  }
+  shader.setProgram(shaderProgram);
+  uniformLocations.projection = shader.getUniformLocation("projection");
+  uniformLocations.modelview = shader.getUniformLocation("modelview");
+  // light sources and materials are read from the uniform buffers //
+  shader.bindUniformBlock("Lights", BINDING_LIGHTS);
+  shader.bindUniformBlock("Materials", BINDING_MATERIALS);
 }
 
 bool enableShader() {
   if (shaderProgram > 0) {
-    glUseProgram(shaderProgram);
+    GLStateCache::useProgram(shaderProgram);
   } else {
     std::cout << "(enableShader) - Shader program not initialized." << std::endl;
   }
@@ -224,14 +226,14 @@ bool enableShader() {
 }
 
 void disableShader() {
-  glUseProgram(0);
+  GLStateCache::useProgram(0);
 }
 
 void deleteShader() {
   // use standard pipeline //
-  glUseProgram(0);
+  GLStateCache::useProgram(0);
   // delete shader program //
-  glDeleteProgram(shaderProgram);
+  GLStateCache::deleteProgram(shaderProgram);
   shaderProgram = 0;
 }
 
@@ -396,45 +398,57 @@ void initScene() {
   lightCount = lights.size();
 
   toggleLightSource(0);
+
+  // buffers of the uniform blocks, the material table is written once //
+  lightBlock.create(activeLightSourcesOffset + 16, BINDING_LIGHTS);
+  materialBlock.create(materialIndexOffset + 16, BINDING_MATERIALS);
+  for (unsigned int i = 0; i < materialCount && i < maxMaterialCount; ++i) {
+    MaterialBlockEntry entry;
+    entry.ambient_color = materials[i].ambient_color;
+    entry.diffuse_color = materials[i].diffuse_color;
+    entry.specular_color = materials[i].specular_color;
+    entry.specular_shininess = materials[i].specular_shininess;
+    entry.padding0 = entry.padding1 = 0.0f;
+    materialBlock.write(i * sizeof(MaterialBlockEntry), &entry, sizeof(entry));
+  }
+  lightsChanged = true;
+  materialChanged = true;
 }
 
 void renderScene() {
   glm_ModelViewMatrix.push(glm_ModelViewMatrix.top());
   glm_ModelViewMatrix.top() *= glm::scale(glm::vec3(20.0));
   
-  glUniformMatrix4fv(uniformLocations["modelview"], 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
-  
-  // TODO: upload the properties of the currently active light sources here //
-  // - ambient, diffuse and specular color
-  // - position
-  // - use glm::value_ptr() to get a proper reference when uploading the values as a data vector //
-  LightSource ls;
-  int lightCnt  = 0;
-  for(int i = 0; i < (lightCount < 10 ? lightCount : 10); i++)
-  {
-	  if(lights[i].enabled)
-	  {
-		  std::stringstream id("light");
-		  id << lightCnt;
-
-		  glUniform3fv(uniformLocations_Lights[id.str()].ambient_color, 1, glm::value_ptr(lights[i].ambient_color));
-		  glUniform3fv(uniformLocations_Lights[id.str()].diffuse_color, 1, glm::value_ptr(lights[i].diffuse_color));
-		  glUniform3fv(uniformLocations_Lights[id.str()].specular_color, 1, glm::value_ptr(lights[i].specular_color));
-		  glUniform3fv(uniformLocations_Lights[id.str()].position, 1, glm::value_ptr(lights[i].position));
-		  lightCnt++;
-	  }
+  glUniformMatrix4fv(uniformLocations.modelview, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+  
+  // upload the properties of the currently active light sources, only after a light was toggled //
+  // entries equal to the uploaded ones are skipped by the UniformBuffer
+  if (lightsChanged) {
+    GLint lightCnt = 0;
+    for (unsigned int i = 0; i < lightCount && lightCnt < (GLint)maxLightCount; ++i) {
+      if (lights[i].enabled) {
+        LightBlockEntry entry;
+        entry.ambient_color = lights[i].ambient_color;
+        entry.diffuse_color = lights[i].diffuse_color;
+        entry.specular_color = lights[i].specular_color;
+        entry.position = lights[i].position;
+        entry.padding0 = entry.padding1 = entry.padding2 = entry.padding3 = 0.0f;
+        lightBlock.write(lightCnt * sizeof(LightBlockEntry), &entry, sizeof(entry));
+        ++lightCnt;
+      }
+    }
+    lightBlock.write(activeLightSourcesOffset, &lightCnt, sizeof(lightCnt));
+    lightBlock.upload();
+    lightsChanged = false;
   }
 
-  glUniform1i(uniformLocations["activeLightSources"], lightCnt);
-  
-  glUniform1i(uniformLocations["activeLightSources"],lightCnt);
-  // upload the chosen material properties here //
-  // - upload ambient, diffuse and specular color as 3d-vector
-  // - upload shininess exponent as simple float value
-  glUniform3fv(uniformLocations["material.ambient"], 1, glm::value_ptr(materials[materialIndex].ambient_color));
-  glUniform3fv(uniformLocations["material.diffuse"], 1, glm::value_ptr(materials[materialIndex].diffuse_color));
-  glUniform3fv(uniformLocations["material.specular"], 1, glm::value_ptr(materials[materialIndex].specular_color));
-  glUniform1f(uniformLocations["material.shininess"], materials[materialIndex].specular_shininess);
+  // select the chosen material of the table //
+  if (materialChanged) {
+    GLint index = materialIndex;
+    materialBlock.write(materialIndexOffset, &index, sizeof(index));
+    materialBlock.upload();
+    materialChanged = false;
+  }
   
   // render the actual object //
   objLoader.getMeshObj("bunny")->render();
@@ -452,7 +466,7 @@ void updateGL() {
   // get projection mat from camera controller //
   glm_ProjectionMatrix.top() = camera.getProjectionMat();
   // upload projection matrix //
-  glUniformMatrix4fv(uniformLocations["projection"], 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
+  glUniformMatrix4fv(uniformLocations.projection, 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
   
   // init scene graph by cloning the top entry, which can now be manipulated //
   // get modelview mat from camera controller //
@@ -523,6 +537,7 @@ void keyboardEvent(unsigned char key, int x, int y) {
     case 'm': {
       materialIndex++;
       if (materialIndex >= materialCount) materialIndex = 0;
+      materialChanged = true;
       break;
     }
     case '0':
@@ -0,0 +1,73 @@
+#include "ShaderProgram.h"
+
+#include <algorithm>
+#include <sstream>
+
+ShaderProgram::ShaderProgram() {
+  mProgram = 0;
+}
+
+void ShaderProgram::setProgram(GLuint program) {
+  mProgram = program;
+  mUniforms.clear();
+  GLint uniformCount = 0;
+  GLint maxNameLength = 0;
+  if (program != 0) {
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+  }
+  std::vector<GLchar> nameBuffer(maxNameLength + 1);
+  for (GLint i = 0; i < uniformCount; ++i) {
+    GLsizei nameLength = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(program, i, nameBuffer.size(), &nameLength, &size, &type, &nameBuffer[0]);
+    std::string name(&nameBuffer[0], nameLength);
+    GLint location = glGetUniformLocation(program, name.c_str());
+    if (location < 0) {
+      // members of uniform blocks have no location //
+      continue;
+    }
+    // arrays are reported once as "name[0]" -> every element gets an entry, the first one also without index //
+    if (size > 1 || (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)) {
+      const std::string baseName = name.substr(0, name.rfind('['));
+      addUniform(baseName, location);
+      for (GLint element = 0; element < size; ++element) {
+        std::stringstream sstr("");
+        sstr << baseName << "[" << element << "]";
+        addUniform(sstr.str(), glGetUniformLocation(program, sstr.str().c_str()));
+      }
+    } else {
+      addUniform(name, location);
+    }
+  }
+  std::sort(mUniforms.begin(), mUniforms.end(), Uniform::less);
+}
+
+void ShaderProgram::addUniform(const std::string &name, GLint location) {
+  Uniform uniform;
+  uniform.hash = hashName(name.c_str());
+  uniform.name = name;
+  uniform.location = location;
+  mUniforms.push_back(uniform);
+}
+
+GLint ShaderProgram::getUniformLocation(const char *name) const {
+  Uniform key;
+  key.hash = hashName(name);
+  key.name = name;
+  std::vector<Uniform>::const_iterator uniform = std::lower_bound(mUniforms.begin(), mUniforms.end(), key, Uniform::less);
+  if (uniform != mUniforms.end() && uniform->hash == key.hash && uniform->name == key.name) {
+    return uniform->location;
+  }
+  return -1;
+}
+
+bool ShaderProgram::bindUniformBlock(const char *name, GLuint binding) const {
+  GLuint index = glGetUniformBlockIndex(mProgram, name);
+  if (index == GL_INVALID_INDEX) {
+    return false;
+  }
+  glUniformBlockBinding(mProgram, index, binding);
+  return true;
+}
@@ -13,18 +13,33 @@ char* loadShaderSource(const char* fileName);
 GLuint loadShaderFile(const char* fileName, GLenum shaderType);
 // the used shader program //
 GLuint shaderProgram = 0;
-// this map stores uniform locations of our shader program //
-std::map<std::string, GLint> uniformLocations;
+// active uniforms of the program, resolved once after linking //
+ShaderProgram shader;
 
-// this struct helps to keep light source parameter uniforms together //
+// these structs help to keep light source and material parameter uniforms together //
 struct UniformLocation_Light {
 	GLint ambient_color;
 	GLint diffuse_color;
 	GLint specular_color;
 	GLint position;
 };
-// this map stores the light source uniform locations as 'UniformLocation_Light' structs //
-std::map<std::string, UniformLocation_Light> uniformLocations_Lights;
+struct UniformLocation_Material {
+	GLint ambient;
+	GLint diffuse;
+	GLint specular;
+	GLint shininess;
+};
+// this struct stores uniform locations of our shader program -> no lookups while rendering //
+struct UniformLocations {
+	GLint projection;
+	GLint modelview;
+	UniformLocation_Material material;
+	GLint usedLightCount;
+	GLint tex;
+};
+UniformLocations uniformLocations;
+// light source uniform locations, one 'UniformLocation_Light' struct per light of the shader //
+UniformLocation_Light uniformLocations_Lights[10];
 
 // these structs are also used in the shader code  //
 // this helps to access the parameters more easily //
@@ -159,7 +174,7 @@ int main (int argc, char **argv) {
 
 void initGL() {
 	glClearColor(0.0, 0.0, 0.0, 0.0);
-	glEnable(GL_DEPTH_TEST);
+	GLStateCache::enable(GL_DEPTH_TEST);
 }
 
 std::string getUniformStructLocStr(const std::string &structName, const std::string &memberName, int arrayIndex = -1) {
@@ -218,36 +233,35 @@ void initShader() {
 	glBindFragDataLocation(shaderProgram, 0, "color");
 
 	// get uniform locations for common variables //
-	uniformLocations["projection"] = glGetUniformLocation(shaderProgram, "projection");
-	uniformLocations["modelview"] = glGetUniformLocation(shaderProgram, "modelview");
+	shader.setProgram(shaderProgram);
+	uniformLocations.projection = shader.getUniformLocation("projection");
+	uniformLocations.modelview = shader.getUniformLocation("modelview");
 
 	// material unform locations //
-	uniformLocations["material.ambient"] = glGetUniformLocation(shaderProgram, "material.ambient_color");
-	uniformLocations["material.diffuse"] = glGetUniformLocation(shaderProgram, "material.diffuse_color");
-	uniformLocations["material.specular"] = glGetUniformLocation(shaderProgram, "material.specular_color");
-	uniformLocations["material.shininess"] = glGetUniformLocation(shaderProgram, "material.specular_shininess");
+	uniformLocations.material.ambient = shader.getUniformLocation("material.ambient_color");
+	uniformLocations.material.diffuse = shader.getUniformLocation("material.diffuse_color");
+	uniformLocations.material.specular = shader.getUniformLocation("material.specular_color");
+	uniformLocations.material.shininess = shader.getUniformLocation("material.specular_shininess");
 
 	// store the uniform locations for all light source properties
 	for (int i = 0; i < 10; ++i) {
 		UniformLocation_Light lightLocation;
-		lightLocation.ambient_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "ambient_color", i).c_str());
-		lightLocation.diffuse_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "diffuse_color", i).c_str());
-		lightLocation.specular_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "specular_color", i).c_str());
-		lightLocation.position = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "position", i).c_str());
-
-		std::stringstream sstr("");
-		sstr << "light_" << i;
-		uniformLocations_Lights[sstr.str()] = lightLocation;
+		lightLocation.ambient_color = shader.getUniformLocation(getUniformStructLocStr("lightSource", "ambient_color", i).c_str());
+		lightLocation.diffuse_color = shader.getUniformLocation(getUniformStructLocStr("lightSource", "diffuse_color", i).c_str());
+		lightLocation.specular_color = shader.getUniformLocation(getUniformStructLocStr("lightSource", "specular_color", i).c_str());
+		lightLocation.position = shader.getUniformLocation(getUniformStructLocStr("lightSource", "position", i).c_str());
+
+		uniformLocations_Lights[i] = lightLocation;
 	}
-	uniformLocations["usedLightCount"] = glGetUniformLocation(shaderProgram, "usedLightCount");
+	uniformLocations.usedLightCount = shader.getUniformLocation("usedLightCount");
 
 	// get texture uniform location //
-	uniformLocations["tex"] = glGetUniformLocation(shaderProgram,"tex");
+	uniformLocations.tex = shader.getUniformLocation("tex");
 }
 
 bool enableShader() {
 	if (shaderProgram > 0) {
-		glUseProgram(shaderProgram);
+		GLStateCache::useProgram(shaderProgram);
 	} else {
 		std::cout << "(enableShader) - Shader program not initialized." << std::endl;
 	}
@@ -255,14 +269,14 @@ bool enableShader() {
 }
 
 void disableShader() {
-	glUseProgram(0);
+	GLStateCache::useProgram(0);
 }
 
 void deleteShader() {
 	// use standard pipeline //
-	glUseProgram(0);
+	GLStateCache::useProgram(0);
 	// delete shader program //
-	glDeleteProgram(shaderProgram);
+	GLStateCache::deleteProgram(shaderProgram);
 	shaderProgram = 0;
 }
 
@@ -325,7 +339,7 @@ void initTextures (void) {
 	glGenTextures(1, &texture);
 
 	// initialize the texture properly (filtering, wrapping style, etc.)
-	glBindTexture(GL_TEXTURE_2D, texture);
+	GLStateCache::bindTexture(0, GL_TEXTURE_2D, texture);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -339,7 +353,7 @@ void initTextures (void) {
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texturedata.width, texturedata.height, 0, GL_RGB, GL_UNSIGNED_BYTE, texturedata.data);
 
 	// don't forget to clean up
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::bindTexture(0, GL_TEXTURE_2D, 0);
 	delete[] texturedata.data;
 }
 
@@ -410,15 +424,13 @@ void initScene() {
 void renderScene() {
 	glm_ModelViewMatrix.push(glm_ModelViewMatrix.top());
 
-	glUniformMatrix4fv(uniformLocations["modelview"], 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+	glUniformMatrix4fv(uniformLocations.modelview, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
 
 	// upload the properties of the currently active light sources here //
 	int shaderLightIdx = 0;
 	for (unsigned int i = 0; i < lightCount; ++i) {
 		if (lights[i].enabled) {
-			std::stringstream sstr("");
-			sstr << "light_" << shaderLightIdx;
-			UniformLocation_Light &light = uniformLocations_Lights[sstr.str()];
+			UniformLocation_Light &light = uniformLocations_Lights[shaderLightIdx];
 			glUniform3fv(light.position, 1, glm::value_ptr(lights[i].position));
 			glUniform3fv(light.ambient_color, 1, glm::value_ptr(lights[i].ambient_color));
 			glUniform3fv(light.diffuse_color, 1, glm::value_ptr(lights[i].diffuse_color));
@@ -426,22 +438,21 @@ void renderScene() {
 			++shaderLightIdx;
 		}
 	}
-	glUniform1i(uniformLocations["usedLightCount"], shaderLightIdx);
+	glUniform1i(uniformLocations.usedLightCount, shaderLightIdx);
 
 	// upload the chosen material properties here //
-	glUniform3fv(uniformLocations["material.ambient"], 1, glm::value_ptr(materials[materialIndex].ambient_color));
-	glUniform3fv(uniformLocations["material.diffuse"], 1, glm::value_ptr(materials[materialIndex].diffuse_color));
-	glUniform3fv(uniformLocations["material.specular"], 1, glm::value_ptr(materials[materialIndex].specular_color));
-	glUniform1f(uniformLocations["material.shininess"], materials[materialIndex].specular_shininess);
+	glUniform3fv(uniformLocations.material.ambient, 1, glm::value_ptr(materials[materialIndex].ambient_color));
+	glUniform3fv(uniformLocations.material.diffuse, 1, glm::value_ptr(materials[materialIndex].diffuse_color));
+	glUniform3fv(uniformLocations.material.specular, 1, glm::value_ptr(materials[materialIndex].specular_color));
+	glUniform1f(uniformLocations.material.shininess, materials[materialIndex].specular_shininess);
 
 	// upload texture to first texture unit //
 
 	// bind the texture after activating the first texture unit
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, texture);
+	GLStateCache::bindTexture(0, GL_TEXTURE_2D, texture);
 
 	// assign the currently active texture unit to the texture uniform of your shader
-	glUniform1i(uniformLocations["tex"], 0);
+	glUniform1i(uniformLocations.tex, 0);
 
 	// render the actual object //
 	objLoader.getMeshObj("sceneObject")->render();
@@ -459,7 +470,7 @@ void updateGL() {
 	// get projection mat from camera controller //
 	glm_ProjectionMatrix.top() = camera.getProjectionMat();
 	// upload projection matrix //
-	glUniformMatrix4fv(uniformLocations["projection"], 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
+	glUniformMatrix4fv(uniformLocations.projection, 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
 
 	// init scene graph by cloning the top entry, which can now be manipulated //
 	// get modelview mat from camera controller //
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -17,6 +18,7 @@ class ObjLoader {
   private:
     std::map<std::string, MeshObj*> mMeshMap;
     
+    void computeMissingNormals(MeshData &meshData, const std::vector<int> &positionIds, size_t positionCount);
     void computeTangentSpace(MeshData &meshData);
 };
 
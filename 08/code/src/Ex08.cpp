@@ -16,6 +16,8 @@
 
 #include "ObjLoader.h"
 #include "CameraController.h"
+#include "ShaderProgram.h"
+#include "GLStateCache.h"
 
 #include <sstream>
 #include <opencv/cv.h>
@@ -34,18 +36,32 @@ char* loadShaderSource(const char* fileName);
 GLuint loadShaderFile(const char* fileName, GLenum shaderType);
 // the used shader program //
 GLuint shaderProgram = 0;
-// this map stores uniform locations of our shader program //
-std::map<std::string, GLint> uniformLocations;
+// active uniforms of the program, resolved once after linking //
+ShaderProgram shader;
 
-// this struct helps to keep light source parameter uniforms together //
+// these structs help to keep light source and material parameter uniforms together //
 struct UniformLocation_Light {
   GLint ambient_color;
   GLint diffuse_color;
   GLint specular_color;
   GLint position;
 };
-// this map stores the light source uniform locations as 'UniformLocation_Light' structs //
-std::map<std::string, UniformLocation_Light> uniformLocations_Lights;
+struct UniformLocation_Material {
+  GLint ambient;
+  GLint diffuse;
+  GLint specular;
+  GLint shininess;
+};
+// this struct stores uniform locations of our shader program -> no lookups while rendering //
+struct UniformLocations {
+  GLint projection;
+  GLint modelview;
+  UniformLocation_Material material;
+  GLint usedLightCount;
+};
+UniformLocations uniformLocations;
+// light source uniform locations, one 'UniformLocation_Light' struct per light of the shader //
+UniformLocation_Light uniformLocations_Lights[10];
 
 // these structs are also used in the shader code  //
 // this helps to access the parameters more easily //
@@ -203,7 +219,7 @@ int main (int argc, char **argv) {
 
 void initGL() {
   glClearColor(0.0, 0.0, 0.0, 0.0);
-  glEnable(GL_DEPTH_TEST);
+  GLStateCache::enable(GL_DEPTH_TEST);
 }
 
 std::string getUniformStructLocStr(const std::string &structName, const std::string &memberName, int arrayIndex = -1) {
@@ -272,48 +288,47 @@ void initShader() {
   glBindFragDataLocation(shaderProgram, 0, "color");
   
   // get uniform locations for common variables //
-  uniformLocations["projection"] = glGetUniformLocation(shaderProgram, "projection");
-  uniformLocations["modelview"] = glGetUniformLocation(shaderProgram, "modelview");
+  shader.setProgram(shaderProgram);
+  uniformLocations.projection = shader.getUniformLocation("projection");
+  uniformLocations.modelview = shader.getUniformLocation("modelview");
   
   // material unform locations //
-  uniformLocations["material.ambient"] = glGetUniformLocation(shaderProgram, "material.ambient_color");
-  uniformLocations["material.diffuse"] = glGetUniformLocation(shaderProgram, "material.diffuse_color");
-  uniformLocations["material.specular"] = glGetUniformLocation(shaderProgram, "material.specular_color");
-  uniformLocations["material.shininess"] = glGetUniformLocation(shaderProgram, "material.specular_shininess");
+  uniformLocations.material.ambient = shader.getUniformLocation("material.ambient_color");
+  uniformLocations.material.diffuse = shader.getUniformLocation("material.diffuse_color");
+  uniformLocations.material.specular = shader.getUniformLocation("material.specular_color");
+  uniformLocations.material.shininess = shader.getUniformLocation("material.specular_shininess");
   
   // store the uniform locations for all light source properties
   for (int i = 0; i < 10; ++i) {
     UniformLocation_Light lightLocation;
-    lightLocation.ambient_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "ambient_color", i).c_str());
-    lightLocation.diffuse_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "diffuse_color", i).c_str());
-    lightLocation.specular_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "specular_color", i).c_str());
-    lightLocation.position = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "position", i).c_str());
+    lightLocation.ambient_color = shader.getUniformLocation(getUniformStructLocStr("lightSource", "ambient_color", i).c_str());
+    lightLocation.diffuse_color = shader.getUniformLocation(getUniformStructLocStr("lightSource", "diffuse_color", i).c_str());
+    lightLocation.specular_color = shader.getUniformLocation(getUniformStructLocStr("lightSource", "specular_color", i).c_str());
+    lightLocation.position = shader.getUniformLocation(getUniformStructLocStr("lightSource", "position", i).c_str());
     
-    std::stringstream sstr("");
-    sstr << "light_" << i;
-    uniformLocations_Lights[sstr.str()] = lightLocation;
+    uniformLocations_Lights[i] = lightLocation;
   }
-  uniformLocations["usedLightCount"] = glGetUniformLocation(shaderProgram, "usedLightCount");
+  uniformLocations.usedLightCount = shader.getUniformLocation("usedLightCount");
   
   // TODO: get texture uniform locations and store them in the texture containers //
   if (task == 0) {
     // TODO?: Task 8.1
     // TODO?: get the texture uniform locations of the textures defined in 'multi_texture.frag' //
-	texture[DIFFUSE].uniformLocation = glGetUniformLocation(shaderProgram, "diffuse_tex");
-	texture[EMISSIVE].uniformLocation = glGetUniformLocation(shaderProgram, "emissive_tex");
-	texture[SKY_ALPHA].uniformLocation = glGetUniformLocation(shaderProgram, "sky_alpha");
-	texture[SKY_COLOR].uniformLocation = glGetUniformLocation(shaderProgram, "sky_tex");
+	texture[DIFFUSE].uniformLocation = shader.getUniformLocation("diffuse_tex");
+	texture[EMISSIVE].uniformLocation = shader.getUniformLocation("emissive_tex");
+	texture[SKY_ALPHA].uniformLocation = shader.getUniformLocation("sky_alpha");
+	texture[SKY_COLOR].uniformLocation = shader.getUniformLocation("sky_tex");
   } else {
     // TODO: Task 8.2
     // TODO: get the texture uniform locations of the textures defined in 'normal_mapping.frag' //
-    texture[DIFFUSE].uniformEnabledLocation = glGetUniformLocation(shaderProgram, "diffuse_tex");
-    texture[NORMAL].uniformLocation = glGetUniformLocation(shaderProgram, "normal_tex");
+    texture[DIFFUSE].uniformEnabledLocation = shader.getUniformLocation("diffuse_tex");
+    texture[NORMAL].uniformLocation = shader.getUniformLocation("normal_tex");
   }
 }
 
 bool enableShader() {
   if (shaderProgram > 0) {
-    glUseProgram(shaderProgram);
+    GLStateCache::useProgram(shaderProgram);
   } else {
     std::cout << "(enableShader) - Shader program not initialized." << std::endl;
   }
@@ -321,14 +336,14 @@ bool enableShader() {
 }
 
 void disableShader() {
-  glUseProgram(0);
+  GLStateCache::useProgram(0);
 }
 
 void deleteShader() {
   // use standard pipeline //
-  glUseProgram(0);
+  GLStateCache::useProgram(0);
   // delete shader program //
-  glDeleteProgram(shaderProgram);
+  GLStateCache::deleteProgram(shaderProgram);
   shaderProgram = 0;
 }
 
@@ -422,7 +437,7 @@ void initTextures (void) {
       // texture has been successfully loaded //
       glGenTextures(1, &texture[layer].glTextureLocation);
       
-      glBindTexture(GL_TEXTURE_2D, texture[layer].glTextureLocation);
+      GLStateCache::bindTexture(0, GL_TEXTURE_2D, texture[layer].glTextureLocation);
       glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
       glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -494,9 +509,7 @@ void setupLightAndMaterial() {
   int shaderLightIdx = 0;
   for (unsigned int i = 0; i < lightCount; ++i) {
     if (lights[i].enabled) {
-      std::stringstream sstr("");
-      sstr << "light_" << shaderLightIdx;
-      UniformLocation_Light &light = uniformLocations_Lights[sstr.str()];
+      UniformLocation_Light &light = uniformLocations_Lights[shaderLightIdx];
       glUniform3fv(light.position, 1, glm::value_ptr(lights[i].position));
       glUniform3fv(light.ambient_color, 1, glm::value_ptr(lights[i].ambient_color));
       glUniform3fv(light.diffuse_color, 1, glm::value_ptr(lights[i].diffuse_color));
@@ -504,13 +517,13 @@ void setupLightAndMaterial() {
       ++shaderLightIdx;
     }
   }
-  glUniform1i(uniformLocations["usedLightCount"], shaderLightIdx);
+  glUniform1i(uniformLocations.usedLightCount, shaderLightIdx);
   
   // uploads the chosen material properties here //
-  glUniform3fv(uniformLocations["material.ambient"], 1, glm::value_ptr(materials[materialIndex].ambient_color));
-  glUniform3fv(uniformLocations["material.diffuse"], 1, glm::value_ptr(materials[materialIndex].diffuse_color));
-  glUniform3fv(uniformLocations["material.specular"], 1, glm::value_ptr(materials[materialIndex].specular_color));
-  glUniform1f(uniformLocations["material.shininess"], materials[materialIndex].specular_shininess);
+  glUniform3fv(uniformLocations.material.ambient, 1, glm::value_ptr(materials[materialIndex].ambient_color));
+  glUniform3fv(uniformLocations.material.diffuse, 1, glm::value_ptr(materials[materialIndex].diffuse_color));
+  glUniform3fv(uniformLocations.material.specular, 1, glm::value_ptr(materials[materialIndex].specular_color));
+  glUniform1f(uniformLocations.material.shininess, materials[materialIndex].specular_shininess);
 }
 
 // TODO: complete the code to render a multitextured earth //
@@ -520,17 +533,13 @@ void renderEarth() {
   
   glm_ModelViewMatrix.top() *= glm::scale(glm::vec3(10));
   
-  glUniformMatrix4fv(uniformLocations["modelview"], 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+  glUniformMatrix4fv(uniformLocations.modelview, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
   
   // TODO: upload textures to individual texture units //
- glActiveTexture(GL_TEXTURE0);
- glBindTexture(GL_TEXTURE_2D, texture[DIFFUSE].glTextureLocation); 
- glActiveTexture(GL_TEXTURE1); 
- glBindTexture(GL_TEXTURE_2D, texture[EMISSIVE].glTextureLocation); 
- glActiveTexture(GL_TEXTURE2); 
- glBindTexture(GL_TEXTURE_2D, texture[SKY_ALPHA].glTextureLocation); 
- glActiveTexture(GL_TEXTURE3); 
- glBindTexture(GL_TEXTURE_2D, texture[SKY_COLOR].glTextureLocation);
+ GLStateCache::bindTexture(0, GL_TEXTURE_2D, texture[DIFFUSE].glTextureLocation); 
+ GLStateCache::bindTexture(1, GL_TEXTURE_2D, texture[EMISSIVE].glTextureLocation); 
+ GLStateCache::bindTexture(2, GL_TEXTURE_2D, texture[SKY_ALPHA].glTextureLocation); 
+ GLStateCache::bindTexture(3, GL_TEXTURE_2D, texture[SKY_COLOR].glTextureLocation);
  
  //assign the currently active texture units to the texture uniforms of our shader
  glUniform1i(texture[DIFFUSE].uniformLocation, 0); 
@@ -553,13 +562,11 @@ void renderMoon() {
   
   glm_ModelViewMatrix.top() *= glm::scale(glm::vec3(10));
   
-  glUniformMatrix4fv(uniformLocations["modelview"], 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+  glUniformMatrix4fv(uniformLocations.modelview, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
   
   // TODO: upload textures to individual texture units //
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, texture[DIFFUSE].glTextureLocation);
-  glActiveTexture(GL_TEXTURE1);
-  glBindTexture(GL_TEXTURE_2D, texture[NORMAL].glTextureLocation);
+  GLStateCache::bindTexture(0, GL_TEXTURE_2D, texture[DIFFUSE].glTextureLocation);
+  GLStateCache::bindTexture(1, GL_TEXTURE_2D, texture[NORMAL].glTextureLocation);
 
   glUniform1i(texture[DIFFUSE].uniformLocation, 0);
   glUniform1i(texture[NORMAL].uniformLocation, 1);
@@ -581,7 +588,7 @@ void updateGL() {
   // get projection mat from camera controller //
   glm_ProjectionMatrix.top() = camera.getProjectionMat();
   // upload projection matrix //
-  glUniformMatrix4fv(uniformLocations["projection"], 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
+  glUniformMatrix4fv(uniformLocations.projection, 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
   
   // init scene graph by cloning the top entry, which can now be manipulated //
   // get modelview mat from camera controller //
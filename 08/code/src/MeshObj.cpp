@@ -22,7 +22,7 @@ MeshObj::~MeshObj() {
   // #INFO# VBO locations for tangent and binormal already declared //
   glDeleteBuffers(1, &mVBO_tangent);
   glDeleteBuffers(1, &mVBO_binormal);
-  glDeleteVertexArrays(1, &mVAO);
+  GLStateCache::deleteVertexArrays(1, &mVAO);
 }
 
 void MeshObj::setData(const MeshData &meshData) {
@@ -68,7 +68,7 @@ void MeshObj::setData(const MeshData &meshData) {
   if (mVAO == 0) {
     glGenVertexArrays(1, &mVAO);
   }
-  glBindVertexArray(mVAO);
+  GLStateCache::bindVertexArray(mVAO);
   
   // create and bind VBOs and upload data (one VBO per available vertex attribute -> position, normal) //
   if (mVBO_position == 0) {
@@ -127,7 +127,7 @@ void MeshObj::setData(const MeshData &meshData) {
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndexCount * sizeof(GLuint), &indices[0], GL_STATIC_DRAW);
   
   // unbind buffers //
-  glBindVertexArray(0);
+  GLStateCache::bindVertexArray(0);
   
   // make sure to clean up temporarily allocated data, if neccessary //
   delete[] vertex_position;
@@ -149,8 +149,7 @@ void MeshObj::setData(const MeshData &meshData) {
 void MeshObj::render(void) {
   // render your VAO //
   if (mVAO != 0) {
-    glBindVertexArray(mVAO);
+    GLStateCache::bindVertexArray(mVAO);
     glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, (void*)0);
-    glBindVertexArray(0);
   }
 }
@@ -153,6 +153,9 @@ MeshObj* ObjLoader::loadObjFile(std::string fileName, std::string ID) {
     // creates an indexed vertex for every triplet of vertexId, normalId and texCoordId //
     MeshData meshData;
     std::map<std::string, unsigned int> vertexIdMap;
+    // position of every new vertex -> needed to fill in missing normals //
+    std::vector<int> vertexPositionIds;
+    bool normalsMissing = false;
     for (std::vector<std::vector<glm::vec3> >::iterator faceIter = localFace.begin(); faceIter != localFace.end(); ++faceIter) {
       std::string vertexId("");
       const char* idPattern = "%08d|%08d|%08d";
@@ -174,13 +177,22 @@ MeshObj* ObjLoader::loadObjFile(std::string fileName, std::string ID) {
           meshData.vertex_position.push_back(position.x);
 	  meshData.vertex_position.push_back(position.y);
 	  meshData.vertex_position.push_back(position.z);
-          // add vertex normal data //
-          glm::vec3 normal = localVertexNormal[ni];
+          vertexPositionIds.push_back(vi);
+          // add vertex normal data, a missing normal is computed below //
+          glm::vec3 normal(0);
+          if (ni >= 0 && ni < (int)localVertexNormal.size()) {
+            normal = localVertexNormal[ni];
+          } else {
+            normalsMissing = true;
+          }
           meshData.vertex_normal.push_back(normal.x);
 	  meshData.vertex_normal.push_back(normal.y);
 	  meshData.vertex_normal.push_back(normal.z);
 	  // add vertex texture coord data //
-	  glm::vec2 texcoord = localVertexTexcoord[ti];
+	  glm::vec2 texcoord(0);
+	  if (ti >= 0 && ti < (int)localVertexTexcoord.size()) {
+	    texcoord = localVertexTexcoord[ti];
+	  }
           meshData.vertex_texcoord.push_back(texcoord.x);
 	  meshData.vertex_texcoord.push_back(texcoord.y);
 	  // insert new index into index list AND index map //
@@ -193,6 +205,10 @@ MeshObj* ObjLoader::loadObjFile(std::string fileName, std::string ID) {
       }
     }
     
+    if (normalsMissing) {
+      computeMissingNormals(meshData, vertexPositionIds, localVertexPosition.size());
+    }
+    
     // #INFO# compute tangent space //
     computeTangentSpace(meshData);
     
@@ -225,119 +241,110 @@ MeshObj* ObjLoader::getMeshObj(std::string ID) {
   return NULL;
 }
 
-// TODO: compute the tangent space here, by computing a tangent an binormal for every vertex //
-void ObjLoader::computeTangentSpace(MeshData &meshData) {
-  // TODO: reserve memory for tangents and binormals -> same count as vertices //
-    std::vector<glm::vec3> tangents;
-    for(int i=0; i<meshData.indices.size(); i++)
-        tangents.push_back(glm::vec3(0,0,0));
-
-    std::vector<glm::vec3> binormals;
-    for(int i=0; i<meshData.indices.size(); i++)
-        binormals.push_back(glm::vec3(0,0,0));
-
-    std::cout << "meshData.indices.size(): " << meshData.indices.size() << std::endl;
-
-    for (int vertexnr = 0; vertexnr < meshData.indices.size(); vertexnr+=3) {
-        int index = meshData.indices[vertexnr];
-        glm::vec3 v0(meshData.vertex_position[index*3],
-                meshData.vertex_position[index*3+1],
-                meshData.vertex_position[index*3+2]);
-        glm::vec2 t0(meshData.vertex_texcoord[index*2],
-                meshData.vertex_texcoord[index*2+1]);
-
-        index = meshData.indices[vertexnr+1];
-        glm::vec3 v1(meshData.vertex_position[index*3],
-                meshData.vertex_position[index*3+1],
-                meshData.vertex_position[index*3+2]);
-        glm::vec2 t1(meshData.vertex_texcoord[index*2],
-                meshData.vertex_texcoord[index*2+1]);
-
-        index = meshData.indices[vertexnr+2];
-        glm::vec3 v2(meshData.vertex_position[index*3],
-                meshData.vertex_position[index*3+1],
-                meshData.vertex_position[index*3+2]);
-        glm::vec2 t2(meshData.vertex_texcoord[index*2],
-                meshData.vertex_texcoord[index*2+1]);
-
-        glm::vec3 e1 = v1 - v0;
-        glm::vec3 e2 = v2 - v0;
-
-        float du1 = t1[0] - t0[0];
-        float du2 = t2[0] - t0[0];
-        float dv1 = t1[1] - t0[1];
-        float dv2 = t2[1] - t0[1];
-
-        glm::mat2x2 firstmat(du1, dv1, du2, dv2);
-        glm::mat2x3 secondmat(e1, e2);
-        glm::mat2x3 result = secondmat*glm::inverse(firstmat);
-        glm::vec3 t = result[0];
-
-        tangents[vertexnr] += t;
-        tangents[vertexnr+1] += t;
-        tangents[vertexnr+2] += t;
-
-        //Debug output for first vertex
-        if(vertexnr == 0)
-        {
-            std::cout << "v0: " << v0.x << " " << v0.y << " " << v0.z << std::endl;
-            std::cout << "v1: " << v1.x << " " << v1.y << " " << v1.z << std::endl;
-            std::cout << "v2: " << v2.x << " " << v2.y << " " << v2.z << std::endl;
-
-            std::cout << "t0: " << t0.x << " " << t0.y <<  std::endl;
-            std::cout << "t1: " << t1.x << " " << t1.y <<  std::endl;
-            std::cout << "t2: " << t0.x << " " << t0.y <<  std::endl;
-            
-            std::cout << "e1: " << e1.x << " " << e1.y << " " << e1.z << std::endl;
-            std::cout << "e2: " << e2.x << " " << e2.y << " " << e2.z << std::endl;
-
-            std::cout << "du1: " << du1 << std::endl;
-            std::cout << "du2: " << du2 << std::endl;
-            std::cout << "dv1: " << dv1 << std::endl;
-            std::cout << "dv2: " << dv2 << std::endl;
-
-            std::cout << "firstmat: " << std::endl << firstmat[0][0] << " " << firstmat[0][1] << std::endl << firstmat[1][0] << " " << firstmat[1][1] << std::endl;
-            std::cout << "glm::inverse(firstmat): " << std::endl << glm::inverse(firstmat)[0][0] << " " << glm::inverse(firstmat)[0][1] << std::endl << glm::inverse(firstmat)[1][0] << " " << glm::inverse(firstmat)[1][1] << std::endl;
-            std::cout << "secondmat: " << std::endl << secondmat[0][0] << " " << secondmat[0][1] << " " << secondmat[0][2] << std::endl << secondmat[1][0] << " " << secondmat[1][1] << " " << secondmat[1][2] << std::endl;
-            
-            std::cout << "result: " << std::endl << result[0][0] << " " << result[0][1] << " " << result[0][2] << std::endl << result[1][0] << " " << result[1][1] << " " << result[1][2] << std::endl;
-
-            std::cout << "t: " << t.x << " " << t.y << " " << t.z << std::endl;
-            std::cout << std::flush;
-        }
+// vertices imported without a normal (no 'vn' records) get the smooth normal of their position //
+// the area weighted face normals are summed per position -> copies of a position (texture seams) stay smooth
+void ObjLoader::computeMissingNormals(MeshData &meshData, const std::vector<int> &positionIds, size_t positionCount) {
+  std::vector<glm::vec3> normalSums(positionCount, glm::vec3(0));
+  for (size_t i = 0; i + 2 < meshData.indices.size(); i += 3) {
+    glm::vec3 v[3];
+    for (int j = 0; j < 3; ++j) {
+      GLuint index = meshData.indices[i + j];
+      v[j] = glm::vec3(meshData.vertex_position[3 * index],
+		       meshData.vertex_position[3 * index + 1],
+		       meshData.vertex_position[3 * index + 2]);
     }
-
-    for (int vertexnr = 0; vertexnr < meshData.indices.size(); vertexnr++) {
-        tangents[vertexnr] = glm::normalize(tangents[vertexnr]);
+    // the length of the cross product is twice the area of the triangle //
+    glm::vec3 faceNormal = glm::cross(v[1] - v[0], v[2] - v[0]);
+    for (int j = 0; j < 3; ++j) {
+      normalSums[positionIds[meshData.indices[i + j]]] += faceNormal;
     }
+  }
+  // given normals are kept //
+  for (size_t vertex = 0; vertex < positionIds.size(); ++vertex) {
+    GLfloat *normal = &meshData.vertex_normal[3 * vertex];
+    if (normal[0] != 0 || normal[1] != 0 || normal[2] != 0) {
+      continue;
+    }
+    glm::vec3 sum = normalSums[positionIds[vertex]];
+    GLfloat length = glm::length(sum);
+    if (length > 0) {
+      for (int j = 0; j < 3; ++j) {
+        normal[j] = sum[j] / length;
+      }
+    }
+  }
+}
+
+// computes a tangent and binormal for every vertex //
+// the tangents of the incident triangles are summed per vertex, then made orthogonal to the normal
+void ObjLoader::computeTangentSpace(MeshData &meshData) {
+  // one tangent and binormal per vertex //
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  meshData.vertex_tangent.assign(3 * vertexCount, 0);
+  meshData.vertex_binormal.assign(3 * vertexCount, 0);
+  if (meshData.vertex_normal.size() != 3 * vertexCount || meshData.vertex_texcoord.size() != 2 * vertexCount) {
+    return;
+  }
   
-  // TODO: iterator over faces (given by index triplets) and calculate tangents for each incident vertex //
-  // - this will accumulate tangents for vertices shared by different faces
-  // - do not compute the binormal just yet, this will be done, when the final value of the vertex tangent has been computed (see below)
+  // iterate over faces (given by index triplets) and add their tangent to each incident vertex //
+  for (size_t i = 0; i + 2 < meshData.indices.size(); i += 3) {
+    glm::vec3 v[3];
+    glm::vec2 t[3];
+    GLuint index[3];
+    for (int j = 0; j < 3; ++j) {
+      index[j] = meshData.indices[i + j];
+      v[j] = glm::vec3(meshData.vertex_position[3 * index[j]],
+		       meshData.vertex_position[3 * index[j] + 1],
+		       meshData.vertex_position[3 * index[j] + 2]);
+      t[j] = glm::vec2(meshData.vertex_texcoord[2 * index[j]],
+		       meshData.vertex_texcoord[2 * index[j] + 1]);
+    }
+    
+    // triangle edges Q1, Q2 and their texture coordinate differences //
+    glm::vec3 Q1 = v[1] - v[0];
+    glm::vec3 Q2 = v[2] - v[0];
+    GLfloat du1 = t[1].x - t[0].x;
+    GLfloat dv1 = t[1].y - t[0].y;
+    GLfloat du2 = t[2].x - t[0].x;
+    GLfloat dv2 = t[2].y - t[0].y;
+    
+    // degenerate texture coordinates -> the triangle has no tangent //
+    GLfloat det = du1 * dv2 - dv1 * du2;
+    if (det == 0) {
+      continue;
+    }
+    // only the tangent is needed, the binormal is computed from it and the normal //
+    glm::vec3 tangent = (Q1 * dv2 - Q2 * dv1) / det;
+    for (int j = 0; j < 3; ++j) {
+      for (int k = 0; k < 3; ++k) {
+        meshData.vertex_tangent[3 * index[j] + k] += tangent[k];
+      }
+    }
+  }
   
-  // TODO: iterate over previously computed vertex tangents //
-  // - use gram-schmidt approach to reorthogonalize tangent to normal
-  // - compute the still missing binormal
-
-    for(int i=0; i<meshData.vertex_normal.size(); i++) {
-        meshData.vertex_tangent.push_back(0);
-        meshData.vertex_binormal.push_back(0);
+  // use gram-schmidt approach to reorthogonalize tangent to normal //
+  for (size_t i = 0; i < vertexCount; ++i) {
+    glm::vec3 tangent(meshData.vertex_tangent[3 * i],
+		      meshData.vertex_tangent[3 * i + 1],
+		      meshData.vertex_tangent[3 * i + 2]);
+    glm::vec3 normal(meshData.vertex_normal[3 * i],
+		     meshData.vertex_normal[3 * i + 1],
+		     meshData.vertex_normal[3 * i + 2]);
+    tangent = tangent - glm::dot(normal, tangent) * normal;
+    if (glm::length(tangent) == 0) {
+      // no triangle with texture area -> any direction perpendicular to the normal //
+      glm::vec3 axis = (std::fabs(normal.x) < 0.9f) ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+      tangent = axis - glm::dot(normal, axis) * normal;
     }
-
-    for (int vertexnr = 0; vertexnr < meshData.indices.size(); vertexnr++) {
-        int index = meshData.indices[vertexnr];
-        glm::vec3 normal(meshData.vertex_normal[index*3],
-                meshData.vertex_normal[index*3+1],
-                meshData.vertex_normal[index*3+2]);
-        tangents[vertexnr] = tangents[vertexnr] - glm::dot(normal,tangents[vertexnr])*normal;
-        binormals[vertexnr] = glm::cross(tangents[vertexnr],normal); 
-
-        meshData.vertex_tangent[index*3] = tangents[vertexnr][0];
-        meshData.vertex_tangent[index*3+1] = tangents[vertexnr][1];
-        meshData.vertex_tangent[index*3+2] = tangents[vertexnr][2];
-        meshData.vertex_binormal[index*3] = binormals[vertexnr][0];
-        meshData.vertex_binormal[index*3+1] = binormals[vertexnr][1];
-        meshData.vertex_binormal[index*3+2] = binormals[vertexnr][2];
+    tangent = glm::normalize(tangent);
+    
+    // cross product of tangent and normal yields binormal //
+    glm::vec3 binormal = glm::normalize(glm::cross(tangent, normal));
+    
+    // set values back into meshData //
+    for (int k = 0; k < 3; ++k) {
+      meshData.vertex_tangent[3 * i + k] = tangent[k];
+      meshData.vertex_binormal[3 * i + k] = binormal[k];
     }
-    std::cout <<  meshData.vertex_normal.size()<< " " << meshData.vertex_tangent.size() << std::flush;
+  }
 }
@@ -0,0 +1,51 @@
+#ifndef __BYTE_SWAP__
+#define __BYTE_SWAP__
+
+#include <cstddef>
+#include <cstring>
+#include <stdint.h>
+
+// byte order conversion of binary mesh files (see PlyImporter, StlImporter) //
+// the bulk functions are plain shift loops over whole arrays -> the compiler turns them into vector
+// byte shuffles, no per value function calls or branches
+
+inline bool isLittleEndianHost(void) {
+  const uint16_t probe = 1;
+  unsigned char firstByte;
+  std::memcpy(&firstByte, &probe, 1);
+  return firstByte == 1;
+}
+
+inline void swapBytes16(uint16_t *values, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = (uint16_t)((values[i] >> 8) | (values[i] << 8));
+  }
+}
+
+inline void swapBytes32(uint32_t *values, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t value = values[i];
+    values[i] = (value >> 24) | ((value >> 8) & 0xFF00u) | ((value << 8) & 0xFF0000u) | (value << 24);
+  }
+}
+
+inline void swapBytes64(uint64_t *values, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const uint64_t value = values[i];
+    const uint64_t halves = (value >> 32) | (value << 32);
+    const uint64_t words = ((halves >> 16) & 0x0000FFFF0000FFFFull) | ((halves & 0x0000FFFF0000FFFFull) << 16);
+    values[i] = ((words >> 8) & 0x00FF00FF00FF00FFull) | ((words & 0x00FF00FF00FF00FFull) << 8);
+  }
+}
+
+// swaps every value of 'size' (1, 2, 4 or 8) bytes in 'data', which has to be aligned to 'size' //
+inline void swapBytes(void *data, size_t size, size_t count) {
+  switch (size) {
+    case 2: swapBytes16(static_cast<uint16_t*>(data), count); break;
+    case 4: swapBytes32(static_cast<uint32_t*>(data), count); break;
+    case 8: swapBytes64(static_cast<uint64_t*>(data), count); break;
+    default: break;
+  }
+}
+
+#endif
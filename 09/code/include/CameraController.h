@@ -40,6 +40,8 @@ class CameraController {
     glm::mat4 getProjectionMat(void);
     glm::mat4 getModelViewMat(void);
     glm::vec3 getCameraPosition(void);
+    // size in pixels of one unit at 'distance' from the camera, for a viewport 'viewportHeight' pixels high //
+    float getPixelsPerUnit(float distance, float viewportHeight);
     
   private:
     glm::vec3 mCameraPosition;
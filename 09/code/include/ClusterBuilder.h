@@ -0,0 +1,51 @@
+#ifndef __CLUSTER_BUILDER__
+#define __CLUSTER_BUILDER__
+
+#include <vector>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include "MeshObj.h"
+
+// #INFO# splits the full mesh into small clusters of connected triangles (meshlets) //
+// the triangles of each group are reordered so every cluster is a contiguous range of the index list,
+// the groups keep their ranges. clusters grow over the triangles sharing most vertices with them, which
+// keeps them compact and their normals similar -> tight bounding spheres and normal cones for culling
+// (see ClusterCuller). the work arrays are kept between calls.
+class ClusterBuilder {
+  public:
+    static const unsigned int MAX_CLUSTER_VERTICES = 64;
+    static const unsigned int MAX_CLUSTER_TRIANGLES = 124;
+
+    ClusterBuilder();
+
+    // fills meshData.clusters, the full mesh (see MeshData::lods) is reordered cluster by cluster //
+    void build(MeshData &meshData);
+    void setLimits(unsigned int maxVertices, unsigned int maxTriangles);
+
+    // bounding sphere and normal cone of 'indexCount' indices //
+    static void computeBounds(const MeshData &meshData, const GLuint *indices, size_t indexCount, MeshCluster &cluster);
+
+  private:
+    // splits the range into clusters, appends them and the reordered indices //
+    void buildRange(const MeshData &meshData, const GLuint *indices, size_t indexCount, GLuint firstIndex,
+                    std::vector<GLuint> &orderedIndices, std::vector<MeshCluster> &clusters);
+    glm::vec3 getPosition(GLuint vertex) const;
+
+    unsigned int mMaxVertices;
+    unsigned int mMaxTriangles;
+    const std::vector<GLfloat> *mPositions;
+
+    // triangles per vertex of the full mesh //
+    std::vector<unsigned int> mAdjacencyOffset;
+    std::vector<unsigned int> mAdjacency;
+    std::vector<unsigned int> mFillCount;
+    std::vector<unsigned char> mTriangleUsed;
+    // cluster a vertex was last added to, + 1 //
+    std::vector<unsigned int> mVertexCluster;
+    std::vector<GLuint> mClusterVertices;
+    std::vector<unsigned int> mClusterTriangles;
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef __CLUSTER_CULLER__
+#define __CLUSTER_CULLER__
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "MeshObj.h"
+
+// #INFO# per frame culling of the clusters of a MeshObj on the CPU (see ClusterBuilder) //
+// clusters outside the view frustum (bounding sphere) or facing away from the camera (normal cone)
+// are dropped, the surviving ones are drawn with MeshObj::renderClusters(). everything is tested in
+// object space -> no cluster data is transformed. the result array is kept between calls.
+class ClusterCuller {
+  public:
+    ClusterCuller();
+
+    // culls all clusters of 'meshObj' for the given matrices, returns the number of visible clusters //
+    GLuint cull(const MeshObj &meshObj, const glm::mat4 &modelview, const glm::mat4 &projection);
+
+    // visible clusters of the last cull() in ascending order //
+    const std::vector<GLuint>& getVisibleClusters(void) const { return mVisibleClusters; }
+    GLuint getVisibleClusterCount(void) const { return mVisibleClusters.size(); }
+    // clusters dropped by the last cull() //
+    GLuint getFrustumCulledCount(void) const { return mFrustumCulled; }
+    GLuint getBackfaceCulledCount(void) const { return mBackfaceCulled; }
+
+  private:
+    // frustum planes in object space, normalized -> dot(plane.xyz, p) + plane.w is the distance of 'p' //
+    glm::vec4 mPlanes[6];
+    std::vector<GLuint> mVisibleClusters;
+    GLuint mFrustumCulled;
+    GLuint mBackfaceCulled;
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef __INSTANCE_BUFFER__
+#define __INSTANCE_BUFFER__
+
+#include <GL/glew.h>
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// #INFO# per instance model matrices for MeshObj::renderInstanced(), rewritten every frame //
+// the buffer keeps its size and is orphaned before each update -> the driver hands out fresh memory
+// instead of waiting for draws still reading the previous frame's matrices. it only grows.
+class InstanceBuffer {
+  public:
+    InstanceBuffer();
+    ~InstanceBuffer();
+
+    // replaces the content with 'count' model matrices //
+    void update(const glm::mat4 *models, GLuint count);
+    void update(const std::vector<glm::mat4> &models) { update(models.empty() ? NULL : &models[0], models.size()); }
+
+    GLuint getBuffer(void) const { return mBuffer; }
+    GLuint getInstanceCount(void) const { return mInstanceCount; }
+
+  private:
+    // not copyable -> the buffer is owned by exactly one object //
+    InstanceBuffer(const InstanceBuffer &);
+    InstanceBuffer& operator=(const InstanceBuffer &);
+
+    GLuint mBuffer;
+    // matrices the buffer has room for //
+    GLuint mCapacity;
+    GLuint mInstanceCount;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef __MAPPED_FILE__
+#define __MAPPED_FILE__
+
+#include <string>
+#include <cstddef>
+
+// read-only view of a file mapped into memory //
+// the file content is accessed in place, no copy is made
+class MappedFile {
+  public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const std::string &fileName);
+    void close(void);
+
+    bool isOpen(void) const { return mIsOpen; }
+    const char* data(void) const { return mData; }
+    size_t size(void) const { return mSize; }
+
+  private:
+    // not copyable -> the mapping is owned by exactly one object //
+    MappedFile(const MappedFile &);
+    MappedFile& operator=(const MappedFile &);
+
+    const char *mData;
+    size_t mSize;
+    bool mIsOpen;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef __MESH_CACHE__
+#define __MESH_CACHE__
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "MeshObj.h"
+#include "MappedFile.h"
+
+// #INFO# binary sidecar file holding an imported mesh ready for upload //
+// layout: MeshCacheHeader | interleaved vertices (MESH_CACHE_VERTEX_FLOATS each) | indices (GLuint) |
+//         groups (MeshCacheGroup) | levels of detail (MeshCacheLod) | clusters (MeshCacheCluster) | strings ('\0' terminated, the material libraries first)
+// the vertex layout is position(3), normal(3), texcoord(2), tangent(3), binormal(3), attributes
+// missing in the source are zero and not set in 'attributeMask'
+static const uint32_t MESH_CACHE_VERSION = 5;
+static const uint32_t MESH_CACHE_VERTEX_FLOATS = 14;
+
+struct MeshCacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t attributeMask;
+  // the source file this cache has been created from //
+  uint64_t sourceSize;
+  int64_t sourceMtime;
+  uint64_t sourcePathHash;
+  // the import settings it has been created with (see ObjLoader::getImportSettingsHash()) //
+  uint64_t settingsHash;
+  // geometry //
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  float boundsMin[3];
+  float boundsMax[3];
+  // parts and their materials //
+  uint32_t groupCount;
+  uint32_t materialLibraryCount;
+  uint64_t stringDataSize;
+  // levels of detail, 0 -> all indices are the full mesh //
+  uint32_t lodCount;
+  // clusters of the full mesh, 0 -> not split //
+  uint32_t clusterCount;
+};
+
+// a MeshGroup, its names are offsets into the string data //
+struct MeshCacheGroup {
+  uint32_t firstIndex;
+  uint32_t indexCount;
+  float boundsMin[3];
+  float boundsMax[3];
+  uint32_t nameOffset;
+  uint32_t materialOffset;
+};
+
+struct MeshCacheLod {
+  uint32_t firstIndex;
+  uint32_t indexCount;
+  float error;
+};
+
+struct MeshCacheCluster {
+  uint32_t firstIndex;
+  uint32_t indexCount;
+  float center[3];
+  float radius;
+  float coneApex[3];
+  float coneAxis[3];
+  float coneCutoff;
+};
+
+class MeshCache {
+  public:
+    MeshCache();
+    ~MeshCache();
+
+    // name of the sidecar file for 'sourceFile' //
+    static std::string getCacheFileName(const std::string &sourceFile);
+    // writes the cache for a mesh imported with the settings identified by 'settingsHash' //
+    static bool write(const std::string &sourceFile, const MeshData &meshData, uint64_t settingsHash);
+
+    // maps the cache of 'sourceFile', fails if there is none, it is outdated or has been created with other settings //
+    bool open(const std::string &sourceFile, uint64_t settingsHash);
+    void close(void);
+
+    // the returned pointers refer to the mapped file and are valid until close() //
+    const MeshCacheHeader& getHeader(void) const { return *mHeader; }
+    const GLfloat* getVertexData(void) const;
+    const GLuint* getIndexData(void) const;
+    // copies the groups and material libraries out of the mapping //
+    void getGroups(std::vector<MeshGroup> &groups, std::vector<std::string> &materialLibraries) const;
+    void getLods(std::vector<MeshLod> &lods) const;
+    void getClusters(std::vector<MeshCluster> &clusters) const;
+
+  private:
+    // identifies the current state of 'sourceFile', false if it does not exist //
+    static bool getSourceKey(const std::string &sourceFile, MeshCacheHeader &header);
+    const MeshCacheGroup* getGroupData(void) const;
+    const MeshCacheLod* getLodData(void) const;
+    const MeshCacheCluster* getClusterData(void) const;
+    const char* getStringData(void) const;
+    // checks that all indices address a vertex, all strings are terminated within the string data and all ranges lie within the indices //
+    bool validateData(void) const;
+
+    MappedFile mFile;
+    const MeshCacheHeader *mHeader;
+};
+
+#endif
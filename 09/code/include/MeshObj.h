@@ -6,6 +6,50 @@
 
 #include <vector>
 #include <stack>
+#include <string>
+
+#include "GLStateCache.h"
+#include "VertexLayout.h"
+
+// a part of a mesh ('o' / 'g' and 'usemtl' in OBJ files) -> a contiguous range of the index list //
+struct MeshGroup {
+  MeshGroup() : firstIndex(0), indexCount(0) {
+    for (unsigned int k = 0; k < 3; ++k) {
+      boundsMin[k] = boundsMax[k] = 0.0f;
+    }
+  };
+
+  std::string name;
+  // material name, defined in one of the material libraries of the mesh //
+  std::string material;
+  GLuint firstIndex;
+  GLuint indexCount;
+  // bounding box of the vertices used by the group //
+  GLfloat boundsMin[3];
+  GLfloat boundsMax[3];
+};
+
+// a level of detail -> a range of the index list drawing the whole mesh //
+struct MeshLod {
+  GLuint firstIndex;
+  GLuint indexCount;
+  // largest distance of the simplified surface to the full mesh, in object space //
+  GLfloat error;
+};
+
+// a small patch of the full mesh (see ClusterBuilder) -> a range of the index list with its culling data //
+struct MeshCluster {
+  GLuint firstIndex;
+  GLuint indexCount;
+  // bounding sphere //
+  GLfloat center[3];
+  GLfloat radius;
+  // normal cone -> all triangles face away from a camera at 'eye' if //
+  // dot(normalize(coneApex - eye), coneAxis) >= coneCutoff, a cutoff of 1 never culls
+  GLfloat coneApex[3];
+  GLfloat coneAxis[3];
+  GLfloat coneCutoff;
+};
 
 struct MeshData {
   // data vectors //
@@ -16,6 +60,44 @@ struct MeshData {
   std::vector<GLfloat> vertex_binormal;
   // index list //
   std::vector<GLuint> indices;
+  // parts of the mesh, they cover the index list in order //
+  std::vector<MeshGroup> groups;
+  // material files referenced by the groups //
+  std::vector<std::string> materialLibraries;
+  // levels of detail, from the full mesh (lods[0], the range covered by the groups) to the coarsest //
+  // their ranges follow each other in 'indices', no levels -> all indices are the full mesh
+  std::vector<MeshLod> lods;
+  // clusters of the full mesh in index order, empty if the mesh is not split //
+  std::vector<MeshCluster> clusters;
+  
+  // appends a copy of 'vertex' with all its attributes, returns the index of the copy //
+  GLuint copyVertex(GLuint vertex) {
+    const size_t vertexCount = vertex_position.size() / 3;
+    std::vector<GLfloat> *attributes[ATTRIB_COUNT] = {&vertex_position, &vertex_normal, &vertex_texcoord, &vertex_tangent, &vertex_binormal};
+    const GLuint attributeSize[ATTRIB_COUNT] = {3, 3, 2, 3, 3};
+    for (GLuint attribute = 0; attribute < ATTRIB_COUNT; ++attribute) {
+      std::vector<GLfloat> &data = *attributes[attribute];
+      const GLuint size = attributeSize[attribute];
+      if (data.size() == vertexCount * size) {
+        for (GLuint k = 0; k < size; ++k) {
+          data.push_back(data[vertex * size + k]);
+        }
+      }
+    }
+    return vertexCount;
+  }
+};
+
+// memory layout of the uploaded vertices //
+enum VertexFormat {
+  // FloatVertexLayout -> every attribute as 32-bit floats, 56 bytes per vertex //
+  VERTEX_FORMAT_FLOAT = 0,
+  // CompactVertexLayout -> 20 bytes per vertex //
+  //  - position as 16-bit normalized values within the mesh bounds
+  //  - normal and tangent as GL_INT_2_10_10_10_REV, the tangent's w holds the sign of the binormal,
+  //    the binormal itself is not stored (shaders rebuild it as cross(normal, tangent) * sign)
+  //  - texcoord as half floats
+  VERTEX_FORMAT_COMPACT
 };
 
 class MeshObj {
@@ -23,20 +105,135 @@ class MeshObj {
     MeshObj();
     ~MeshObj();
     
+    // format of the following uploads (setData() / setInterleavedData()), float by default //
+    // meshes with up to 65536 vertices get 16-bit indices in any format
+    void setVertexFormat(VertexFormat format) { mVertexFormat = format; }
+    VertexFormat getVertexFormat(void) const { return mVertexFormat; }
+    
+    // all vertices go into one interleaved VBO, attributes missing in 'data' are uploaded as zero //
     void setData(const MeshData &data);
+    // uploads in any layout of VertexLayout.h, regardless of the vertex format //
+    template <typename Layout> void setData(const MeshData &data);
+    // uploads interleaved vertices -> position(3), normal(3), texcoord(2), tangent(3), binormal(3) //
+    // attributes without their bit (1 << VertexAttribute) set in 'attributeMask' are read as zero
+    void setInterleavedData(const GLfloat *vertexData, GLuint vertexCount, GLuint attributeMask, const GLuint *indices, GLuint indexCount);
+    // sets the levels of detail of the uploaded index list (setData() takes them from the MeshData) //
+    // without any level all indices are the full mesh, call before setGroups()
+    void setLods(const std::vector<MeshLod> &lods);
+    // sets the parts of the uploaded index list (setData() takes them from the MeshData) //
+    // without any group the full mesh is one unnamed group
+    void setGroups(const std::vector<MeshGroup> &groups, const std::vector<std::string> &materialLibraries);
+    // sets the clusters of the full mesh (setData() takes them from the MeshData), none by default //
+    void setClusters(const std::vector<MeshCluster> &clusters) { mClusters = clusters; }
+    
+    GLuint getGroupCount(void) const { return mGroups.size(); }
+    const MeshGroup& getGroup(GLuint group) const { return mGroups[group]; }
+    // index of the first group called 'name', -1 if there is none //
+    int findGroup(const std::string &name) const;
+    const std::vector<std::string>& getMaterialLibraries(void) const { return mMaterialLibraries; }
+    // bounding box of all groups //
+    void getBounds(glm::vec3 &boundsMin, glm::vec3 &boundsMax) const;
+    
+    GLuint getLodCount(void) const { return mLods.size(); }
+    const MeshLod& getLod(GLuint lod) const { return mLods[lod]; }
+    // coarsest level whose error stays below 'maxPixelError' pixels on screen //
+    // 'pixelsPerUnit' -> projected size of one object space unit at the mesh (see CameraController::getPixelsPerUnit)
+    GLuint selectLod(float pixelsPerUnit, float maxPixelError = 1.0f) const;
+    
+    GLuint getClusterCount(void) const { return mClusters.size(); }
+    const MeshCluster& getCluster(GLuint cluster) const { return mClusters[cluster]; }
+    
+    // renders all groups //
     void render(void);
+    // renders a level of detail, all groups at once //
+    void renderLod(GLuint lod);
+    // renders single groups, all of them share the buffers -> the VAO is bound once per call //
+    void renderGroup(GLuint group);
+    void renderGroups(const GLuint *groups, GLuint groupCount);
+    // renders single clusters in ascending order (see ClusterCuller) -> neighbouring ranges are drawn by one call //
+    void renderClusters(const GLuint *clusters, GLuint clusterCount);
+    // renders 'instanceCount' copies of a level of detail with one draw call, for the instanced shaders //
+    // 'instanceBuffer' holds a glm::mat4 model matrix per copy (see InstanceBuffer), starting at 'firstInstance'
+    void renderInstanced(GLuint instanceCount, GLuint instanceBuffer, GLuint lod = 0, GLuint firstInstance = 0);
+    // model matrix the instanced shaders read in all other render calls //
+    static void setInstanceTransform(const glm::mat4 &model);
+    
+    // size of the uploaded vertex and index buffers in bytes //
+    GLsizeiptr getBufferSize(void) const { return mBufferSize; }
     
   private:
+    static VertexSource getVertexSource(const MeshData &data);
+    // packs the vertices of 'source' straight into the vertex buffer, expects the VAO to be bound //
+    template <typename Layout> void uploadVertices(VertexSource &source);
+    // gives the vertex buffer 'size' bytes and maps them for writing, disables all attribute arrays //
+    void* mapVertexBuffer(GLsizeiptr size);
+    // (re)creates 'buffer' with 'size' bytes of storage, immutable where supported, and maps it for writing //
+    // returns NULL for empty buffers and if the mapping failed
+    static void* mapBuffer(GLenum target, GLuint &buffer, GLsizeiptr size);
+    // false if the written data got lost while the buffer was mapped (e.g. by a display mode switch) -> write it again //
+    static bool unmapBuffer(GLenum target, void *mapped);
+    void setPositionDequantization(bool quantized, const VertexSource &source);
+    void uploadIndices(const GLuint *indices, GLuint vertexCount);
+    void bindVertexArray(void);
+    
+    VertexFormat mVertexFormat;
+    
     GLuint mVAO;
     
-    GLuint mVBO_position;
-    GLuint mVBO_normal;
-    GLuint mVBO_texcoord;
-    GLuint mVBO_tangent;
-    GLuint mVBO_binormal;
+    GLuint mVBO;
     
     GLuint mIBO;
     GLuint mIndexCount;
+    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT //
+    GLenum mIndexType;
+    GLuint mIndexSize;
+    GLsizeiptr mBufferSize;
+    // dequantization of the positions //
+    GLfloat mPositionOffset[3];
+    GLfloat mPositionScale[3];
+    // one bit per attribute read from the VBO, the others read constants //
+    GLuint mAttributeArrays;
+    
+    std::vector<MeshGroup> mGroups;
+    std::vector<std::string> mMaterialLibraries;
+    std::vector<MeshLod> mLods;
+    std::vector<MeshCluster> mClusters;
 };
 
+template <typename Layout>
+void MeshObj::setData(const MeshData &meshData) {
+  mIndexCount = meshData.indices.size();
+  setLods(meshData.lods);
+  setGroups(meshData.groups, meshData.materialLibraries);
+  setClusters(meshData.clusters);
+  
+  VertexSource source = getVertexSource(meshData);
+  if (mVAO == 0) {
+    glGenVertexArrays(1, &mVAO);
+  }
+  GLStateCache::bindVertexArray(mVAO);
+  uploadVertices<Layout>(source);
+  uploadIndices((mIndexCount > 0) ? &meshData.indices[0] : NULL, source.vertexCount);
+  GLStateCache::bindVertexArray(0);
+}
+
+template <typename Layout>
+void MeshObj::uploadVertices(VertexSource &source) {
+  if (Layout::QUANTIZED_POSITION) {
+    source.computeBounds();
+  }
+  // no intermediate copy -> every vertex is written once, into the GL's memory //
+  const GLsizei stride = sizeof(typename Layout::Vertex);
+  typename Layout::Vertex *vertices;
+  do {
+    vertices = static_cast<typename Layout::Vertex*>(mapVertexBuffer((GLsizeiptr)source.vertexCount * stride));
+    for (GLuint v = 0; vertices != NULL && v < source.vertexCount; ++v) {
+      Layout::pack(source, v, vertices[v]);
+    }
+  } while (!unmapBuffer(GL_ARRAY_BUFFER, vertices));
+  Layout::setupAttributes(stride);
+  mAttributeArrays = Layout::ATTRIBUTE_ARRAYS;
+  setPositionDequantization(Layout::QUANTIZED_POSITION, source);
+}
+
 #endif
@@ -0,0 +1,113 @@
+#ifndef __MESH_SIMPLIFIER__
+#define __MESH_SIMPLIFIER__
+
+#include <vector>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include "MeshObj.h"
+
+// #INFO# reduces the triangle count of indexed meshes by edge collapses, ordered by quadric error //
+// (Garland and Heckbert) plus a penalty for the change of normals and texture coordinates.
+// collapses join a vertex into one of its neighbours, vertices are never moved or added -> every level
+// of detail indexes the vertex buffer of the full mesh.
+//  - vertices on open borders only slide along the border
+//  - texture / normal seams (one position, two vertices) only collapse along the seam, both sides together
+//  - other non-manifold and seam vertices stay where they are
+// the work arrays are kept between calls -> meshes are best simplified with the same object
+class MeshSimplifier {
+  public:
+    // levels of detail generated by generateLods(), including the full mesh //
+    static const unsigned int MAX_LOD_COUNT = 8;
+    // no levels with fewer triangles than this are generated //
+    static const unsigned int MIN_LOD_TRIANGLES = 64;
+
+    MeshSimplifier();
+
+    // appends a chain of levels with halved triangle counts to the index list (see MeshData::lods) //
+    // the levels are nested -> each one is simplified further from the previous one
+    void generateLods(MeshData &meshData, unsigned int maxLodCount = MAX_LOD_COUNT);
+
+    // prepares the simplification of 'indexCount' indices of 'meshData' //
+    void begin(const MeshData &meshData, const GLuint *indices, size_t indexCount);
+    // collapses edges until at most 'targetIndexCount' indices are left or no edge can collapse //
+    // returns the number of indices left, simplify() continues where the last call stopped
+    size_t simplify(size_t targetIndexCount);
+    // current triangles of the simplified mesh //
+    const std::vector<GLuint>& getIndices(void) const { return mIndices; }
+    // largest error of the collapses so far, as distance in object space //
+    float getError(void) const;
+
+    // importance of normal and texture coordinate changes, relative to the size of the mesh //
+    // e.g. 0.01 -> a normal turned by 60 degrees costs as much as moving by 1% of the mesh size
+    void setAttributeWeight(float weight) { mAttributeWeight = weight; }
+
+  private:
+    enum VertexKind {KIND_MANIFOLD = 0, KIND_BORDER, KIND_SEAM, KIND_LOCKED};
+
+    // symmetric 4x4 matrix of the summed squared plane distances and the summed plane weights //
+    struct Quadric {
+      double a2, b2, c2, d2, ab, ac, ad, bc, bd, cd;
+      double weight;
+    };
+    // a possible collapse of 'from' (and its seam twin) into 'to' //
+    struct Collapse {
+      GLuint from;
+      GLuint to;
+      GLuint twinFrom;
+      GLuint twinTo;
+      float cost;
+    };
+
+    static void addPlane(Quadric &quadric, const glm::vec3 &normal, float distance, float weight);
+    static void addQuadric(Quadric &target, const Quadric &source);
+    static float evaluate(const Quadric &quadric, const glm::vec3 &point);
+
+    void buildAdjacency(void);
+    bool hasEdge(GLuint from, GLuint to) const;
+    bool hasPositionEdge(GLuint from, GLuint to) const;
+    void classifyVertices(void);
+    void initQuadrics(void);
+    // fills the collapse of 'from' into 'to' and returns true if it is allowed //
+    bool getCollapse(GLuint from, GLuint to, Collapse &collapse) const;
+    float getAttributeError(GLuint from, GLuint to) const;
+    // true if moving 'vertex' onto the position of 'target' flips one of its remaining triangles //
+    bool flipsTriangles(GLuint vertex, GLuint target) const;
+    void lockRing(GLuint vertex);
+    unsigned int countCollapsedTriangles(GLuint vertex, GLuint target) const;
+    size_t removeCollapsedTriangles(void);
+
+    float mAttributeWeight;
+    // positions scaled into the unit cube -> errors do not depend on the size of the mesh //
+    std::vector<glm::vec3> mPositions;
+    std::vector<glm::vec3> mNormals;
+    std::vector<glm::vec2> mTexcoords;
+    bool mHasNormals;
+    bool mHasTexcoords;
+    float mScale;
+
+    // vertices at one position form a ring -> 'mRemap' is the first of them, 'mWedge' the next one //
+    std::vector<GLuint> mRemap;
+    std::vector<GLuint> mWedge;
+    std::vector<GLuint> mSortedVertices;
+    std::vector<unsigned char> mKind;
+    // the single open edge leaving / entering a border or seam vertex //
+    std::vector<GLuint> mOpenOut;
+    std::vector<GLuint> mOpenIn;
+    // per position (indexed by 'mRemap') //
+    std::vector<Quadric> mQuadrics;
+    std::vector<unsigned char> mLocked;
+
+    std::vector<GLuint> mIndices;
+    // triangles per vertex //
+    std::vector<unsigned int> mAdjacencyOffset;
+    std::vector<unsigned int> mAdjacency;
+
+    std::vector<Collapse> mCollapses;
+    std::vector<unsigned int> mCollapseOrder;
+    std::vector<GLuint> mCollapseTarget;
+    float mMaxCost;
+};
+
+#endif
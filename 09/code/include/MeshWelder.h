@@ -0,0 +1,72 @@
+#ifndef __MESH_WELDER__
+#define __MESH_WELDER__
+
+#include <vector>
+#include <cstddef>
+
+#include "MeshObj.h"
+
+// #INFO# merges vertices of indexed mesh data that are equal within a tolerance //
+// VertexWelder joins corners with the same OBJ index triplet while importing, this one joins vertices by
+// their values -> duplicated 'v' records, meshes exported as triangle soups, ...
+// vertices are merged if their positions are within the position tolerance and their normals and texture
+// coordinates match as well, so hard edges and texture seams survive. the positions are hashed into a grid
+// of cells as large as the tolerance, only the neighbouring cells are searched -> linear time.
+// chains of vertices closer than the tolerance are merged into the first one of them. triangles losing
+// their area by the merge are dropped, the groups are shrunk accordingly. the cells are computed on all
+// threads, the work arrays are kept between calls.
+class MeshWelder {
+  public:
+    MeshWelder();
+
+    // welds 'meshData', call before levels of detail and clusters are generated //
+    // returns the number of vertices removed
+    unsigned int weld(MeshData &meshData);
+
+    // largest distance of merged positions, relative to the diagonal of the mesh's bounding box //
+    void setPositionTolerance(float tolerance) { mPositionTolerance = tolerance; }
+    // largest angle between merged normals in degrees //
+    void setNormalTolerance(float degrees);
+    // largest difference of merged texture coordinates per component //
+    void setTexcoordTolerance(float tolerance) { mTexcoordTolerance = tolerance; }
+    // threads used (0 -> one per core), the result does not depend on this setting //
+    void setThreadCount(unsigned int threadCount) { mThreadCount = threadCount; }
+
+  private:
+    struct Cell {
+      int x, y, z;
+    };
+
+    static size_t hash(int x, int y, int z);
+    void computeCells(const MeshData &meshData, size_t firstVertex, size_t endVertex);
+    void buildBuckets(size_t vertexCount);
+    // first vertex before 'vertex' it can be merged into, 'vertex' itself if there is none //
+    GLuint findMatch(const MeshData &meshData, GLuint vertex) const;
+    bool matches(const MeshData &meshData, GLuint a, GLuint b) const;
+    // drops the unused vertices and the triangles without area //
+    void compact(MeshData &meshData);
+
+    float mPositionTolerance;
+    float mCosNormalTolerance;
+    float mTexcoordTolerance;
+    unsigned int mThreadCount;
+
+    // absolute tolerance and cell size of the current mesh //
+    float mDistance;
+    float mCellSize;
+    float mOrigin[3];
+    bool mHasNormals;
+    bool mHasTexcoords;
+
+    std::vector<Cell> mCells;
+    std::vector<size_t> mHashes;
+    // vertices per hash bucket //
+    size_t mBucketMask;
+    std::vector<unsigned int> mBucketOffset;
+    std::vector<GLuint> mBucketVertices;
+    std::vector<unsigned int> mFillCount;
+    // vertex a vertex is merged into, then the new index of the kept vertices //
+    std::vector<GLuint> mRemap;
+};
+
+#endif
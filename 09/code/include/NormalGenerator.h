@@ -0,0 +1,73 @@
+#ifndef __NORMAL_GENERATOR__
+#define __NORMAL_GENERATOR__
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "MeshObj.h"
+
+// #INFO# computes smooth vertex normals for meshes imported without them (no 'vn' records) //
+// every corner gets the weighted sum of the normals of the triangles around its position, triangles whose
+// normal differs by more than the crease angle from the corner's own triangle are left out. corners of one
+// vertex ending up with different normals (at creases) get copies of the vertex.
+//  - only vertices with a zero normal are changed, given normals are kept
+//  - vertices at the same position are smoothed together (texture seams stay smooth)
+// face normals and weights are kept as separate arrays (structure of arrays) and computed in blocks on all
+// threads, the work arrays are kept between calls.
+class NormalGenerator {
+  public:
+    // contribution of a triangle to the normals of its corners //
+    enum Weighting {
+      // angle of the triangle at the corner (Thuermer and Wuethrich) -> independent of the tessellation //
+      WEIGHT_ANGLE = 0,
+      // area of the triangle //
+      WEIGHT_AREA
+    };
+
+    NormalGenerator();
+
+    // fills the missing normals of 'meshData', copies of split vertices are appended //
+    // returns the number of vertices that got a normal, including the copies
+    unsigned int generate(MeshData &meshData);
+
+    // triangles meeting at a larger angle (in degrees) form a hard edge, 180 smooths everything //
+    void setCreaseAngle(float degrees);
+    void setWeighting(Weighting weighting) { mWeighting = weighting; }
+    // threads used (0 -> one per core), the result does not depend on this setting //
+    void setThreadCount(unsigned int threadCount) { mThreadCount = threadCount; }
+
+  private:
+    void computeFaceNormals(const MeshData &meshData, size_t firstTriangle, size_t endTriangle);
+    void computeCornerNormals(const MeshData &meshData, size_t firstCorner, size_t endCorner);
+    // groups the vertices at the same position, fills 'mRemap' and the corners per position //
+    void buildPositionAdjacency(const MeshData &meshData);
+
+    float mCosCreaseAngle;
+    Weighting mWeighting;
+    unsigned int mThreadCount;
+
+    // per triangle, unit normal (zero for triangles without area) //
+    std::vector<float> mFaceX;
+    std::vector<float> mFaceY;
+    std::vector<float> mFaceZ;
+    // per corner //
+    std::vector<float> mCornerWeight;
+    std::vector<float> mCornerX;
+    std::vector<float> mCornerY;
+    std::vector<float> mCornerZ;
+
+    std::vector<unsigned char> mMissing;
+    // first vertex at the same position //
+    std::vector<GLuint> mRemap;
+    std::vector<GLuint> mSortedVertices;
+    // corners per position (indexed by 'mRemap') //
+    std::vector<unsigned int> mAdjacencyOffset;
+    std::vector<unsigned int> mAdjacency;
+    std::vector<unsigned int> mFillCount;
+    // copies of a vertex form a list -> corners with the same normal share a copy //
+    std::vector<unsigned char> mAssigned;
+    std::vector<GLuint> mNextCopy;
+};
+
+#endif
@@ -2,7 +2,10 @@
 #define __OBJ_LOADER__
 
 #include <map>
+#include <list>
 #include <string>
+#include <vector>
+#include <stdint.h>
 
 #include <glm/glm.hpp>
 
@@ -13,11 +16,70 @@ class ObjLoader {
     ObjLoader();
     ~ObjLoader();
     MeshObj* loadObjFile(std::string fileName, std::string ID = "");
+    // starts importing the file on a background thread and returns its (still empty) MeshObj //
+    // the MeshObj renders nothing until the data is uploaded by processFinishedImports()
+    // if the import fails, processFinishedImports() reports it and drops the ID -> getMeshObj() returns NULL
+    MeshObj* loadObjFileAsync(std::string fileName, std::string ID = "");
+    // uploads all finished background imports, call on the GL thread (e.g. once per frame) //
+    // returns the number of meshes uploaded
+    unsigned int processFinishedImports(void);
+    unsigned int getPendingImportCount(void) const { return mPendingImports.size(); }
     MeshObj* getMeshObj(std::string ID);
+    // imports an OBJ file into 'meshData' without creating a MeshObj (no GL calls) //
+    bool importObjFile(const std::string &fileName, MeshData &meshData);
+    // imports binary PLY and STL files as well, chosen by the extension (see PlyImporter, StlImporter) //
+    // the load functions use this one -> they accept all three formats
+    bool importMeshFile(const std::string &fileName, MeshData &meshData);
+    
+    // number of threads used to parse a file (0 -> one per core, 1 -> serial import) //
+    // the imported data does not depend on this setting
+    void setImportThreadCount(unsigned int threadCount) { mSettings.threadCount = threadCount; }
+    // load from / write to the binary sidecar (see MeshCache) instead of parsing the text file every time //
+    void setMeshCacheEnabled(bool enabled) { mSettings.useMeshCache = enabled; }
+    // merge vertices with equal attributes, positions within 'tolerance' times the mesh size are equal (see MeshWelder) //
+    void setWeldingEnabled(bool enabled) { mSettings.weldVertices = enabled; }
+    void setWeldTolerance(float tolerance) { mSettings.weldTolerance = tolerance; }
+    // meshes without normals get smooth ones, split where their triangles meet at more than 'degrees' (see NormalGenerator) //
+    void setNormalCreaseAngle(float degrees) { mSettings.normalCreaseAngle = degrees; }
+    // reorder triangles and vertices of imported meshes for the GPU's vertex cache (see VertexCacheOptimizer) //
+    void setVertexCacheOptimizationEnabled(bool enabled) { mSettings.optimizeVertexCache = enabled; }
+    // add simplified levels of detail to imported meshes (see MeshSimplifier, MeshObj::selectLod()) //
+    void setLodGenerationEnabled(bool enabled) { mSettings.generateLods = enabled; }
+    // split the full mesh of imported meshes into clusters for culling (see ClusterBuilder, ClusterCuller), off by default //
+    void setClusterBuildingEnabled(bool enabled) { mSettings.buildClusters = enabled; }
+    // vertex format of the MeshObjs uploaded from now on (see VertexFormat) //
+    void setVertexFormat(VertexFormat format) { mVertexFormat = format; }
+    // identifies the settings that change the imported data -> caches created with other settings are not used //
+    uint64_t getImportSettingsHash(void) const { return hashImportSettings(mSettings); }
   private:
-    std::map<std::string, MeshObj*> mMeshMap;
+    // everything that changes the result of an import //
+    // a queued import works on its own copy -> the setters may be called while it runs
+    struct ImportSettings {
+      unsigned int threadCount;
+      bool useMeshCache;
+      bool weldVertices;
+      float weldTolerance;
+      float normalCreaseAngle;
+      bool optimizeVertexCache;
+      bool generateLods;
+      bool buildClusters;
+    };
+    // state of one import, the CPU part may run on any thread, the upload on the GL thread only //
+    struct PendingImport;
+    void runImport(PendingImport &pending);
+    bool uploadImport(PendingImport &pending);
+    bool importObjFile(const std::string &fileName, MeshData &meshData, const ImportSettings &settings);
+    bool importMeshFile(const std::string &fileName, MeshData &meshData, const ImportSettings &settings);
+    // welding, normals, tangents, levels of detail, clusters and vertex cache order of a parsed mesh //
+    static void processImportedMesh(MeshData &meshData, const ImportSettings &settings);
+    static uint64_t hashImportSettings(const ImportSettings &settings);
     
-    void computeTangentSpace(MeshData &meshData);
+    std::map<std::string, MeshObj*> mMeshMap;
+    std::list<PendingImport*> mPendingImports;
+    // MeshObjs of failed background imports, no longer in the map but maybe still referenced //
+    std::vector<MeshObj*> mFailedMeshes;
+    ImportSettings mSettings;
+    VertexFormat mVertexFormat;
 };
 
 #endif
@@ -0,0 +1,64 @@
+#ifndef __OBJ_MESH_ASSEMBLER__
+#define __OBJ_MESH_ASSEMBLER__
+
+#include <vector>
+
+#include "MeshObj.h"
+#include "ObjParser.h"
+#include "PolygonTriangulator.h"
+#include "VertexWelder.h"
+
+// builds the indexed MeshData while the OBJ records are streamed in //
+// every face is triangulated, welded and appended to the index list as soon as it is read,
+// so the face list of a file is never held in memory
+class ObjMeshAssembler : public ObjRecordHandler {
+  public:
+    ObjMeshAssembler(MeshData &meshData, size_t expectedVertexCount = 0);
+
+    void addPosition(const glm::vec3 &position) { mPositions.push_back(position); }
+    void addNormal(const glm::vec3 &normal) { mNormals.push_back(normal); }
+    void addTexcoord(const glm::vec2 &texcoord) { mTexcoords.push_back(texcoord); }
+    void addFace(const int *face, const unsigned char *relative, unsigned int vertexCount);
+    void addMalformedFace(unsigned int line) { mMalformedLines.push_back(mLineOffset + line); }
+    void setGroupName(const std::string &name);
+    void setMaterial(const std::string &name);
+    void addMaterialLibrary(const std::string &fileName);
+
+    // appends the records of a separately parsed chunk of the following lines //
+    // its relative indices are rebased by the records already known, the chunk is emptied
+    void appendChunk(ObjChunk &chunk);
+
+    unsigned int getTriangleCount(void) const { return mMeshData.indices.size() / 3; }
+    unsigned int getGroupCount(void) const { return mMeshData.groups.size(); }
+    const std::vector<unsigned int>& getMalformedLines(void) const { return mMalformedLines; }
+    // faces dropped because they reference undefined vertices //
+    unsigned int getInvalidFaceCount(void) const { return mInvalidFaceCount; }
+
+  private:
+    // 'recordCount' = positions, normals and texcoords read before the face -> later records are undefined for it //
+    void addPolygon(const int *face, unsigned int vertexCount, const int *recordCount);
+    void addCorner(int vi, int ni, int ti, const int *recordCount);
+    void applyStateChange(const ObjChunk::StateChange &change);
+
+    MeshData &mMeshData;
+    VertexWelder mWelder;
+    PolygonTriangulator mTriangulator;
+    // corner positions of the current polygon -> input of the triangulator //
+    std::vector<glm::vec3> mPolygonPoints;
+
+    // records of the file read so far //
+    std::vector<glm::vec3> mPositions;
+    std::vector<glm::vec3> mNormals;
+    std::vector<glm::vec2> mTexcoords;
+
+    // group and material of the following faces, a new MeshGroup starts with the next face after a change //
+    std::string mGroupName;
+    std::string mMaterial;
+    bool mGroupChanged;
+
+    std::vector<unsigned int> mMalformedLines;
+    unsigned int mInvalidFaceCount;
+    unsigned int mLineOffset;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef __OBJ_PARSER__
+#define __OBJ_PARSER__
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+// receives the geometry records ('v', 'vn', 'vt', 'f') while an OBJ file is scanned //
+// the state records ('o', 'g', 'usemtl', 'mtllib') are optional and ignored by default
+class ObjRecordHandler {
+  public:
+    virtual ~ObjRecordHandler() {}
+
+    virtual void addPosition(const glm::vec3 &position) = 0;
+    virtual void addNormal(const glm::vec3 &normal) = 0;
+    virtual void addTexcoord(const glm::vec2 &texcoord) = 0;
+    // a polygon as 'vertexCount' index triplets (vertexId, normalId, texCoordId), undefined indices are -1 //
+    // 'relative' flags the indices given as negative OBJ index, these are resolved against
+    // the records of the scanned range only
+    virtual void addFace(const int *face, const unsigned char *relative, unsigned int vertexCount) = 0;
+    // 'line' is counted from 1 at the start of the scanned range //
+    virtual void addMalformedFace(unsigned int line) = 0;
+    // 'o' / 'g' and 'usemtl' name the group and material of the following faces //
+    virtual void setGroupName(const std::string &name) { (void)name; }
+    virtual void setMaterial(const std::string &name) { (void)name; }
+    // 'mtllib' -> a material file referenced by the mesh //
+    virtual void addMaterialLibrary(const std::string &fileName) { (void)fileName; }
+};
+
+// scans the lines in [begin, end) of a memory mapped OBJ file, returns the number of lines //
+// faces are handed out as soon as they are read
+unsigned int parseObjLines(const char *begin, const char *end, ObjRecordHandler &handler);
+
+// splits [begin, end) into at most 'chunkCount' ranges starting at line boundaries //
+// 'bounds' receives (ranges + 1) pointers, range i is [bounds[i], bounds[i + 1])
+void splitObjChunks(const char *begin, const char *end, unsigned int chunkCount, std::vector<const char*> &bounds);
+
+// collects the records of one range of lines (for parallel parsing) //
+struct ObjChunk : public ObjRecordHandler {
+  ObjChunk() : lineCount(0) {};
+
+  // a state record, it applies to the faces from 'faceIndex' on //
+  struct StateChange {
+    enum Type { GROUP_NAME, MATERIAL, MATERIAL_LIBRARY };
+    Type type;
+    size_t faceIndex;
+    std::string value;
+  };
+  // records read by the chunk before the faces from 'faceIndex' on -> a face may only use these //
+  struct RecordCount {
+    size_t faceIndex;
+    int count[3];
+  };
+
+  void addPosition(const glm::vec3 &position) { positions.push_back(position); }
+  void addNormal(const glm::vec3 &normal) { normals.push_back(normal); }
+  void addTexcoord(const glm::vec2 &texcoord) { texcoords.push_back(texcoord); }
+  void addFace(const int *face, const unsigned char *relative, unsigned int vertexCount);
+  void addMalformedFace(unsigned int line) { malformedLines.push_back(line); }
+  void setGroupName(const std::string &name) { addStateChange(StateChange::GROUP_NAME, name); }
+  void setMaterial(const std::string &name) { addStateChange(StateChange::MATERIAL, name); }
+  void addMaterialLibrary(const std::string &fileName) { addStateChange(StateChange::MATERIAL_LIBRARY, fileName); }
+  void addStateChange(StateChange::Type type, const std::string &value);
+
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec3> normals;
+  std::vector<glm::vec2> texcoords;
+  // flat polygon corners -> 3 ints per corner, 'faceSizes' corners per face //
+  std::vector<int> corners;
+  std::vector<unsigned int> faceSizes;
+  // entries of 'corners' which were given as relative index, they still need the //
+  // element count of all preceding chunks added (component = position within the triplet)
+  std::vector<size_t> relativeCorners;
+  std::vector<StateChange> stateChanges;
+  // only stored when a count changed since the previous face //
+  std::vector<RecordCount> recordCounts;
+  std::vector<unsigned int> malformedLines;
+  unsigned int lineCount;
+};
+
+#endif
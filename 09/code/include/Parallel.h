@@ -0,0 +1,48 @@
+#ifndef __PARALLEL__
+#define __PARALLEL__
+
+#include <thread>
+#include <atomic>
+#include <vector>
+
+// number of threads to use, if the caller asks for 'automatic' (0) //
+inline unsigned int resolveThreadCount(unsigned int threadCount) {
+  if (threadCount == 0) {
+    threadCount = std::thread::hardware_concurrency();
+  }
+  return (threadCount > 0) ? threadCount : 1;
+}
+
+// calls 'function(task)' for every task in [0, taskCount) on up to 'threadCount' threads //
+// tasks are handed out dynamically, the calling thread takes part in the work
+template <typename Function>
+void parallelFor(unsigned int taskCount, unsigned int threadCount, Function function) {
+  threadCount = resolveThreadCount(threadCount);
+  if (threadCount > taskCount) {
+    threadCount = taskCount;
+  }
+  if (threadCount <= 1) {
+    for (unsigned int task = 0; task < taskCount; ++task) {
+      function(task);
+    }
+    return;
+  }
+
+  std::atomic<unsigned int> nextTask(0);
+  auto worker = [&]() {
+    for (unsigned int task = nextTask++; task < taskCount; task = nextTask++) {
+      function(task);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount - 1);
+  for (unsigned int i = 1; i < threadCount; ++i) {
+    threads.push_back(std::thread(worker));
+  }
+  worker();
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+}
+
+#endif
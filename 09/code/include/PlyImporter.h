@@ -0,0 +1,91 @@
+#ifndef __PLY_IMPORTER__
+#define __PLY_IMPORTER__
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+
+#include <glm/glm.hpp>
+
+#include "MeshObj.h"
+#include "PolygonTriangulator.h"
+
+// #INFO# imports binary PLY files (little and big endian) into MeshData //
+// the header describes the elements of the file and their properties, these ones are used:
+//  - vertex: x, y, z, nx, ny, nz and u, v (or s, t / texture_u, texture_v), any scalar type
+//  - face: the list vertex_indices (or vertex_index), polygons are split up by PolygonTriangulator
+// other elements and properties (colors, confidence, ...) are skipped. the data is read in place from the
+// memory mapped file, vertex blocks in the other byte order are copied and swapped as a whole.
+// the mesh gets the same layout as an imported OBJ file: every vertex has a normal and a texture coordinate
+// (zero if the file has none), one group covers all triangles.
+class PlyImporter {
+  public:
+    PlyImporter();
+
+    // reads the file content 'data', false if it is no supported PLY file (see getError()) //
+    bool import(const char *data, size_t size, MeshData &meshData);
+    const std::string& getError(void) const { return mError; }
+    // faces skipped because of indices out of range //
+    unsigned int getInvalidFaceCount(void) const { return mInvalidFaceCount; }
+
+  private:
+    enum Type {
+      TYPE_INVALID = 0,
+      TYPE_INT8,
+      TYPE_UINT8,
+      TYPE_INT16,
+      TYPE_UINT16,
+      TYPE_INT32,
+      TYPE_UINT32,
+      TYPE_FLOAT32,
+      TYPE_FLOAT64
+    };
+    struct Property {
+      std::string name;
+      Type type;
+      // lists -> a count of 'countType' followed by that many values of 'type' //
+      bool isList;
+      Type countType;
+      // offset in the records of elements without lists //
+      size_t offset;
+    };
+    struct Element {
+      std::string name;
+      size_t count;
+      std::vector<Property> properties;
+      // 0 if the records contain lists -> their size varies //
+      size_t recordSize;
+    };
+
+    static Type parseType(const std::string &name);
+    static size_t getTypeSize(Type type);
+    // value at 'data' (no alignment needed), in the file's byte order if 'swap' is set //
+    static double readValue(const char *data, Type type, bool swap);
+
+    bool parseHeader(const char *data, size_t size, size_t &headerSize);
+    bool readVertices(const Element &element, const char *&cursor, const char *end, MeshData &meshData);
+    bool readFaces(const Element &element, const char *&cursor, const char *end, MeshData &meshData);
+    bool skipElement(const Element &element, const char *&cursor, const char *end);
+    void addPolygon(MeshData &meshData);
+    // drops vertices no face uses (scans often contain stray points), the others keep their order //
+    void removeUnusedVertices(MeshData &meshData);
+
+    std::vector<Element> mElements;
+    // vertex count given by the header, the faces may come first //
+    size_t mVertexCount;
+    // the file's byte order differs from the host's //
+    bool mSwap;
+    std::string mError;
+    unsigned int mInvalidFaceCount;
+
+    // aligned copy of a vertex block for the byte swap //
+    std::vector<uint64_t> mBlock;
+    // corners of the current face //
+    std::vector<GLuint> mPolygon;
+    std::vector<glm::vec3> mPolygonPoints;
+    std::vector<GLuint> mRemap;
+    PolygonTriangulator mTriangulator;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef __POLYGON_TRIANGULATOR__
+#define __POLYGON_TRIANGULATOR__
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// splits simple polygons (convex or concave, not necessarily planar) into triangles //
+//  - convex polygons are split up as a fan around their first corner
+//  - concave polygons are projected onto their dominant plane and split up by ear clipping
+// the work arrays are kept between calls -> no allocation per polygon once they are large enough
+class PolygonTriangulator {
+  public:
+    // triangulates the polygon given by its 'vertexCount' corner positions //
+    // returns the number of triangles, see getTriangles()
+    unsigned int triangulate(const glm::vec3 *points, unsigned int vertexCount);
+    // corner numbers (0 .. vertexCount - 1) of the triangles, 3 per triangle, orientation is kept //
+    const unsigned int* getTriangles(void) const { return &mTriangles[0]; }
+
+  private:
+    void addTriangle(unsigned int a, unsigned int b, unsigned int c);
+    unsigned int triangulateFan(unsigned int vertexCount);
+    unsigned int triangulateEars(unsigned int vertexCount);
+
+    std::vector<glm::vec2> mProjected;
+    std::vector<unsigned int> mPrev;
+    std::vector<unsigned int> mNext;
+    std::vector<unsigned int> mTriangles;
+};
+
+#endif
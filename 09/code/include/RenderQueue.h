@@ -0,0 +1,69 @@
+#ifndef __RENDER_QUEUE__
+#define __RENDER_QUEUE__
+
+#include <GL/glew.h>
+
+#include <vector>
+#include <stdint.h>
+
+// #INFO# draw items of a frame, ordered by a 64 bit sort key before they are executed //
+// the caller keeps its own list of draws and submits the index of each one with a key built by
+// makeOpaqueKey() / makeTranslucentKey(). sort() orders the items with a radix sort (8 passes of 8 bits,
+// passes over bytes that are equal for all keys are skipped, equal keys keep their submission order).
+// key layout, highest bits first:
+//  - opaque:      pass(4) | 0 | program(6) | texture set(8) | material(8) | mesh(13) | depth(24)
+//    -> state changes only where the key fields change, front to back within the same state (early-Z)
+//  - translucent: pass(4) | 1 | inverted depth(24) | program(6) | texture set(8) | material(8) | mesh(13)
+//    -> after the opaque items of the pass, strictly back to front for correct blending
+// the fields are ids of the caller (indices into its program / texture / material tables), larger values
+// are cut off. depth is a value of quantizeDepth().
+class RenderQueue {
+  public:
+    static const unsigned int PASS_BITS = 4;
+    static const unsigned int PROGRAM_BITS = 6;
+    static const unsigned int TEXTURE_SET_BITS = 8;
+    static const unsigned int MATERIAL_BITS = 8;
+    static const unsigned int MESH_BITS = 13;
+    static const unsigned int DEPTH_BITS = 24;
+
+    RenderQueue();
+
+    // removes all items, the memory is kept for the next frame //
+    void clear(void);
+    // adds the draw 'index' (of the caller's list) with the sort key 'key' //
+    void submit(uint64_t key, GLuint index);
+    void sort(void);
+
+    GLuint getItemCount(void) const { return mItems.size(); }
+    // key and index of the i-th item, in sorted order after sort() //
+    uint64_t getKey(GLuint i) const { return mItems[i].key; }
+    GLuint getIndex(GLuint i) const { return mItems[i].index; }
+
+    static uint64_t makeOpaqueKey(GLuint pass, GLuint program, GLuint textureSet, GLuint material, GLuint mesh, GLuint depth);
+    static uint64_t makeTranslucentKey(GLuint pass, GLuint program, GLuint textureSet, GLuint material, GLuint mesh, GLuint depth);
+    // view space distance 'depth' mapped linearly from [nearPlane, farPlane] to DEPTH_BITS, clamped //
+    static GLuint quantizeDepth(float depth, float nearPlane, float farPlane);
+
+    // fields of a key of either layout //
+    static GLuint getPass(uint64_t key);
+    static bool isTranslucent(uint64_t key);
+    static GLuint getProgram(uint64_t key);
+    static GLuint getTextureSet(uint64_t key);
+    static GLuint getMaterial(uint64_t key);
+    static GLuint getMesh(uint64_t key);
+
+  private:
+    struct Item {
+      uint64_t key;
+      GLuint index;
+    };
+
+    // program | texture set | material | mesh of a key, the same bits for both layouts after the shift //
+    static uint64_t getStateBits(uint64_t key);
+
+    std::vector<Item> mItems;
+    // second buffer of the radix sort //
+    std::vector<Item> mSortBuffer;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef __STL_IMPORTER__
+#define __STL_IMPORTER__
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+
+#include "MeshObj.h"
+
+// #INFO# imports binary STL files into MeshData //
+// STL stores every triangle on its own: 3 positions and a face normal, nothing is shared between triangles.
+// the positions become a triangle soup without normals and texture coordinates (zero, like an OBJ file
+// without them) -> the loader's welding (see MeshWelder) joins the corners and NormalGenerator gives
+// smooth normals split at creases. the face normals are not used, they would keep every corner apart.
+// the data is little endian, big endian hosts swap the positions as a whole.
+class StlImporter {
+  public:
+    // reads the file content 'data', false if it is no binary STL file (see getError()) //
+    bool import(const char *data, size_t size, MeshData &meshData);
+    const std::string& getError(void) const { return mError; }
+
+  private:
+    std::string mError;
+    // positions of the big endian path //
+    std::vector<uint32_t> mWords;
+};
+
+#endif
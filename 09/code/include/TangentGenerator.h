@@ -0,0 +1,53 @@
+#ifndef __TANGENT_GENERATOR__
+#define __TANGENT_GENERATOR__
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "MeshObj.h"
+
+// #INFO# computes per vertex tangents and binormals of indexed meshes the way MikkTSpace does //
+//  - every triangle gives the directions of increasing u (tangent) and v (binormal) on its surface
+//  - a vertex sums them over its triangles, projected onto the plane of its normal and weighted by the
+//    angle of the triangle at the vertex -> the result does not depend on the tessellation
+//  - binormal = sign * cross(normal, tangent), the sign is the orientation of the texture mapping
+// triangles without texture area (degenerate UVs) add nothing, vertices left without any tangent get one
+// perpendicular to their normal. vertices used by mirrored and unmirrored triangles (e.g. on the mirror
+// line of a symmetric texture) are copied, one copy per orientation.
+// the vertices are processed in blocks on all threads, each one gathers the sums of its own triangles ->
+// no atomics, and the result does not depend on the thread count. the work arrays are kept between calls.
+class TangentGenerator {
+  public:
+    TangentGenerator();
+
+    // fills 'vertex_tangent' and 'vertex_binormal', expects positions, normals and texture coordinates //
+    // returns the number of vertices copied because of differently oriented texture mappings
+    unsigned int generate(MeshData &meshData);
+
+    // threads used (0 -> one per core) //
+    void setThreadCount(unsigned int threadCount) { mThreadCount = threadCount; }
+
+  private:
+    void computeTriangleFrames(const MeshData &meshData, size_t firstTriangle, size_t endTriangle);
+    // one copy per vertex for the corners of triangles whose orientation differs from the vertex's first one //
+    unsigned int splitMirroredVertices(MeshData &meshData);
+    void buildAdjacency(const MeshData &meshData);
+    void computeVertexFrames(MeshData &meshData, size_t firstVertex, size_t endVertex);
+
+    unsigned int mThreadCount;
+
+    // per triangle, unit direction of increasing u //
+    std::vector<glm::vec3> mTriangleTangent;
+    // 1 -> preserves the orientation, 0 -> mirrored, NO_ORIENTATION -> no texture area //
+    std::vector<unsigned char> mOrientation;
+
+    std::vector<unsigned char> mVertexOrientation;
+    std::vector<GLuint> mMirroredCopy;
+    // corners per vertex //
+    std::vector<unsigned int> mAdjacencyOffset;
+    std::vector<unsigned int> mAdjacency;
+    std::vector<unsigned int> mFillCount;
+};
+
+#endif
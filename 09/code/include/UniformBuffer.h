@@ -0,0 +1,42 @@
+#ifndef __UNIFORM_BUFFER__
+#define __UNIFORM_BUFFER__
+
+#include <GL/glew.h>
+
+#include <vector>
+#include <cstddef>
+
+// #INFO# buffer of a std140 uniform block with a CPU copy of its content //
+// write() only marks bytes that really changed, upload() sends the marked range with one call ->
+// static content costs nothing per frame, a single changed entry of an array only uploads that entry.
+// the buffer stays bound to its binding point, programs are connected with ShaderProgram::bindUniformBlock().
+class UniformBuffer {
+  public:
+    UniformBuffer();
+    ~UniformBuffer();
+
+    // creates the buffer with 'size' zeroed bytes and binds it to the uniform block binding point 'binding' //
+    void create(GLsizeiptr size, GLuint binding);
+
+    // copies 'size' bytes to 'offset' of the block, the changed part is uploaded by the next upload() //
+    void write(size_t offset, const void *data, size_t size);
+    // sends the changed range to the GL, nothing if no write() changed the content //
+    void upload(void);
+    bool isDirty(void) const { return mDirtyBegin < mDirtyEnd; }
+
+    GLuint getBinding(void) const { return mBinding; }
+
+  private:
+    // not copyable -> the buffer is owned by exactly one object //
+    UniformBuffer(const UniformBuffer &);
+    UniformBuffer& operator=(const UniformBuffer &);
+
+    GLuint mBuffer;
+    GLuint mBinding;
+    std::vector<unsigned char> mData;
+    // changed bytes [mDirtyBegin, mDirtyEnd) //
+    size_t mDirtyBegin;
+    size_t mDirtyEnd;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef __VERTEX_CACHE_OPTIMIZER__
+#define __VERTEX_CACHE_OPTIMIZER__
+
+#include <vector>
+#include <cstddef>
+
+#include "MeshObj.h"
+
+// post-transform vertex cache efficiency of an index list //
+//  - ACMR -> average cache miss ratio, transformed vertices per triangle (>= 0.5, 3.0 is worst)
+//  - ATVR -> average transform to vertex ratio, transformed vertices per vertex (1.0 is optimal)
+struct VertexCacheStats {
+  float acmr;
+  float atvr;
+};
+
+// #INFO# reorders indexed meshes for the post-transform vertex cache of the GPU //
+// triangles are reordered with Tom Forsyth's linear-speed vertex cache optimisation, each group
+// on its own so the draw ranges stay valid. vertices are renumbered by first use afterwards,
+// so vertex fetches run through the buffers sequentially.
+// the work arrays are kept between calls -> meshes are best optimized with the same object
+class VertexCacheOptimizer {
+  public:
+    // size of the simulated LRU cache used for scoring //
+    static const unsigned int CACHE_SIZE = 32;
+
+    // reorders the triangles of every group (or cluster) and level of detail, then the vertices of the whole mesh //
+    void optimize(MeshData &meshData);
+    // reorders the triangles of 'indexCount' indices in place //
+    void optimizeTriangleOrder(GLuint *indices, size_t indexCount);
+    // renumbers the vertices in order of their first use, all attribute arrays are reordered //
+    void optimizeVertexOrder(MeshData &meshData);
+
+    // cache efficiency for a FIFO cache of 'cacheSize' entries //
+    static VertexCacheStats measure(const GLuint *indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize = CACHE_SIZE);
+
+  private:
+    float getVertexScore(int cachePosition, unsigned int remainingTriangles) const;
+    void initScoreTables(void);
+
+    // vertices of the triangles being optimized, numbered locally //
+    std::vector<int> mLocalVertex;
+    std::vector<GLuint> mGlobalVertex;
+    std::vector<unsigned int> mRemaining;
+    std::vector<int> mCachePosition;
+    std::vector<float> mVertexScore;
+    // triangles per vertex -> the first 'mRemaining' entries are the triangles not yet emitted //
+    std::vector<unsigned int> mAdjacencyOffset;
+    std::vector<unsigned int> mAdjacency;
+    // triangles, their corners as local vertex numbers //
+    std::vector<int> mCorners;
+    std::vector<float> mTriangleScore;
+    std::vector<unsigned char> mTriangleEmitted;
+    std::vector<GLuint> mOrderedIndices;
+    // LRU cache, with room for the vertices pushed out by the last triangle //
+    std::vector<int> mCache;
+    std::vector<int> mNextCache;
+
+    std::vector<float> mCacheScore;
+    std::vector<float> mValenceScore;
+};
+
+#endif
@@ -0,0 +1,237 @@
+#ifndef __VERTEX_LAYOUT__
+#define __VERTEX_LAYOUT__
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/half_float.hpp>
+
+// vertex attributes and their shader locations //
+enum VertexAttribute {
+  ATTRIB_POSITION = 0,
+  ATTRIB_NORMAL,
+  ATTRIB_TEXCOORD,
+  ATTRIB_TANGENT,
+  ATTRIB_BINORMAL,
+  ATTRIB_COUNT
+};
+
+// locations of the position dequantization -> shaders compute 'offset + scale * vertex' //
+// they are set as constant attribute values by MeshObj::render(), identity for float positions
+static const GLuint ATTRIB_POSITION_OFFSET = 5;
+static const GLuint ATTRIB_POSITION_SCALE = 6;
+// per instance model matrix of the instanced shaders, one column per location (7 - 10) //
+// MeshObj::renderInstanced() reads it from an instance buffer, other draws read the constant set by
+// MeshObj::setInstanceTransform()
+static const GLuint ATTRIB_INSTANCE_MODEL = 7;
+
+// float attribute arrays a vertex buffer is packed from //
+// missing attributes read as zero (stride 0), so packing needs no checks per vertex
+struct VertexSource {
+  VertexSource(GLuint vertexCount) : vertexCount(vertexCount), positionMin(0.0f), positionExtent(0.0f), positionScale(0.0f) {
+    static const GLfloat zeros[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (GLuint attribute = 0; attribute < ATTRIB_COUNT; ++attribute) {
+      data[attribute] = zeros;
+      stride[attribute] = 0;
+      available[attribute] = false;
+    }
+  };
+
+  void setAttribute(VertexAttribute attribute, const GLfloat *attributeData, GLuint attributeStride) {
+    data[attribute] = attributeData;
+    stride[attribute] = attributeStride;
+    available[attribute] = true;
+  }
+  const GLfloat* get(VertexAttribute attribute, GLuint vertex) const { return data[attribute] + vertex * stride[attribute]; }
+
+  // bounding box of the positions, needed for quantized positions //
+  void computeBounds(void) {
+    for (GLuint v = 0; v < vertexCount; ++v) {
+      const GLfloat *position = get(ATTRIB_POSITION, v);
+      glm::vec3 value(position[0], position[1], position[2]);
+      positionMin = (v == 0) ? value : glm::min(positionMin, value);
+      positionExtent = (v == 0) ? value : glm::max(positionExtent, value);
+    }
+    positionExtent -= positionMin;
+    for (unsigned int k = 0; k < 3; ++k) {
+      positionScale[k] = (positionExtent[k] > 0.0f) ? 1.0f / positionExtent[k] : 0.0f;
+    }
+  }
+
+  GLuint vertexCount;
+  const GLfloat *data[ATTRIB_COUNT];
+  GLuint stride[ATTRIB_COUNT];
+  bool available[ATTRIB_COUNT];
+  glm::vec3 positionMin;
+  glm::vec3 positionExtent;
+  // 1 / extent, 0 for flat dimensions //
+  glm::vec3 positionScale;
+};
+
+// packs components in [-1, 1] as signed normalized GL_INT_2_10_10_10_REV //
+// (glm::uint10_10_10_2_cast packs unsigned values with a wrong scale, so it is of no use here)
+inline GLuint packSnorm2_10_10_10(const glm::vec4 &value) {
+  glm::vec4 clamped = glm::clamp(value, -1.0f, 1.0f);
+  GLuint x = (GLuint)(int)std::floor(clamped.x * 511.0f + 0.5f) & 0x3FF;
+  GLuint y = (GLuint)(int)std::floor(clamped.y * 511.0f + 0.5f) & 0x3FF;
+  GLuint z = (GLuint)(int)std::floor(clamped.z * 511.0f + 0.5f) & 0x3FF;
+  GLuint w = (GLuint)(int)std::floor(clamped.w + 0.5f) & 0x3;
+  return x | (y << 10) | (z << 20) | (w << 30);
+}
+
+// #INFO# attribute formats -> how one attribute is stored in the vertex buffer //
+// every format provides
+//  - Storage                          the data of the attribute within a vertex
+//  - LOCATION, SIZE, TYPE, NORMALIZED the arguments of glVertexAttribPointer
+//  - QUANTIZED_POSITION               true if the shaders have to dequantize the position
+//  - pack(source, vertex, storage)    converts the source data of one vertex
+
+// 'Size' 32-bit floats //
+template <VertexAttribute Attribute, GLint Size>
+struct FloatFormat {
+  typedef GLfloat Storage[Size];
+  static const GLuint LOCATION = Attribute;
+  static const GLint SIZE = Size;
+  static const GLenum TYPE = GL_FLOAT;
+  static const GLboolean NORMALIZED = GL_FALSE;
+  static const bool QUANTIZED_POSITION = false;
+
+  static void pack(const VertexSource &source, GLuint vertex, Storage &storage) {
+    const GLfloat *data = source.get(Attribute, vertex);
+    for (GLint k = 0; k < Size; ++k) {
+      storage[k] = data[k];
+    }
+  }
+};
+
+// 2 half floats //
+template <VertexAttribute Attribute>
+struct HalfFloat2Format {
+  typedef GLushort Storage[2];
+  static const GLuint LOCATION = Attribute;
+  static const GLint SIZE = 2;
+  static const GLenum TYPE = GL_HALF_FLOAT;
+  static const GLboolean NORMALIZED = GL_FALSE;
+  static const bool QUANTIZED_POSITION = false;
+
+  static void pack(const VertexSource &source, GLuint vertex, Storage &storage) {
+    const GLfloat *data = source.get(Attribute, vertex);
+    storage[0] = (GLushort)glm::detail::toFloat16(data[0]);
+    storage[1] = (GLushort)glm::detail::toFloat16(data[1]);
+  }
+};
+
+// unit vector as signed normalized 10-bit components //
+template <VertexAttribute Attribute>
+struct PackedVectorFormat {
+  typedef GLuint Storage;
+  static const GLuint LOCATION = Attribute;
+  static const GLint SIZE = 4;
+  static const GLenum TYPE = GL_INT_2_10_10_10_REV;
+  static const GLboolean NORMALIZED = GL_TRUE;
+  static const bool QUANTIZED_POSITION = false;
+
+  static void pack(const VertexSource &source, GLuint vertex, Storage &storage) {
+    const GLfloat *data = source.get(Attribute, vertex);
+    storage = packSnorm2_10_10_10(glm::vec4(data[0], data[1], data[2], 0.0f));
+  }
+};
+
+// tangent as signed normalized 10-bit components, w holds the direction of the binormal //
+// relative to cross(normal, tangent) -> the binormal itself needs not be stored
+struct PackedTangentFormat {
+  typedef GLuint Storage;
+  static const GLuint LOCATION = ATTRIB_TANGENT;
+  static const GLint SIZE = 4;
+  static const GLenum TYPE = GL_INT_2_10_10_10_REV;
+  static const GLboolean NORMALIZED = GL_TRUE;
+  static const bool QUANTIZED_POSITION = false;
+
+  static void pack(const VertexSource &source, GLuint vertex, Storage &storage) {
+    const GLfloat *normal = source.get(ATTRIB_NORMAL, vertex);
+    const GLfloat *tangent = source.get(ATTRIB_TANGENT, vertex);
+    const GLfloat *binormal = source.get(ATTRIB_BINORMAL, vertex);
+    glm::vec3 rebuilt = glm::cross(glm::vec3(normal[0], normal[1], normal[2]), glm::vec3(tangent[0], tangent[1], tangent[2]));
+    float sign = (glm::dot(rebuilt, glm::vec3(binormal[0], binormal[1], binormal[2])) < 0.0f) ? -1.0f : 1.0f;
+    storage = packSnorm2_10_10_10(glm::vec4(tangent[0], tangent[1], tangent[2], sign));
+  }
+};
+
+// position as 16-bit unsigned normalized values within the bounding box (see VertexSource::computeBounds) //
+struct QuantizedPositionFormat {
+  typedef GLushort Storage[4];
+  static const GLuint LOCATION = ATTRIB_POSITION;
+  static const GLint SIZE = 3;
+  static const GLenum TYPE = GL_UNSIGNED_SHORT;
+  static const GLboolean NORMALIZED = GL_TRUE;
+  static const bool QUANTIZED_POSITION = true;
+
+  static void pack(const VertexSource &source, GLuint vertex, Storage &storage) {
+    const GLfloat *position = source.get(ATTRIB_POSITION, vertex);
+    for (unsigned int k = 0; k < 3; ++k) {
+      float normalized = (position[k] - source.positionMin[k]) * source.positionScale[k];
+      storage[k] = (GLushort)glm::clamp(normalized * 65535.0f + 0.5f, 0.0f, 65535.0f);
+    }
+    storage[3] = 0;
+  }
+};
+
+// #INFO# interleaved vertex of a list of attribute formats, generated at compile time //
+//  - Vertex                  struct with the storage of all formats in the given order
+//  - pack(source, vertex, v) converts one vertex
+//  - setupAttributes(stride) sets the attribute pointers of the bound VAO / VBO
+//  - ATTRIBUTE_ARRAYS        one bit per location the layout reads from the VBO
+// a custom format is a single declaration, e.g.
+//   typedef VertexLayout<FloatFormat<ATTRIB_POSITION, 3>, HalfFloat2Format<ATTRIB_TEXCOORD> > PositionTexcoordLayout;
+template <typename... Formats>
+struct VertexLayout;
+
+template <typename Format>
+struct VertexLayout<Format> {
+  struct Vertex {
+    typename Format::Storage value;
+  };
+  static const bool QUANTIZED_POSITION = Format::QUANTIZED_POSITION;
+  static const GLuint ATTRIBUTE_ARRAYS = 1u << Format::LOCATION;
+
+  static void pack(const VertexSource &source, GLuint vertex, Vertex &target) {
+    Format::pack(source, vertex, target.value);
+  }
+  static void setupAttributes(GLsizei stride, size_t offset = 0) {
+    glVertexAttribPointer(Format::LOCATION, Format::SIZE, Format::TYPE, Format::NORMALIZED, stride, (void*)(offset + offsetof(Vertex, value)));
+    glEnableVertexAttribArray(Format::LOCATION);
+  }
+};
+
+template <typename Format, typename Next, typename... Rest>
+struct VertexLayout<Format, Next, Rest...> {
+  typedef VertexLayout<Next, Rest...> Tail;
+  struct Vertex {
+    typename Format::Storage value;
+    typename Tail::Vertex tail;
+  };
+  static const bool QUANTIZED_POSITION = Format::QUANTIZED_POSITION || Tail::QUANTIZED_POSITION;
+  static const GLuint ATTRIBUTE_ARRAYS = (1u << Format::LOCATION) | Tail::ATTRIBUTE_ARRAYS;
+
+  static void pack(const VertexSource &source, GLuint vertex, Vertex &target) {
+    Format::pack(source, vertex, target.value);
+    Tail::pack(source, vertex, target.tail);
+  }
+  static void setupAttributes(GLsizei stride, size_t offset = 0) {
+    glVertexAttribPointer(Format::LOCATION, Format::SIZE, Format::TYPE, Format::NORMALIZED, stride, (void*)(offset + offsetof(Vertex, value)));
+    glEnableVertexAttribArray(Format::LOCATION);
+    Tail::setupAttributes(stride, offset + offsetof(Vertex, tail));
+  }
+};
+
+// all attributes as floats, 56 bytes per vertex (the layout of the mesh cache) //
+typedef VertexLayout<FloatFormat<ATTRIB_POSITION, 3>, FloatFormat<ATTRIB_NORMAL, 3>, FloatFormat<ATTRIB_TEXCOORD, 2>,
+                     FloatFormat<ATTRIB_TANGENT, 3>, FloatFormat<ATTRIB_BINORMAL, 3> > FloatVertexLayout;
+// quantized attributes, 20 bytes per vertex -> the binormal is rebuilt by the shaders //
+typedef VertexLayout<QuantizedPositionFormat, PackedVectorFormat<ATTRIB_NORMAL>, PackedTangentFormat,
+                     HalfFloat2Format<ATTRIB_TEXCOORD> > CompactVertexLayout;
+
+#endif
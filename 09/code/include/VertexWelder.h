@@ -0,0 +1,40 @@
+#ifndef __VERTEX_WELDER__
+#define __VERTEX_WELDER__
+
+#include <vector>
+#include <cstddef>
+
+// maps index triplets (vertexId, normalId, texCoordId) to unique vertex indices //
+// open addressing hash table with linear probing, the triplet itself is the key
+// -> no string keys, no allocation per lookup
+class VertexWelder {
+  public:
+    VertexWelder(size_t expectedVertexCount = 0);
+
+    // preallocate the table for the given amount of unique vertices //
+    void reserve(size_t expectedVertexCount);
+    void clear(void);
+
+    // looks up the triplet, unknown triplets get the next free index //
+    // returns true, if a new vertex has been created for this triplet
+    bool weld(int vi, int ni, int ti, unsigned int &index);
+
+    // number of unique vertices created so far //
+    unsigned int vertexCount(void) const { return mVertexCount; }
+
+  private:
+    struct Slot {
+      int vi, ni, ti;
+      unsigned int index;
+    };
+    static const unsigned int EMPTY_SLOT = 0xFFFFFFFFu;
+
+    static unsigned int hash(int vi, int ni, int ti);
+    void rehash(size_t slotCount);
+
+    std::vector<Slot> mSlots;
+    size_t mMask;
+    unsigned int mVertexCount;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#version 330
+layout(location = 0) in vec3 vertex;
+layout(location = 1) in vec3 vertex_normal;
+layout(location = 2) in vec2 vertex_texcoord;
+layout(location = 3) in vec4 vertex_tangent;
+layout(location = 4) in vec3 vertex_binormal;
+// dequantization of compact positions and the binormal sign (tangent.w) -> see MeshObj //
+layout(location = 5) in vec3 vertex_position_offset;
+layout(location = 6) in vec3 vertex_position_scale;
+// model matrix of the copy -> per instance buffer or a constant (see MeshObj::renderInstanced) //
+layout(location = 7) in mat4 instance_model;
+
+// compact vertices have no binormal (reads as 0) -> rebuild it from normal and tangent //
+vec3 getBinormal() {
+  if (dot(vertex_binormal, vertex_binormal) > 0.0) {
+    return vertex_binormal;
+  }
+  return cross(vertex_normal, vertex_tangent.xyz) * (vertex_tangent.w < 0.0 ? -1.0 : 1.0);
+}
+
+// out variables to be passed to the fragment shader //
+out vec3 io_vertex;
+out vec3 io_tangent;
+out vec3 io_binormal;
+out vec3 io_normal;
+out vec2 io_texCoord;
+
+// view and projection matrix, the modelview matrix is built per instance //
+uniform mat4 view;
+uniform mat4 projection;
+
+void main() {
+  mat4 modelview = view * instance_model;
+  vec3 position = vertex_position_offset + vertex_position_scale * vertex;
+  gl_Position = projection * modelview * vec4(position, 1.0);
+  
+  // TODO: vertex position in camera space //
+  io_vertex = (modelview * vec4(position, 1.0)).xyz;
+  
+  // normal matrix //
+  mat4 normalMatrix = transpose(inverse(modelview));
+  
+  // TODO: tangent, bitangent and normal //
+  io_tangent = (normalMatrix * vec4(vertex_tangent.xyz, 0.0)).xyz;
+  io_binormal = (normalMatrix * vec4(getBinormal(), 0.0)).xyz;
+  io_normal = (normalMatrix * vec4(vertex_normal, 0.0)).xyz;
+  
+  // TODO: texture coord //
+  io_texCoord = vertex_texcoord; 
+}
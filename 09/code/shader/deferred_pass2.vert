@@ -12,8 +12,10 @@ struct LightSource {
   float power;
 };
 
-uniform LightSource lightSource[maxLightCount];
-uniform int usedLightCount;
+layout(std140) uniform Lights {
+  LightSource lightSource[maxLightCount];
+  int usedLightCount;
+};
 
 // out variables to be passed to the fragment shader //
 out vec3 io_lightPos[maxLightCount];
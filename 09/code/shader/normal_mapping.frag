@@ -1,5 +1,6 @@
 #version 330
 const int maxLightCount = 10;
+const int maxMaterialCount = 8;
 
 struct LightSource {
   vec3 ambient_color;
@@ -16,9 +17,16 @@ struct Material {
   float specular_shininess;
 };
 
-uniform LightSource lightSource[maxLightCount];
-uniform int usedLightCount;
-uniform Material material;
+// std140 uniform blocks -> the application writes them with fixed offsets //
+layout(std140) uniform Lights {
+  LightSource lightSource[maxLightCount];
+  int usedLightCount;
+};
+// all materials, the used one is selected by its index //
+layout(std140) uniform Materials {
+  Material materials[maxMaterialCount];
+  int materialIndex;
+};
 
 // variables passed from vertex to fragment program //
 in vec3 vertexNormal;
@@ -34,6 +42,7 @@ uniform sampler2D normalMap;
 out vec4 color;
 
 void main() {
+  Material material = materials[materialIndex];
   // earth color //
   vec3 diffuse = texture2D(diffuseTexture, textureCoord).rgb;
   
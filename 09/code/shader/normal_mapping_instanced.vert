@@ -2,8 +2,21 @@
 layout(location = 0) in vec3 vertex;
 layout(location = 1) in vec3 vertex_normal;
 layout(location = 2) in vec2 vertex_texcoord;
-layout(location = 3) in vec3 vertex_tangent;
+layout(location = 3) in vec4 vertex_tangent;
 layout(location = 4) in vec3 vertex_binormal;
+// dequantization of compact positions and the binormal sign (tangent.w) -> see MeshObj //
+layout(location = 5) in vec3 vertex_position_offset;
+layout(location = 6) in vec3 vertex_position_scale;
+// model matrix of the copy -> per instance buffer or a constant (see MeshObj::renderInstanced) //
+layout(location = 7) in mat4 instance_model;
+
+// compact vertices have no binormal (reads as 0) -> rebuild it from normal and tangent //
+vec3 getBinormal() {
+  if (dot(vertex_binormal, vertex_binormal) > 0.0) {
+    return vertex_binormal;
+  }
+  return cross(vertex_normal, vertex_tangent.xyz) * (vertex_tangent.w < 0.0 ? -1.0 : 1.0);
+}
 
 const int maxLightCount = 10;
 
@@ -16,8 +29,10 @@ struct LightSource {
   float power;
 };
 
-uniform LightSource lightSource[maxLightCount];
-uniform int usedLightCount;
+layout(std140) uniform Lights {
+  LightSource lightSource[maxLightCount];
+  int usedLightCount;
+};
 
 // out variables to be passed to the fragment shader //
 out vec3 vertexNormal; // not needed anymore, when using normal maps //
@@ -25,23 +40,24 @@ out vec3 eyeDir;
 out vec3 lightDir[maxLightCount];
 out vec2 textureCoord;
 
-// modelview and projection matrix //
+// view and projection matrix, the modelview matrix is built per instance //
 uniform mat4 view;
-uniform mat4 modelview;
 uniform mat4 projection;
 
 void main() {
+  mat4 modelview = view * instance_model;
   int lightCount = max(min(usedLightCount, maxLightCount), 0);
+  vec3 position = vertex_position_offset + vertex_position_scale * vertex;
   
   // normal matrix //
   mat4 normalMatrix = transpose(inverse(modelview));
   
-  vec3 tangent = (normalMatrix * vec4(vertex_tangent, 0)).xyz;
-  vec3 binormal = (normalMatrix * vec4(vertex_binormal, 0)).xyz;
+  vec3 tangent = (normalMatrix * vec4(vertex_tangent.xyz, 0)).xyz;
+  vec3 binormal = (normalMatrix * vec4(getBinormal(), 0)).xyz;
   vec3 normal = (normalMatrix * vec4(vertex_normal, 0)).xyz;
   
   vertexNormal = normal;
-  gl_Position = projection * modelview * vec4(vertex, 1.0);
+  gl_Position = projection * modelview * vec4(position, 1.0);
   
   // compute tangent space conversion matrix //
   // use transpose of matrix //
@@ -50,7 +66,7 @@ void main() {
                                  tangent.z, binormal.z, normal.z);
   
   // compute per vertex camera direction //
-  vec3 vertexInCamSpace = (modelview * vec4(vertex, 1.0)).xyz;
+  vec3 vertexInCamSpace = (modelview * vec4(position, 1.0)).xyz;
   
   // vector from vertex to camera and from vertex to light //
   eyeDir = World2TangentSpace * -vertexInCamSpace;
@@ -1,5 +1,7 @@
 #include "CameraController.h"
 
+#include <algorithm>
+
 CameraController::CameraController(float theta, float phi, float dist) {
   reset(theta, phi, dist);
 }
@@ -152,3 +154,9 @@ float CameraController::getAspect(void) {
 glm::vec3 CameraController::getCameraPosition(void) {
   return mCameraPosition;
 }
+
+float CameraController::getPixelsPerUnit(float distance, float viewportHeight) {
+  // the opening angle is vertical and in degrees, like glm::perspective expects it //
+  float viewHeight = 2.0f * std::max(distance, mNear) * tan(glm::radians(mOpenAngle) * 0.5f);
+  return viewportHeight / viewHeight;
+}
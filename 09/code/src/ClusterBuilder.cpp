@@ -0,0 +1,229 @@
+#include "ClusterBuilder.h"
+
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+static const unsigned int NO_TRIANGLE = 0xFFFFFFFF;
+// clusters whose normals spread further than this (cosine to the mean normal) get no cone //
+static const float MIN_CONE_COSINE = 0.1f;
+
+ClusterBuilder::ClusterBuilder() {
+  mMaxVertices = MAX_CLUSTER_VERTICES;
+  mMaxTriangles = MAX_CLUSTER_TRIANGLES;
+  mPositions = NULL;
+}
+
+void ClusterBuilder::setLimits(unsigned int maxVertices, unsigned int maxTriangles) {
+  mMaxVertices = std::max(maxVertices, 3u);
+  mMaxTriangles = std::max(maxTriangles, 1u);
+}
+
+glm::vec3 ClusterBuilder::getPosition(GLuint vertex) const {
+  const GLfloat *position = &(*mPositions)[3 * vertex];
+  return glm::vec3(position[0], position[1], position[2]);
+}
+
+void ClusterBuilder::build(MeshData &meshData) {
+  meshData.clusters.clear();
+  const size_t fullIndexCount = meshData.lods.empty() ? meshData.indices.size() : meshData.lods[0].indexCount;
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  if (fullIndexCount < 3) {
+    return;
+  }
+  mPositions = &meshData.vertex_position;
+
+  // triangles per vertex of the full mesh //
+  mAdjacencyOffset.assign(vertexCount + 1, 0);
+  for (size_t i = 0; i < fullIndexCount; ++i) {
+    ++mAdjacencyOffset[meshData.indices[i] + 1];
+  }
+  for (size_t v = 0; v < vertexCount; ++v) {
+    mAdjacencyOffset[v + 1] += mAdjacencyOffset[v];
+  }
+  mAdjacency.resize(fullIndexCount);
+  mFillCount.assign(vertexCount, 0);
+  for (size_t i = 0; i < fullIndexCount; ++i) {
+    GLuint v = meshData.indices[i];
+    mAdjacency[mAdjacencyOffset[v] + mFillCount[v]++] = i / 3;
+  }
+  mTriangleUsed.assign(fullIndexCount / 3, 0);
+  mVertexCluster.assign(vertexCount, 0);
+
+  // clusters never cross groups -> the group ranges stay valid //
+  std::vector<GLuint> orderedIndices;
+  orderedIndices.reserve(fullIndexCount);
+  if (meshData.groups.empty()) {
+    buildRange(meshData, &meshData.indices[0], fullIndexCount, 0, orderedIndices, meshData.clusters);
+  } else {
+    for (size_t g = 0; g < meshData.groups.size(); ++g) {
+      const MeshGroup &group = meshData.groups[g];
+      buildRange(meshData, &meshData.indices[group.firstIndex], group.indexCount, group.firstIndex, orderedIndices, meshData.clusters);
+    }
+  }
+  std::copy(orderedIndices.begin(), orderedIndices.end(), meshData.indices.begin());
+}
+
+void ClusterBuilder::buildRange(const MeshData &meshData, const GLuint *indices, size_t indexCount, GLuint firstIndex,
+                                std::vector<GLuint> &orderedIndices, std::vector<MeshCluster> &clusters) {
+  const unsigned int firstTriangle = firstIndex / 3;
+  const unsigned int endTriangle = firstTriangle + indexCount / 3;
+  const GLuint *allIndices = indices - firstIndex;
+  unsigned int scanTriangle = firstTriangle;
+  mClusterVertices.clear();
+
+  while (true) {
+    // the next cluster starts next to the last one, otherwise at the first free triangle //
+    unsigned int seed = NO_TRIANGLE;
+    for (size_t i = 0; i < mClusterVertices.size() && seed == NO_TRIANGLE; ++i) {
+      GLuint v = mClusterVertices[i];
+      for (unsigned int a = mAdjacencyOffset[v]; a < mAdjacencyOffset[v + 1]; ++a) {
+        unsigned int t = mAdjacency[a];
+        if (t >= firstTriangle && t < endTriangle && !mTriangleUsed[t]) {
+          seed = t;
+          break;
+        }
+      }
+    }
+    if (seed == NO_TRIANGLE) {
+      while (scanTriangle < endTriangle && mTriangleUsed[scanTriangle]) {
+        ++scanTriangle;
+      }
+      if (scanTriangle == endTriangle) {
+        break;
+      }
+      seed = scanTriangle;
+    }
+
+    // cluster ids start at 1 -> 0 marks vertices of no cluster yet //
+    const unsigned int clusterId = clusters.size() + 1;
+    mClusterVertices.clear();
+    mClusterTriangles.clear();
+    glm::vec3 positionSum(0.0f);
+    unsigned int triangle = seed;
+    while (triangle != NO_TRIANGLE) {
+      // add the triangle //
+      mTriangleUsed[triangle] = 1;
+      mClusterTriangles.push_back(triangle);
+      for (unsigned int k = 0; k < 3; ++k) {
+        GLuint v = allIndices[3 * triangle + k];
+        if (mVertexCluster[v] != clusterId) {
+          mVertexCluster[v] = clusterId;
+          mClusterVertices.push_back(v);
+          positionSum += getPosition(v);
+        }
+      }
+      if (mClusterTriangles.size() >= mMaxTriangles) {
+        break;
+      }
+
+      // the free neighbour adding the fewest vertices, the one closest to the cluster's center among them //
+      glm::vec3 center = positionSum / (float)mClusterVertices.size();
+      triangle = NO_TRIANGLE;
+      unsigned int newVertexCount = 4;
+      float bestDistance = FLT_MAX;
+      for (size_t i = 0; i < mClusterVertices.size(); ++i) {
+        GLuint v = mClusterVertices[i];
+        for (unsigned int a = mAdjacencyOffset[v]; a < mAdjacencyOffset[v + 1]; ++a) {
+          unsigned int t = mAdjacency[a];
+          if (t < firstTriangle || t >= endTriangle || mTriangleUsed[t]) {
+            continue;
+          }
+          const GLuint *corners = &allIndices[3 * t];
+          unsigned int newVertices = (mVertexCluster[corners[0]] != clusterId) + (mVertexCluster[corners[1]] != clusterId) +
+                                     (mVertexCluster[corners[2]] != clusterId);
+          if (newVertices > newVertexCount) {
+            continue;
+          }
+          glm::vec3 offset = (getPosition(corners[0]) + getPosition(corners[1]) + getPosition(corners[2])) / 3.0f - center;
+          float distance = glm::dot(offset, offset);
+          if (newVertices < newVertexCount || distance < bestDistance) {
+            triangle = t;
+            newVertexCount = newVertices;
+            bestDistance = distance;
+          }
+        }
+      }
+      if (triangle != NO_TRIANGLE && mClusterVertices.size() + newVertexCount > mMaxVertices) {
+        // even the best neighbour does not fit //
+        triangle = NO_TRIANGLE;
+      }
+    }
+
+    MeshCluster cluster;
+    // the groups cover the full mesh in order -> the ordered indices so far end at this cluster //
+    cluster.firstIndex = orderedIndices.size();
+    for (size_t i = 0; i < mClusterTriangles.size(); ++i) {
+      const GLuint *corners = &allIndices[3 * mClusterTriangles[i]];
+      orderedIndices.insert(orderedIndices.end(), corners, corners + 3);
+    }
+    cluster.indexCount = 3 * mClusterTriangles.size();
+    computeBounds(meshData, &orderedIndices[cluster.firstIndex], cluster.indexCount, cluster);
+    clusters.push_back(cluster);
+  }
+}
+
+void ClusterBuilder::computeBounds(const MeshData &meshData, const GLuint *indices, size_t indexCount, MeshCluster &cluster) {
+  const std::vector<GLfloat> &positions = meshData.vertex_position;
+  // sphere around the center of the bounding box //
+  glm::vec3 boundsMin(0.0f);
+  glm::vec3 boundsMax(0.0f);
+  for (size_t i = 0; i < indexCount; ++i) {
+    glm::vec3 position(positions[3 * indices[i]], positions[3 * indices[i] + 1], positions[3 * indices[i] + 2]);
+    boundsMin = (i == 0) ? position : glm::min(boundsMin, position);
+    boundsMax = (i == 0) ? position : glm::max(boundsMax, position);
+  }
+  glm::vec3 center = 0.5f * (boundsMin + boundsMax);
+  float radius = 0.0f;
+  for (size_t i = 0; i < indexCount; ++i) {
+    glm::vec3 position(positions[3 * indices[i]], positions[3 * indices[i] + 1], positions[3 * indices[i] + 2]);
+    radius = std::max(radius, glm::length(position - center));
+  }
+
+  // cone around the mean triangle normal //
+  std::vector<glm::vec3> normals(indexCount / 3);
+  glm::vec3 normalSum(0.0f);
+  for (size_t t = 0; t < indexCount / 3; ++t) {
+    glm::vec3 p[3];
+    for (unsigned int k = 0; k < 3; ++k) {
+      const GLfloat *position = &positions[3 * indices[3 * t + k]];
+      p[k] = glm::vec3(position[0], position[1], position[2]);
+    }
+    glm::vec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+    float length = glm::length(normal);
+    normals[t] = (length > 0.0f) ? normal / length : glm::vec3(0.0f);
+    normalSum += normals[t];
+  }
+  float axisLength = glm::length(normalSum);
+  glm::vec3 axis = (axisLength > 0.0f) ? normalSum / axisLength : glm::vec3(0.0f, 0.0f, 1.0f);
+  float minDot = (axisLength > 0.0f) ? 1.0f : -1.0f;
+  for (size_t t = 0; t < normals.size(); ++t) {
+    if (normals[t] != glm::vec3(0.0f)) {
+      minDot = std::min(minDot, glm::dot(normals[t], axis));
+    }
+  }
+  glm::vec3 apex = center;
+  float cutoff = 1.0f;
+  if (minDot > MIN_CONE_COSINE) {
+    // the apex lies on the axis behind every triangle plane -> cameras within the cone see only back faces //
+    float maxOffset = 0.0f;
+    for (size_t t = 0; t < normals.size(); ++t) {
+      if (normals[t] == glm::vec3(0.0f)) {
+        continue;
+      }
+      const GLfloat *position = &positions[3 * indices[3 * t]];
+      float planeDistance = glm::dot(center - glm::vec3(position[0], position[1], position[2]), normals[t]);
+      maxOffset = std::max(maxOffset, planeDistance / glm::dot(axis, normals[t]));
+    }
+    apex = center - axis * maxOffset;
+    cutoff = std::sqrt(1.0f - minDot * minDot);
+  }
+
+  for (unsigned int k = 0; k < 3; ++k) {
+    cluster.center[k] = center[k];
+    cluster.coneApex[k] = apex[k];
+    cluster.coneAxis[k] = axis[k];
+  }
+  cluster.radius = radius;
+  cluster.coneCutoff = cutoff;
+}
@@ -0,0 +1,58 @@
+#include "ClusterCuller.h"
+
+#include <glm/gtc/matrix_inverse.hpp>
+
+ClusterCuller::ClusterCuller() {
+  mFrustumCulled = 0;
+  mBackfaceCulled = 0;
+}
+
+GLuint ClusterCuller::cull(const MeshObj &meshObj, const glm::mat4 &modelview, const glm::mat4 &projection) {
+  mVisibleClusters.clear();
+  mFrustumCulled = 0;
+  mBackfaceCulled = 0;
+
+  // planes of the clip space volume in object space (Gribb / Hartmann) //
+  glm::mat4 clip = projection * modelview;
+  glm::vec4 rows[4];
+  for (unsigned int i = 0; i < 4; ++i) {
+    rows[i] = glm::vec4(clip[0][i], clip[1][i], clip[2][i], clip[3][i]);
+  }
+  for (unsigned int i = 0; i < 3; ++i) {
+    mPlanes[2 * i] = rows[3] + rows[i];
+    mPlanes[2 * i + 1] = rows[3] - rows[i];
+  }
+  for (unsigned int p = 0; p < 6; ++p) {
+    float length = glm::length(glm::vec3(mPlanes[p]));
+    if (length > 0.0f) {
+      mPlanes[p] /= length;
+    }
+  }
+  // camera position in object space //
+  glm::vec3 eye = glm::vec3(glm::inverse(modelview) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+  for (GLuint c = 0; c < meshObj.getClusterCount(); ++c) {
+    const MeshCluster &cluster = meshObj.getCluster(c);
+    glm::vec3 center(cluster.center[0], cluster.center[1], cluster.center[2]);
+    bool inside = true;
+    for (unsigned int p = 0; p < 6 && inside; ++p) {
+      inside = glm::dot(glm::vec3(mPlanes[p]), center) + mPlanes[p].w >= -cluster.radius;
+    }
+    if (!inside) {
+      ++mFrustumCulled;
+      continue;
+    }
+    // cameras within the cone behind the apex only see the back faces of the cluster //
+    if (cluster.coneCutoff < 1.0f) {
+      glm::vec3 apexOffset = glm::vec3(cluster.coneApex[0], cluster.coneApex[1], cluster.coneApex[2]) - eye;
+      float distance = glm::length(apexOffset);
+      glm::vec3 axis(cluster.coneAxis[0], cluster.coneAxis[1], cluster.coneAxis[2]);
+      if (glm::dot(apexOffset, axis) >= cluster.coneCutoff * distance) {
+        ++mBackfaceCulled;
+        continue;
+      }
+    }
+    mVisibleClusters.push_back(c);
+  }
+  return mVisibleClusters.size();
+}
@@ -15,6 +15,12 @@
 #include <cmath>
 
 #include "ObjLoader.h"
+#include "ClusterCuller.h"
+#include "InstanceBuffer.h"
+#include "RenderQueue.h"
+#include "ShaderProgram.h"
+#include "GLStateCache.h"
+#include "UniformBuffer.h"
 #include "CameraController.h"
 
 #include <sstream>
@@ -37,19 +43,19 @@ GLuint loadShaderFile(const char* fileName, GLenum shaderType);
 // the used shader program //
 GLuint shaderProgram = 0;
 GLuint shaderPass[2] = {0, 0};
-// this map stores uniform locations of our shader program //
-std::map<std::string, GLint> uniformLocations;
-
-// this struct helps to keep light source parameter uniforms together //
-struct UniformLocation_Light {
-	GLint ambient_color;
-	GLint diffuse_color;
-	GLint specular_color;
-	GLint power;
-	GLint position;
+// active uniforms of the program that is set up, resolved once after linking //
+ShaderProgram shader;
+
+// this struct stores uniform locations of our shader programs -> no lookups while rendering //
+struct UniformLocations {
+	GLint projection;
+	GLint view;
+	// second pass of the deferred shading //
+	GLint projection_p1;
+	GLint modelview_p1;
+	GLint view_p1;
 };
-// this map stores the light source uniform locations as 'UniformLocation_Light' structs //
-std::map<std::string, UniformLocation_Light> uniformLocations_Lights;
+UniformLocations uniformLocations;
 
 // these structs are also used in the shader code  //
 // this helps to access the parameters more easily //
@@ -77,6 +83,45 @@ std::vector<Material> materials;
 unsigned int lightCount;
 std::vector<LightSource> lights;
 
+// #INFO# lights and materials are std140 uniform blocks (see the shaders), shared by all programs //
+// the blocks are only written when a light is toggled / moved or another material is chosen, the
+// UniformBuffer then uploads just the changed bytes -> nothing is sent for static lighting
+const unsigned int maxLightCount = 10;
+const unsigned int maxMaterialCount = 8;
+enum UniformBlockBinding {
+	BINDING_LIGHTS = 0,
+	BINDING_MATERIALS
+};
+// std140 -> every vec3 starts at a multiple of 16 bytes, a following float fills the gap //
+struct LightBlockEntry {
+	glm::vec3 ambient_color;
+	GLfloat padding0;
+	glm::vec3 diffuse_color;
+	GLfloat padding1;
+	glm::vec3 specular_color;
+	GLfloat padding2;
+	glm::vec3 position;
+	GLfloat power;
+};
+struct MaterialBlockEntry {
+	glm::vec3 ambient_color;
+	GLfloat padding0;
+	glm::vec3 diffuse_color;
+	GLfloat padding1;
+	glm::vec3 specular_color;
+	GLfloat specular_shininess;
+};
+static_assert(sizeof(LightBlockEntry) == 64, "LightBlockEntry does not match the std140 layout");
+static_assert(sizeof(MaterialBlockEntry) == 48, "MaterialBlockEntry does not match the std140 layout");
+// the counters / indices follow the arrays //
+const size_t usedLightCountOffset = maxLightCount * sizeof(LightBlockEntry);
+const size_t materialIndexOffset = maxMaterialCount * sizeof(MaterialBlockEntry);
+UniformBuffer lightBlock;
+UniformBuffer materialBlock;
+// set whenever a light is toggled or moved / another material is selected //
+bool lightsChanged = true;
+bool materialChanged = true;
+
 // #INFO# Container for texture data //
 struct Texture {
 	Texture() : isInitialized(false), data(NULL), width(0), height(0), glTextureLocation(0), uniformLocation(-1), uniformEnabledLocation(-1) {};
@@ -122,6 +167,51 @@ void renderScene();
 
 // OBJ import //
 ObjLoader objLoader;
+// distant objects are drawn with simplified levels of detail ('l' toggles) //
+bool useLods = true;
+// full detail copies only draw their clusters facing the camera within the view ('c' toggles) //
+bool useClusterCulling = true;
+ClusterCuller clusterCuller;
+// the remaining copies are grouped by level of detail, one instanced draw per level ('i' toggles) //
+bool useInstancing = true;
+InstanceBuffer instanceBuffer;
+// model matrices of the instanced copies, per level of detail and in upload order //
+std::vector<std::vector<glm::mat4> > lodInstances;
+std::vector<glm::mat4> instanceModels;
+// nearest copy per level of detail -> sort depth of the instanced draws //
+std::vector<float> lodNearestDepth;
+
+// #INFO# the copies are collected as draw items and drawn from the render queue //
+// sorted by program, textures, material, mesh and level of detail, near items first within the same
+// state -> the state only changes between groups and the depth test rejects hidden fragments early
+struct DrawItem {
+	MeshObj *mesh;
+	GLuint lod;
+	glm::mat4 model;
+	// > 0 -> one instanced draw of the matrices [firstInstance, firstInstance + instanceCount) of instanceBuffer //
+	GLuint instanceCount;
+	GLuint firstInstance;
+	// culled full detail copy -> draws the range [firstCluster, firstCluster + clusterCount) of queuedClusters //
+	bool useClusters;
+	GLuint firstCluster;
+	GLuint clusterCount;
+};
+std::vector<DrawItem> drawItems;
+std::vector<GLuint> queuedClusters;
+RenderQueue renderQueue;
+// ids of the programs and texture sets in the sort keys //
+enum RenderProgram {
+	RENDER_PROGRAM_FORWARD = 0,
+	RENDER_PROGRAM_GEOMETRY
+};
+enum RenderTextureSet {
+	TEXTURE_SET_FORWARD = 0,
+	TEXTURE_SET_GEOMETRY
+};
+// meshes get their id for the sort keys when they are drawn first //
+std::map<MeshObj*, GLuint> meshIds;
+// frames since the last report of the GLStateCache counters ('p' prints them) //
+unsigned int stateCounterFrames = 0;
 // local meshes //
 MeshObj *screenQuad = NULL;
 
@@ -211,17 +301,7 @@ int main (int argc, char **argv) {
 
 void initGL() {
 	glClearColor(0.0, 0.0, 0.0, 0.0);
-	glEnable(GL_DEPTH_TEST);
-}
-
-std::string getUniformStructLocStr(const std::string &structName, const std::string &memberName, int arrayIndex = -1) {
-	std::stringstream sstr("");
-	sstr << structName;
-	if (arrayIndex >= 0) {
-		sstr << "[" << arrayIndex << "]";
-	}
-	sstr << "." << memberName;
-	return sstr.str();
+	GLStateCache::enable(GL_DEPTH_TEST);
 }
 
 bool loadShaderCode(const char* vertProgramCode, GLuint &vertProgram, const char* fragmentProgramCode, GLuint &fragProgram) {
@@ -280,12 +360,12 @@ GLuint createShader(const char* vertexProgramCode, const char* fragmentProgramCo
 	GLuint vertexShader = 0;
 	GLuint fragmentShader = 0;
 	if (!loadShaderCode(vertexProgramCode, vertexShader, fragmentProgramCode, fragmentShader)) {
-		glDeleteProgram(program);
+		GLStateCache::deleteProgram(program);
 		return 0;
 	}
 
 	if (!attachAndLink(program, vertexShader, fragmentShader)) {
-		glDeleteProgram(program);
+		GLStateCache::deleteProgram(program);
 		return 0;
 	}
 
@@ -298,7 +378,7 @@ inline void printTexLoc(std::string texID) {
 
 void initShader() {
 	if (!useDeferredShading) {
-		shaderProgram = createShader("../shader/normal_mapping.vert", "../shader/normal_mapping.frag");
+		shaderProgram = createShader("../shader/normal_mapping_instanced.vert", "../shader/normal_mapping.frag");
 		// check if operation failed //
 		if (shaderProgram == 0) {
 			std::cout << "(initShader) - Failed creating shader program." << std::endl;
@@ -309,39 +389,22 @@ void initShader() {
 		glBindFragDataLocation(shaderProgram, 0, "color");
 
 		// get uniform locations for common variables //
-		uniformLocations["projection"] = glGetUniformLocation(shaderProgram, "projection");
-		uniformLocations["modelview"] = glGetUniformLocation(shaderProgram, "modelview");
-		uniformLocations["view"] = glGetUniformLocation(shaderProgram, "view");
-
-		// material unform locations //
-		uniformLocations["material.ambient"] = glGetUniformLocation(shaderProgram, "material.ambient_color");
-		uniformLocations["material.diffuse"] = glGetUniformLocation(shaderProgram, "material.diffuse_color");
-		uniformLocations["material.specular"] = glGetUniformLocation(shaderProgram, "material.specular_color");
-		uniformLocations["material.shininess"] = glGetUniformLocation(shaderProgram, "material.specular_shininess");
-
-		// store the uniform locations for all light source properties
-		for (int i = 0; i < 10; ++i) {
-			UniformLocation_Light lightLocation;
-			lightLocation.ambient_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "ambient_color", i).c_str());
-			lightLocation.diffuse_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "diffuse_color", i).c_str());
-			lightLocation.specular_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "specular_color", i).c_str());
-			lightLocation.power = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "power", i).c_str());
-			lightLocation.position = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "position", i).c_str());
-
-			std::stringstream sstr("");
-			sstr << "light_" << i;
-			uniformLocations_Lights[sstr.str()] = lightLocation;
-		}
-		uniformLocations["usedLightCount"] = glGetUniformLocation(shaderProgram, "usedLightCount");
+		shader.setProgram(shaderProgram);
+		uniformLocations.projection = shader.getUniformLocation("projection");
+		uniformLocations.view = shader.getUniformLocation("view");
+
+		// light sources and materials come from the uniform buffers //
+		shader.bindUniformBlock("Lights", BINDING_LIGHTS);
+		shader.bindUniformBlock("Materials", BINDING_MATERIALS);
 
 		// assign uniform locations to existing texture objects //
-		textures["diffuse"].uniformLocation = glGetUniformLocation(shaderProgram, "diffuseTexture");
-		textures["normal"].uniformLocation = glGetUniformLocation(shaderProgram, "normalMap");
+		textures["diffuse"].uniformLocation = shader.getUniformLocation("diffuseTexture");
+		textures["normal"].uniformLocation = shader.getUniformLocation("normalMap");
 	} else {
 		// #INFO# load two shader programs and initialize uniform locations //
 
 		// first pass //
-		shaderPass[0] = createShader("../shader/deferred_pass1.vert", "../shader/deferred_pass1.frag");
+		shaderPass[0] = createShader("../shader/deferred_pass1_instanced.vert", "../shader/deferred_pass1.frag");
 		// check if operation failed //
 		if (shaderPass[0] == 0) {
 			std::cout << "(initShader) - Failed creating shader program 1." << std::endl;
@@ -363,70 +426,42 @@ void initShader() {
 		glBindFragDataLocation(shaderPass[1], 0, "color");
 
 		// get uniform locations for each shader //
-		glUseProgram(shaderPass[0]);
+		GLStateCache::useProgram(shaderPass[0]);
+		shader.setProgram(shaderPass[0]);
 		// pass 0 - vertex //
-		uniformLocations["projection"] = glGetUniformLocation(shaderPass[0], "projection");
-		uniformLocations["modelview"] = glGetUniformLocation(shaderPass[0], "modelview");
+		uniformLocations.projection = shader.getUniformLocation("projection");
+		uniformLocations.view = shader.getUniformLocation("view");
 		// pass 0 - fragment //
-		textures["normal"].uniformLocation = glGetUniformLocation(shaderPass[0], "normalMap");
+		textures["normal"].uniformLocation = shader.getUniformLocation("normalMap");
 
 		// pass 1 - vertex //
-		glUseProgram(shaderPass[1]);
-		uniformLocations["projection_p1"] = glGetUniformLocation(shaderPass[1], "projection");
-		uniformLocations["modelview_p1"] = glGetUniformLocation(shaderPass[1], "modelview");
+		GLStateCache::useProgram(shaderPass[1]);
+		shader.setProgram(shaderPass[1]);
+		uniformLocations.projection_p1 = shader.getUniformLocation("projection");
+		uniformLocations.modelview_p1 = shader.getUniformLocation("modelview");
 		// #INFO# additional matrix -> modelview for light positions //
-		uniformLocations["view_p1"] = glGetUniformLocation(shaderPass[1], "view");
-
-		for (int i = 0; i < 10; ++i) {
-			UniformLocation_Light lightLocation;
-			lightLocation.ambient_color = glGetUniformLocation(shaderPass[1], getUniformStructLocStr("lightSource", "ambient_color", i).c_str());
-			lightLocation.diffuse_color = glGetUniformLocation(shaderPass[1], getUniformStructLocStr("lightSource", "diffuse_color", i).c_str());
-			lightLocation.specular_color = glGetUniformLocation(shaderPass[1], getUniformStructLocStr("lightSource", "specular_color", i).c_str());
-			lightLocation.power = glGetUniformLocation(shaderPass[1], getUniformStructLocStr("lightSource", "power", i).c_str());
-			lightLocation.position = glGetUniformLocation(shaderPass[1], getUniformStructLocStr("lightSource", "position", i).c_str());
-
-			std::stringstream sstr("");
-			sstr << "light_" << i;
-			uniformLocations_Lights[sstr.str()] = lightLocation;
-		}
-		uniformLocations["usedLightCount"] = glGetUniformLocation(shaderPass[1], "usedLightCount");;
+		uniformLocations.view_p1 = shader.getUniformLocation("view");
+
 		// pass 1 - fragment //
-		textures["diffuse"].uniformLocation = glGetUniformLocation(shaderPass[1], "diffuseTexture");
+		textures["diffuse"].uniformLocation = shader.getUniformLocation("diffuseTexture");
 		printTexLoc("diffuse");
 
-		uniformLocations["material.ambient"] = glGetUniformLocation(shaderPass[1], "material.ambient_color");
-		uniformLocations["material.diffuse"] = glGetUniformLocation(shaderPass[1], "material.diffuse_color");
-		uniformLocations["material.specular"] = glGetUniformLocation(shaderPass[1], "material.specular_color");
-		uniformLocations["material.shininess"] = glGetUniformLocation(shaderPass[1], "material.specular_shininess");
-
-		// store the uniform locations for all light source properties
-		for (int i = 0; i < 10; ++i) {
-			UniformLocation_Light lightLocation;
-			lightLocation.ambient_color = glGetUniformLocation(shaderPass[1], getUniformStructLocStr("lightSource", "ambient_color", i).c_str());
-			lightLocation.diffuse_color = glGetUniformLocation(shaderPass[1], getUniformStructLocStr("lightSource", "diffuse_color", i).c_str());
-			lightLocation.specular_color = glGetUniformLocation(shaderPass[1], getUniformStructLocStr("lightSource", "specular_color", i).c_str());
-			lightLocation.power = glGetUniformLocation(shaderPass[1], getUniformStructLocStr("lightSource", "power", i).c_str());
-			lightLocation.position = glGetUniformLocation(shaderPass[1], getUniformStructLocStr("lightSource", "position", i).c_str());
-
-			std::stringstream sstr("");
-			sstr << "light_" << i;
-			uniformLocations_Lights[sstr.str()] = lightLocation;
-		}
-		uniformLocations["usedLightCount"] = glGetUniformLocation(shaderPass[1], "usedLightCount");
+		shader.bindUniformBlock("Lights", BINDING_LIGHTS);
+		shader.bindUniformBlock("Materials", BINDING_MATERIALS);
 	}
 }
 
 bool enableShader(int pass) {
 	if (!useDeferredShading) {
 		if (shaderProgram > 0) {
-			glUseProgram(shaderProgram);
+			GLStateCache::useProgram(shaderProgram);
 		} else {
 			std::cout << "(enableShader) - Shader program not initialized." << std::endl;
 		}
 		return shaderProgram > 0;
 	} else {
 		if (shaderPass[pass]) {
-			glUseProgram(shaderPass[pass]);
+			GLStateCache::useProgram(shaderPass[pass]);
 		} else {
 			std::cout << "(enableShader) - Shader program not initialized." << std::endl;
 		}
@@ -435,19 +470,19 @@ bool enableShader(int pass) {
 }
 
 void disableShader() {
-	glUseProgram(0);
+	GLStateCache::useProgram(0);
 }
 
 void deleteShader() {
 	// use standard pipeline //
-	glUseProgram(0);
+	GLStateCache::useProgram(0);
 	// delete shader program //
 	if (!useDeferredShading) {
-		glDeleteProgram(shaderProgram);
+		GLStateCache::deleteProgram(shaderProgram);
 		shaderProgram = 0;
 	} else {
 		for (int i = 0; i < 2; ++i) {
-			glDeleteProgram(shaderPass[i]);
+			GLStateCache::deleteProgram(shaderPass[i]);
 			shaderPass[i] = 0;
 		}
 	}
@@ -518,7 +553,7 @@ void createEmptyTexture(std::string texID, unsigned int width, unsigned int heig
 	glGenTextures( 1, &texture.glTextureLocation);
 
 	// TODO?: bind the texture and set wrapping and filtering parameters (use GL_NEAREST for filtering) //
-	glBindTexture(GL_TEXTURE_2D, texture.glTextureLocation);
+	GLStateCache::bindTexture(0, GL_TEXTURE_2D, texture.glTextureLocation);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
@@ -537,7 +572,7 @@ void createTextureFromFile(std::string texID, std::string fileName) {
 		// texture has been successfully loaded //
 		glGenTextures(1, &texture.glTextureLocation);
 
-		glBindTexture(GL_TEXTURE_2D, texture.glTextureLocation);
+		GLStateCache::bindTexture(0, GL_TEXTURE_2D, texture.glTextureLocation);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -583,8 +618,14 @@ void initTextures (void) {
 void initScene() {
 	camera.setFar(1000.0f);
 
-	// load scene.obj from disk and create renderable MeshObj //
-	objLoader.loadObjFile("../meshes/head.obj", "sceneObject");
+	// quantized vertices -> 20 instead of 56 bytes per vertex, the shaders dequantize them //
+	objLoader.setVertexFormat(VERTEX_FORMAT_COMPACT);
+	// split the meshes into clusters for culling //
+	objLoader.setClusterBuildingEnabled(true);
+
+	// load scene.obj in the background, the (empty) MeshObj can be rendered right away //
+	// and gets its geometry with the first frame after the import has finished
+	objLoader.loadObjFileAsync("../meshes/head.obj", "sceneObject");
 
 	// init materials //
 	Material mat;
@@ -616,13 +657,27 @@ void initScene() {
 
 	// save light source count for later and select first light source //
 	lightCount = lights.size();
+
+	// buffers of the uniform blocks, filled by the first setupLightAndMaterial() //
+	lightBlock.create(usedLightCountOffset + 16, BINDING_LIGHTS);
+	materialBlock.create(materialIndexOffset + 16, BINDING_MATERIALS);
+	for (unsigned int i = 0; i < materialCount && i < maxMaterialCount; ++i) {
+		MaterialBlockEntry entry = {};
+		entry.ambient_color = materials[i].ambient_color;
+		entry.diffuse_color = materials[i].diffuse_color;
+		entry.specular_color = materials[i].specular_color;
+		entry.specular_shininess = materials[i].specular_shininess;
+		materialBlock.write(i * sizeof(MaterialBlockEntry), &entry, sizeof(entry));
+	}
+	lightsChanged = true;
+	materialChanged = true;
 }
 
 // TODO?: initialize your FBO here //
 void initFBO() {
 	// TODO? :generate FBO and depthBuffer //
 	glGenFramebuffers(1, &fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLStateCache::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	// TODO?: generate texture objects to hold the data //
 	createEmptyTexture("def_vertexMap", windowWidth, windowHeight);
@@ -630,9 +685,11 @@ void initFBO() {
 	createEmptyTexture("def_texCoordMap", windowWidth, windowHeight);
 
 	// TODO?: get uniforms locations in shader (pass 0) //
-	textures["def_vertexMap"].uniformLocation = glGetUniformLocation(shaderPass[1], "def_vertexMap");
-	textures["def_normalMap"].uniformLocation = glGetUniformLocation(shaderPass[1], "def_normalMap");
-	textures["def_texCoordMap"].uniformLocation = glGetUniformLocation(shaderPass[1], "def_texCoordMap");
+	// (they are sampled by the second pass)
+	shader.setProgram(shaderPass[1]);
+	textures["def_vertexMap"].uniformLocation = shader.getUniformLocation("def_vertexMap");
+	textures["def_normalMap"].uniformLocation = shader.getUniformLocation("def_normalMap");
+	textures["def_texCoordMap"].uniformLocation = shader.getUniformLocation("def_texCoordMap");
 
 	// TODO?: attach textures to FBO for output VERTEX, NORMAL, TEXCOORD //
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures["def_vertexMap"].glTextureLocation, 0);
@@ -648,34 +705,44 @@ void initFBO() {
 	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rb);
 
 	// TODO?: unbind FBO until it's needed //
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+}
 
+// selects an entry of the material table, uploads nothing if it already is the selected one //
+void selectMaterial(GLuint index) {
+	GLint blockIndex = index;
+	materialBlock.write(materialIndexOffset, &blockIndex, sizeof(blockIndex));
+	materialBlock.upload();
 }
 
-// #INFO# uploads light and material to current shader //
+// #INFO# updates the light and material uniform blocks, nothing happens while they are unchanged //
 void setupLightAndMaterial() {
-	// uploads the properties of the currently active light sources here //
-	int shaderLightIdx = 0;
-	for (unsigned int i = 0; i < lightCount; ++i) {
-		if (lights[i].enabled) {
-			std::stringstream sstr("");
-			sstr << "light_" << shaderLightIdx;
-			UniformLocation_Light &light = uniformLocations_Lights[sstr.str()];
-			glUniform3fv(light.position, 1, glm::value_ptr(lights[i].position));
-			glUniform3fv(light.ambient_color, 1, glm::value_ptr(lights[i].ambient_color));
-			glUniform3fv(light.diffuse_color, 1, glm::value_ptr(lights[i].diffuse_color));
-			glUniform3fv(light.specular_color, 1, glm::value_ptr(lights[i].specular_color));
-			glUniform1f(light.power, lights[i].power);
-			++shaderLightIdx;
+	if (lightsChanged) {
+		// the enabled light sources are packed to the front of the array //
+		GLint shaderLightIdx = 0;
+		for (unsigned int i = 0; i < lightCount && shaderLightIdx < (GLint)maxLightCount; ++i) {
+			if (lights[i].enabled) {
+				LightBlockEntry entry = {};
+				entry.ambient_color = lights[i].ambient_color;
+				entry.diffuse_color = lights[i].diffuse_color;
+				entry.specular_color = lights[i].specular_color;
+				entry.position = lights[i].position;
+				entry.power = lights[i].power;
+				// entries equal to the uploaded ones are not sent again //
+				lightBlock.write(shaderLightIdx * sizeof(LightBlockEntry), &entry, sizeof(entry));
+				++shaderLightIdx;
+			}
 		}
+		lightBlock.write(usedLightCountOffset, &shaderLightIdx, sizeof(shaderLightIdx));
+		lightBlock.upload();
+		lightsChanged = false;
 	}
-	glUniform1i(uniformLocations["usedLightCount"], shaderLightIdx);
 
-	// uploads the chosen material properties here //
-	glUniform3fv(uniformLocations["material.ambient"], 1, glm::value_ptr(materials[materialIndex].ambient_color));
-	glUniform3fv(uniformLocations["material.diffuse"], 1, glm::value_ptr(materials[materialIndex].diffuse_color));
-	glUniform3fv(uniformLocations["material.specular"], 1, glm::value_ptr(materials[materialIndex].specular_color));
-	glUniform1f(uniformLocations["material.shininess"], materials[materialIndex].specular_shininess);
+	if (materialChanged) {
+		selectMaterial(materialIndex);
+		materialChanged = false;
+	}
 }
 
 // #INFO# creates a screen filling quad as a new MeshObj (stored in screenQuad) //
@@ -722,114 +789,239 @@ void initScreenFillingQuad(void) {
 	screenQuad->setData(mesh);
 }
 
+// coarsest level of detail of 'mesh' at 'modelview' with at most one pixel of error on screen //
+GLuint selectLod(MeshObj *mesh, const glm::mat4 &modelview, float scale) {
+	if (!useLods) return 0;
+	glm::vec3 boundsMin, boundsMax;
+	mesh->getBounds(boundsMin, boundsMax);
+	glm::vec3 center = glm::vec3(modelview * glm::vec4(0.5f * (boundsMin + boundsMax), 1.0f));
+	float radius = 0.5f * scale * glm::length(boundsMax - boundsMin);
+	// the closest point of the bounding sphere decides //
+	float distance = glm::length(center) - radius;
+	return mesh->selectLod(scale * camera.getPixelsPerUnit(distance, windowHeight));
+}
+
+// id of 'mesh' in the sort keys, the level of detail fills the lowest bits -> equal levels are drawn together //
+GLuint getMeshKey(MeshObj *mesh, GLuint lod) {
+	std::map<MeshObj*, GLuint>::iterator id = meshIds.find(mesh);
+	if (id == meshIds.end()) {
+		id = meshIds.insert(std::make_pair(mesh, (GLuint)meshIds.size())).first;
+	}
+	return (id->second << 4) | std::min(lod, 15u);
+}
+
+// adds 'item' to the render queue, 'depth' is its view space distance //
+void submitDrawItem(const DrawItem &item, GLuint program, GLuint textureSet, float depth) {
+	GLuint quantizedDepth = RenderQueue::quantizeDepth(depth, camera.getNear(), camera.getFar());
+	renderQueue.submit(RenderQueue::makeOpaqueKey(0, program, textureSet, materialIndex, getMeshKey(item.mesh, item.lod), quantizedDepth), drawItems.size());
+	drawItems.push_back(item);
+}
+
+// queues 'mesh' at 'model', culls the clusters of full detail copies //
+// with instancing enabled the other copies are only collected in 'lodInstances'
+void renderMesh(MeshObj *mesh, const glm::mat4 &model, float scale, GLuint program, GLuint textureSet) {
+	const glm::mat4 modelview = glm_ModelViewMatrix.top() * model;
+	const float depth = -modelview[3].z;
+	GLuint lod = selectLod(mesh, modelview, scale);
+	if (useInstancing && !(lod == 0 && useClusterCulling && mesh->getClusterCount() > 0)) {
+		lodInstances[lod].push_back(model);
+		lodNearestDepth[lod] = std::min(lodNearestDepth[lod], depth);
+		return;
+	}
+	DrawItem item;
+	item.mesh = mesh;
+	item.lod = lod;
+	item.model = model;
+	item.instanceCount = 0;
+	item.firstInstance = 0;
+	item.useClusters = false;
+	item.firstCluster = 0;
+	item.clusterCount = 0;
+	if (lod == 0 && useClusterCulling && mesh->getClusterCount() > 0) {
+		clusterCuller.cull(*mesh, modelview, glm_ProjectionMatrix.top());
+		const std::vector<GLuint> &visibleClusters = clusterCuller.getVisibleClusters();
+		if (visibleClusters.empty()) {
+			return;
+		}
+		item.useClusters = true;
+		item.firstCluster = queuedClusters.size();
+		item.clusterCount = visibleClusters.size();
+		queuedClusters.insert(queuedClusters.end(), visibleClusters.begin(), visibleClusters.end());
+	}
+	submitDrawItem(item, program, textureSet, depth);
+}
+
+// binds the program of a sort key //
+void bindRenderProgram(GLuint program) {
+	GLStateCache::useProgram(program == RENDER_PROGRAM_FORWARD ? shaderProgram : shaderPass[0]);
+}
+
+// binds the textures of a sort key to their units //
+void bindTextureSet(GLuint textureSet) {
+	if (textureSet == TEXTURE_SET_FORWARD) {
+		GLStateCache::bindTexture(0, GL_TEXTURE_2D, textures["diffuse"].glTextureLocation);
+		GLStateCache::bindTexture(1, GL_TEXTURE_2D, textures["normal"].glTextureLocation);
+	} else {
+		GLStateCache::bindTexture(0, GL_TEXTURE_2D, textures["normal"].glTextureLocation);
+	}
+}
+
+// #INFO# sorts the queued draw items and draws them, empties the queue //
+// program, textures and material are only changed where the sorted keys change
+void executeRenderQueue() {
+	renderQueue.sort();
+	GLuint program = ~0u;
+	GLuint textureSet = ~0u;
+	GLuint material = ~0u;
+	for (GLuint i = 0; i < renderQueue.getItemCount(); ++i) {
+		const uint64_t key = renderQueue.getKey(i);
+		if (RenderQueue::getProgram(key) != program) {
+			program = RenderQueue::getProgram(key);
+			bindRenderProgram(program);
+		}
+		if (RenderQueue::getTextureSet(key) != textureSet) {
+			textureSet = RenderQueue::getTextureSet(key);
+			bindTextureSet(textureSet);
+		}
+		if (RenderQueue::getMaterial(key) != material) {
+			material = RenderQueue::getMaterial(key);
+			selectMaterial(material);
+		}
+
+		const DrawItem &item = drawItems[renderQueue.getIndex(i)];
+		if (item.instanceCount > 0) {
+			item.mesh->renderInstanced(item.instanceCount, instanceBuffer.getBuffer(), item.lod, item.firstInstance);
+			continue;
+		}
+		MeshObj::setInstanceTransform(item.model);
+		if (item.useClusters) {
+			item.mesh->renderClusters(&queuedClusters[item.firstCluster], item.clusterCount);
+		} else {
+			item.mesh->renderLod(item.lod);
+		}
+	}
+	renderQueue.clear();
+	drawItems.clear();
+	queuedClusters.clear();
+}
+
+// renders the grid of copies of 'mesh' -> 441 draw calls without instancing, one per used level of detail with it //
+// (plus the culled full detail copies), expects the view matrix on top of glm_ModelViewMatrix and the uniforms of 'program'
+void renderCopies(MeshObj *mesh, GLuint program, GLuint textureSet) {
+	// NULL while the mesh could not be imported //
+	if (mesh == NULL) {
+		return;
+	}
+	lodInstances.resize(mesh->getLodCount());
+	lodNearestDepth.assign(mesh->getLodCount(), camera.getFar());
+	for (GLuint lod = 0; lod < lodInstances.size(); ++lod) {
+		lodInstances[lod].clear();
+	}
+	for (int y = -10; y < 11; ++y) {
+		for (int x = -10; x < 11; ++x) {
+			// queue the actual object, far away copies with less triangles //
+			renderMesh(mesh, glm::translate(glm::vec3(x, 0, y)) * glm::scale(glm::vec3(2)), 2.0f, program, textureSet);
+		}
+	}
+
+	if (useInstancing) {
+		// all levels share one buffer -> a single upload per frame //
+		instanceModels.clear();
+		for (GLuint lod = 0; lod < lodInstances.size(); ++lod) {
+			instanceModels.insert(instanceModels.end(), lodInstances[lod].begin(), lodInstances[lod].end());
+		}
+		instanceBuffer.update(instanceModels);
+		GLuint firstInstance = 0;
+		for (GLuint lod = 0; lod < lodInstances.size(); ++lod) {
+			if (!lodInstances[lod].empty()) {
+				DrawItem item;
+				item.mesh = mesh;
+				item.lod = lod;
+				item.instanceCount = lodInstances[lod].size();
+				item.firstInstance = firstInstance;
+				item.useClusters = false;
+				item.firstCluster = 0;
+				item.clusterCount = 0;
+				// the nearest copy decides -> levels closer to the camera are drawn first //
+				submitDrawItem(item, program, textureSet, lodNearestDepth[lod]);
+			}
+			firstInstance += lodInstances[lod].size();
+		}
+	}
+	executeRenderQueue();
+}
+
 // TODO?: complete the code of the deferred shading  pipeline //
 void renderScene() {
 	if (!useDeferredShading) {
-		glUseProgram(shaderProgram);
+		GLStateCache::useProgram(shaderProgram);
 		// upload view matrix //
-		glUniformMatrix4fv(uniformLocations["view"], 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+		glUniformMatrix4fv(uniformLocations.view, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
 		// setup light and material in shader //
 		setupLightAndMaterial();
 
-		// upload textures to individual texture units //
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, textures["diffuse"].glTextureLocation);
+		// texture units of the texture set, bound by the render queue //
 		glUniform1i(textures["diffuse"].uniformLocation, 0);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, textures["normal"].glTextureLocation);
 		glUniform1i(textures["normal"].uniformLocation, 1);
 
-		for (int y = -10; y < 11; ++y) {
-			for (int x = -10; x < 11; ++x) {
-				glm_ModelViewMatrix.push(glm_ModelViewMatrix.top());
-				glm_ModelViewMatrix.top() *= glm::translate(glm::vec3(x, 0, y));
-				glm_ModelViewMatrix.top() *= glm::scale(glm::vec3(2));
-
-				glUniformMatrix4fv(uniformLocations["modelview"], 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
-
-				// render the actual object //
-				MeshObj *mesh = objLoader.getMeshObj("sceneObject");
-				mesh->render();
-
-				// restore scene graph to previous state //
-				glm_ModelViewMatrix.pop();
-			}
-		}
+		renderCopies(objLoader.getMeshObj("sceneObject"), RENDER_PROGRAM_FORWARD, TEXTURE_SET_FORWARD);
 	} else {
 		// TODO?: pass 0 -> render scene to FBO //
 		// - enable pass 0 shader   //
 		// - bind FBO render target //
 		// - render without lights  //
 
-		glUseProgram(shaderPass[0]);
+		GLStateCache::useProgram(shaderPass[0]);
 		// TODO?: bind FBO for off screen rendering //
-		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		GLStateCache::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 		// TODO?: select correct draw buffers //
 		GLenum buffers[3] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
 		glDrawBuffers(3, buffers);
 
-		// upload normal textures //
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, textures["normal"].glTextureLocation);
+		// upload view matrix, the shader builds the modelview matrix per copy //
+		glUniformMatrix4fv(uniformLocations.view, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+
+		// normal texture unit, bound by the render queue //
 		glUniform1i(textures["normal"].uniformLocation, 0);
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		// place and render model geometry //
-		for (int y = -10; y < 11; ++y) {
-			for (int x = -10; x < 11; ++x) {
-				glm_ModelViewMatrix.push(glm_ModelViewMatrix.top());
-				glm_ModelViewMatrix.top() *= glm::translate(glm::vec3(x, 0, y));
-				glm_ModelViewMatrix.top() *= glm::scale(glm::vec3(2));
-
-				glUniformMatrix4fv(uniformLocations["modelview"], 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
-
-				// render the actual object //
-				MeshObj *mesh = objLoader.getMeshObj("sceneObject");
-				mesh->render();
-
-				// restore scene graph to previous state //
-				glm_ModelViewMatrix.pop();
-			}
-		}
+		renderCopies(objLoader.getMeshObj("sceneObject"), RENDER_PROGRAM_GEOMETRY, TEXTURE_SET_GEOMETRY);
 
 		// TODO?: pass 1 : -> render quad to screen //
 		// - enable pass 1 shader            //
-		glUseProgram(shaderPass[1]);
+		GLStateCache::useProgram(shaderPass[1]);
 		// - bind standard frame buffer -> 0 //
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLStateCache::bindFramebuffer(GL_FRAMEBUFFER, 0);
 
 		// create simple projection and view matrices //
 		glm::mat4 pass1_proj = glm::ortho(0.0f, 1.0f, 0.0f, 1.0f);
 		glm::mat4 pass1_modelview = glm::mat4(1);
 
 		// upload transformation matrices matrix //
-		glUniformMatrix4fv(uniformLocations["projection_p1"], 1, false, glm::value_ptr(pass1_proj));
-		glUniformMatrix4fv(uniformLocations["modelview_p1"], 1, false, glm::value_ptr(pass1_modelview));
+		glUniformMatrix4fv(uniformLocations.projection_p1, 1, false, glm::value_ptr(pass1_proj));
+		glUniformMatrix4fv(uniformLocations.modelview_p1, 1, false, glm::value_ptr(pass1_modelview));
 		// TODO?: upload the light modelview transformation as 'view' //
-		glUniformMatrix4fv(uniformLocations["view_p1"], 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+		glUniformMatrix4fv(uniformLocations.view_p1, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
 
 		// setup light and material in shader //
 		setupLightAndMaterial();
 
 		// upload diffuse texture //
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, textures["diffuse"].glTextureLocation);
+		GLStateCache::bindTexture(0, GL_TEXTURE_2D, textures["diffuse"].glTextureLocation);
 		glUniform1i(textures["diffuse"].uniformLocation, 0);
 
 		// TODO?: upload textures created in previous render pass //
 
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, textures["def_vertexMap"].glTextureLocation);
+		GLStateCache::bindTexture(1, GL_TEXTURE_2D, textures["def_vertexMap"].glTextureLocation);
 		glUniform1i(textures["def_vertexMap"].uniformLocation, 1);
 
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_2D, textures["def_normalMap"].glTextureLocation);
+		GLStateCache::bindTexture(2, GL_TEXTURE_2D, textures["def_normalMap"].glTextureLocation);
 		glUniform1i(textures["def_normalMap"].uniformLocation, 2);
 
-		glActiveTexture(GL_TEXTURE3);
-		glBindTexture(GL_TEXTURE_2D, textures["def_texCoordMap"].glTextureLocation);
+		GLStateCache::bindTexture(3, GL_TEXTURE_2D, textures["def_texCoordMap"].glTextureLocation);
 		glUniform1i(textures["def_texCoordMap"].uniformLocation, 3);
 
 		// render screen filling quad //
@@ -839,6 +1031,9 @@ void renderScene() {
 }
 
 void updateGL() {
+	// upload meshes whose background import finished since the last frame //
+	objLoader.processFinishedImports();
+
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	// set viewport dimensions //
@@ -847,7 +1042,7 @@ void updateGL() {
 	// get projection mat from camera controller //
 	glm_ProjectionMatrix.top() = camera.getProjectionMat();
 	// upload projection matrix //
-	glUniformMatrix4fv(uniformLocations["projection"], 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
+	glUniformMatrix4fv(uniformLocations.projection, 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
 
 	// init scene graph by cloning the top entry, which can now be manipulated //
 	// get modelview mat from camera controller //
@@ -855,6 +1050,7 @@ void updateGL() {
 
 	// render scene //
 	renderScene();
+	++stateCounterFrames;
 
 	// swap renderbuffers for smooth rendering //
 	glutSwapBuffers();
@@ -868,6 +1064,7 @@ void idle() {
 void toggleLightSource(unsigned int i) {
 	if (i < lightCount) {
 		lights[i].enabled = !lights[i].enabled;
+		lightsChanged = true;
 	}
 }
 
@@ -922,9 +1119,32 @@ void keyboardEvent(unsigned char key, int x, int y) {
 				  camera.setFar(std::max(camera.getFar() - 0.1f, camera.getNear() + 0.01f));
 				  break;
 			  }
+		case 'l': {
+				  useLods = !useLods;
+				  break;
+			  }
+		case 'c': {
+				  useClusterCulling = !useClusterCulling;
+				  break;
+			  }
+		case 'i': {
+				  useInstancing = !useInstancing;
+				  break;
+			  }
+		case 'p': {
+				  // state changes per frame since the last report //
+				  if (stateCounterFrames > 0) {
+					  std::cout << "(GLStateCache) - per frame: " << GLStateCache::getIssuedCount() / stateCounterFrames << " calls sent, "
+					            << GLStateCache::getElidedCount() / stateCounterFrames << " skipped" << std::endl;
+				  }
+				  GLStateCache::resetCounters();
+				  stateCounterFrames = 0;
+				  break;
+			  }
 		case 'm': {
 				  materialIndex++;
 				  if (materialIndex >= materialCount) materialIndex = 0;
+				  materialChanged = true;
 				  break;
 			  }
 		case '0':
@@ -0,0 +1,372 @@
+#include "GLStateCache.h"
+
+#include <cstring>
+
+// marks a value as unknown -> no valid name or enum of the cached state //
+static const GLuint UNKNOWN = 0xFFFFFFFFu;
+static const GLuint MAX_TEXTURE_UNITS = 16;
+// the minimum of GL_MAX_VERTEX_ATTRIBS //
+static const GLuint MAX_VERTEX_ATTRIBS = 16;
+
+enum TextureTarget {
+  TEXTURE_TARGET_2D = 0,
+  TEXTURE_TARGET_CUBE_MAP,
+  TEXTURE_TARGET_3D,
+  TEXTURE_TARGET_2D_ARRAY,
+  TEXTURE_TARGET_COUNT
+};
+
+enum Capability {
+  CAPABILITY_DEPTH_TEST = 0,
+  CAPABILITY_STENCIL_TEST,
+  CAPABILITY_BLEND,
+  CAPABILITY_CULL_FACE,
+  CAPABILITY_SCISSOR_TEST,
+  CAPABILITY_POLYGON_OFFSET_FILL,
+  CAPABILITY_COUNT
+};
+
+struct CachedState {
+  GLuint program;
+  GLuint vertexArray;
+  GLuint drawFramebuffer;
+  GLuint readFramebuffer;
+  GLuint activeUnit;
+  GLuint textures[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+  // UNKNOWN, GL_FALSE or GL_TRUE //
+  GLuint capabilities[CAPABILITY_COUNT];
+  GLuint depthMask;
+  GLuint depthFunc;
+  // UNKNOWN or one bit per channel //
+  GLuint colorMask;
+  GLuint blendSource;
+  GLuint blendDestination;
+  GLuint cullFace;
+  GLuint stencilFunc;
+  GLint stencilReference;
+  GLuint stencilFuncMask;
+  GLuint stencilFail;
+  GLuint stencilDepthFail;
+  GLuint stencilDepthPass;
+  GLuint stencilWriteMask;
+  // the write mask may be any value -> an extra flag //
+  bool stencilWriteMaskKnown;
+  GLfloat vertexAttribs[MAX_VERTEX_ATTRIBS][4];
+  bool vertexAttribKnown[MAX_VERTEX_ATTRIBS];
+
+  unsigned long issued;
+  unsigned long elided;
+};
+
+static CachedState state;
+static bool stateInitialized = false;
+
+static CachedState& getState(void) {
+  if (!stateInitialized) {
+    GLStateCache::invalidate();
+  }
+  return state;
+}
+
+// counts the call and tells whether it has to be sent //
+static bool changes(GLuint &cached, GLuint value) {
+  if (cached == value) {
+    ++state.elided;
+    return false;
+  }
+  cached = value;
+  ++state.issued;
+  return true;
+}
+
+static int getTextureTarget(GLenum target) {
+  switch (target) {
+    case GL_TEXTURE_2D: return TEXTURE_TARGET_2D;
+    case GL_TEXTURE_CUBE_MAP: return TEXTURE_TARGET_CUBE_MAP;
+    case GL_TEXTURE_3D: return TEXTURE_TARGET_3D;
+    case GL_TEXTURE_2D_ARRAY: return TEXTURE_TARGET_2D_ARRAY;
+    default: return -1;
+  }
+}
+
+static int getCapability(GLenum capability) {
+  switch (capability) {
+    case GL_DEPTH_TEST: return CAPABILITY_DEPTH_TEST;
+    case GL_STENCIL_TEST: return CAPABILITY_STENCIL_TEST;
+    case GL_BLEND: return CAPABILITY_BLEND;
+    case GL_CULL_FACE: return CAPABILITY_CULL_FACE;
+    case GL_SCISSOR_TEST: return CAPABILITY_SCISSOR_TEST;
+    case GL_POLYGON_OFFSET_FILL: return CAPABILITY_POLYGON_OFFSET_FILL;
+    default: return -1;
+  }
+}
+
+static void setCapability(GLenum capability, GLuint enabled) {
+  CachedState &cache = getState();
+  int index = getCapability(capability);
+  if (index >= 0 && !changes(cache.capabilities[index], enabled)) {
+    return;
+  }
+  if (index < 0) {
+    ++cache.issued;
+  }
+  if (enabled == GL_TRUE) {
+    glEnable(capability);
+  } else {
+    glDisable(capability);
+  }
+}
+
+void GLStateCache::useProgram(GLuint program) {
+  if (changes(getState().program, program)) {
+    glUseProgram(program);
+  }
+}
+
+void GLStateCache::bindVertexArray(GLuint vertexArray) {
+  if (changes(getState().vertexArray, vertexArray)) {
+    glBindVertexArray(vertexArray);
+  }
+}
+
+void GLStateCache::bindFramebuffer(GLenum target, GLuint framebuffer) {
+  CachedState &cache = getState();
+  if (target == GL_FRAMEBUFFER) {
+    if (cache.drawFramebuffer == framebuffer && cache.readFramebuffer == framebuffer) {
+      ++cache.elided;
+      return;
+    }
+    cache.drawFramebuffer = cache.readFramebuffer = framebuffer;
+    ++cache.issued;
+    glBindFramebuffer(target, framebuffer);
+    return;
+  }
+  if (changes(target == GL_READ_FRAMEBUFFER ? cache.readFramebuffer : cache.drawFramebuffer, framebuffer)) {
+    glBindFramebuffer(target, framebuffer);
+  }
+}
+
+void GLStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+  CachedState &cache = getState();
+  // the unit is activated in any case -> following glTex* calls use this texture //
+  if (changes(cache.activeUnit, unit)) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+  }
+  int index = getTextureTarget(target);
+  if (unit < MAX_TEXTURE_UNITS && index >= 0) {
+    if (!changes(cache.textures[unit][index], texture)) {
+      return;
+    }
+  } else {
+    ++cache.issued;
+  }
+  glBindTexture(target, texture);
+}
+
+void GLStateCache::enable(GLenum capability) {
+  setCapability(capability, GL_TRUE);
+}
+
+void GLStateCache::disable(GLenum capability) {
+  setCapability(capability, GL_FALSE);
+}
+
+void GLStateCache::depthMask(GLboolean flag) {
+  if (changes(getState().depthMask, flag ? GL_TRUE : GL_FALSE)) {
+    glDepthMask(flag);
+  }
+}
+
+void GLStateCache::depthFunc(GLenum func) {
+  if (changes(getState().depthFunc, func)) {
+    glDepthFunc(func);
+  }
+}
+
+void GLStateCache::colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
+  GLuint mask = (red ? 1u : 0u) | (green ? 2u : 0u) | (blue ? 4u : 0u) | (alpha ? 8u : 0u);
+  if (changes(getState().colorMask, mask)) {
+    glColorMask(red, green, blue, alpha);
+  }
+}
+
+void GLStateCache::blendFunc(GLenum sourceFactor, GLenum destinationFactor) {
+  CachedState &cache = getState();
+  if (cache.blendSource == sourceFactor && cache.blendDestination == destinationFactor) {
+    ++cache.elided;
+    return;
+  }
+  cache.blendSource = sourceFactor;
+  cache.blendDestination = destinationFactor;
+  ++cache.issued;
+  glBlendFunc(sourceFactor, destinationFactor);
+}
+
+void GLStateCache::cullFace(GLenum mode) {
+  if (changes(getState().cullFace, mode)) {
+    glCullFace(mode);
+  }
+}
+
+void GLStateCache::stencilFunc(GLenum func, GLint reference, GLuint mask) {
+  CachedState &cache = getState();
+  if (cache.stencilFunc == func && cache.stencilReference == reference && cache.stencilFuncMask == mask) {
+    ++cache.elided;
+    return;
+  }
+  cache.stencilFunc = func;
+  cache.stencilReference = reference;
+  cache.stencilFuncMask = mask;
+  ++cache.issued;
+  glStencilFunc(func, reference, mask);
+}
+
+void GLStateCache::stencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass) {
+  CachedState &cache = getState();
+  if (cache.stencilFail == stencilFail && cache.stencilDepthFail == depthFail && cache.stencilDepthPass == depthPass) {
+    ++cache.elided;
+    return;
+  }
+  cache.stencilFail = stencilFail;
+  cache.stencilDepthFail = depthFail;
+  cache.stencilDepthPass = depthPass;
+  ++cache.issued;
+  glStencilOp(stencilFail, depthFail, depthPass);
+}
+
+void GLStateCache::stencilMask(GLuint mask) {
+  CachedState &cache = getState();
+  if (cache.stencilWriteMaskKnown && cache.stencilWriteMask == mask) {
+    ++cache.elided;
+    return;
+  }
+  cache.stencilWriteMask = mask;
+  cache.stencilWriteMaskKnown = true;
+  ++cache.issued;
+  glStencilMask(mask);
+}
+
+static void setVertexAttrib(GLuint index, const GLfloat value[4]) {
+  CachedState &cache = getState();
+  if (index < MAX_VERTEX_ATTRIBS) {
+    if (cache.vertexAttribKnown[index] && std::memcmp(cache.vertexAttribs[index], value, 4 * sizeof(GLfloat)) == 0) {
+      ++cache.elided;
+      return;
+    }
+    std::memcpy(cache.vertexAttribs[index], value, 4 * sizeof(GLfloat));
+    cache.vertexAttribKnown[index] = true;
+  }
+  ++cache.issued;
+  glVertexAttrib4fv(index, value);
+}
+
+void GLStateCache::vertexAttrib3fv(GLuint index, const GLfloat *value) {
+  const GLfloat vector[4] = {value[0], value[1], value[2], 1.0f};
+  setVertexAttrib(index, vector);
+}
+
+void GLStateCache::vertexAttrib4fv(GLuint index, const GLfloat *value) {
+  setVertexAttrib(index, value);
+}
+
+void GLStateCache::invalidateVertexAttrib(GLuint index) {
+  if (index < MAX_VERTEX_ATTRIBS) {
+    getState().vertexAttribKnown[index] = false;
+  }
+}
+
+void GLStateCache::deleteProgram(GLuint program) {
+  CachedState &cache = getState();
+  // a program in use is deleted when it is replaced -> the next useProgram() has to reach the GL //
+  if (cache.program == program) {
+    cache.program = UNKNOWN;
+  }
+  glDeleteProgram(program);
+}
+
+void GLStateCache::deleteVertexArrays(GLsizei count, const GLuint *vertexArrays) {
+  CachedState &cache = getState();
+  for (GLsizei i = 0; i < count; ++i) {
+    if (vertexArrays[i] != 0 && cache.vertexArray == vertexArrays[i]) {
+      cache.vertexArray = 0;
+    }
+  }
+  glDeleteVertexArrays(count, vertexArrays);
+}
+
+void GLStateCache::deleteFramebuffers(GLsizei count, const GLuint *framebuffers) {
+  CachedState &cache = getState();
+  for (GLsizei i = 0; i < count; ++i) {
+    if (framebuffers[i] == 0) {
+      continue;
+    }
+    if (cache.drawFramebuffer == framebuffers[i]) {
+      cache.drawFramebuffer = 0;
+    }
+    if (cache.readFramebuffer == framebuffers[i]) {
+      cache.readFramebuffer = 0;
+    }
+  }
+  glDeleteFramebuffers(count, framebuffers);
+}
+
+void GLStateCache::deleteTextures(GLsizei count, const GLuint *textures) {
+  CachedState &cache = getState();
+  for (GLsizei i = 0; i < count; ++i) {
+    if (textures[i] == 0) {
+      continue;
+    }
+    for (GLuint unit = 0; unit < MAX_TEXTURE_UNITS; ++unit) {
+      for (GLuint target = 0; target < TEXTURE_TARGET_COUNT; ++target) {
+        if (cache.textures[unit][target] == textures[i]) {
+          cache.textures[unit][target] = 0;
+        }
+      }
+    }
+  }
+  glDeleteTextures(count, textures);
+}
+
+void GLStateCache::invalidate(void) {
+  stateInitialized = true;
+  state.program = UNKNOWN;
+  state.vertexArray = UNKNOWN;
+  state.drawFramebuffer = UNKNOWN;
+  state.readFramebuffer = UNKNOWN;
+  state.activeUnit = UNKNOWN;
+  for (GLuint unit = 0; unit < MAX_TEXTURE_UNITS; ++unit) {
+    for (GLuint target = 0; target < TEXTURE_TARGET_COUNT; ++target) {
+      state.textures[unit][target] = UNKNOWN;
+    }
+  }
+  for (GLuint capability = 0; capability < CAPABILITY_COUNT; ++capability) {
+    state.capabilities[capability] = UNKNOWN;
+  }
+  state.depthMask = UNKNOWN;
+  state.depthFunc = UNKNOWN;
+  state.colorMask = UNKNOWN;
+  state.blendSource = UNKNOWN;
+  state.blendDestination = UNKNOWN;
+  state.cullFace = UNKNOWN;
+  state.stencilFunc = UNKNOWN;
+  state.stencilFail = UNKNOWN;
+  state.stencilDepthFail = UNKNOWN;
+  state.stencilDepthPass = UNKNOWN;
+  state.stencilWriteMaskKnown = false;
+  for (GLuint index = 0; index < MAX_VERTEX_ATTRIBS; ++index) {
+    state.vertexAttribKnown[index] = false;
+  }
+}
+
+unsigned long GLStateCache::getIssuedCount(void) {
+  return state.issued;
+}
+
+unsigned long GLStateCache::getElidedCount(void) {
+  return state.elided;
+}
+
+void GLStateCache::resetCounters(void) {
+  state.issued = 0;
+  state.elided = 0;
+}
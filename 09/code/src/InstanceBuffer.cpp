@@ -0,0 +1,31 @@
+#include "InstanceBuffer.h"
+
+#include <algorithm>
+
+InstanceBuffer::InstanceBuffer() {
+  mBuffer = 0;
+  mCapacity = 0;
+  mInstanceCount = 0;
+}
+
+InstanceBuffer::~InstanceBuffer() {
+  glDeleteBuffers(1, &mBuffer);
+}
+
+void InstanceBuffer::update(const glm::mat4 *models, GLuint count) {
+  mInstanceCount = count;
+  if (count == 0) {
+    return;
+  }
+  if (mBuffer == 0) {
+    glGenBuffers(1, &mBuffer);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+  // growing by half at least -> a slowly rising count does not reallocate every frame //
+  if (count > mCapacity) {
+    mCapacity = std::max(count, mCapacity + mCapacity / 2);
+  }
+  glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)mCapacity * sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)count * sizeof(glm::mat4), models);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,57 @@
+#include "MappedFile.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+MappedFile::MappedFile() {
+  mData = NULL;
+  mSize = 0;
+  mIsOpen = false;
+}
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+bool MappedFile::open(const std::string &fileName) {
+  close();
+
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  mSize = fileStat.st_size;
+  if (mSize > 0) {
+    void *mapping = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(fd);
+      mSize = 0;
+      return false;
+    }
+    // the file is scanned front to back -> let the kernel read ahead aggressively //
+    madvise(mapping, mSize, MADV_SEQUENTIAL);
+    mData = static_cast<const char*>(mapping);
+  }
+  // the mapping stays valid after closing the descriptor //
+  ::close(fd);
+
+  mIsOpen = true;
+  return true;
+}
+
+void MappedFile::close(void) {
+  if (mData != NULL) {
+    munmap(const_cast<char*>(mData), mSize);
+  }
+  mData = NULL;
+  mSize = 0;
+  mIsOpen = false;
+}
@@ -0,0 +1,319 @@
+#include "MeshCache.h"
+
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+static const char MESH_CACHE_MAGIC[8] = {'C', 'G', '2', 'M', 'E', 'S', 'H', '\0'};
+
+// appends 'text' with its terminating '\0' to the string data, returns its offset //
+static uint32_t appendString(std::vector<char> &stringData, const std::string &text) {
+  uint32_t offset = stringData.size();
+  stringData.insert(stringData.end(), text.begin(), text.end());
+  stringData.push_back('\0');
+  return offset;
+}
+
+MeshCache::MeshCache() {
+  mHeader = NULL;
+}
+
+MeshCache::~MeshCache() {
+  close();
+}
+
+std::string MeshCache::getCacheFileName(const std::string &sourceFile) {
+  return sourceFile + ".mcache";
+}
+
+bool MeshCache::getSourceKey(const std::string &sourceFile, MeshCacheHeader &header) {
+  struct stat sourceStat;
+  if (stat(sourceFile.c_str(), &sourceStat) != 0) {
+    return false;
+  }
+  header.sourceSize = sourceStat.st_size;
+  // nanosecond resolution -> also catches edits within the same second //
+  header.sourceMtime = (int64_t)sourceStat.st_mtim.tv_sec * 1000000000 + sourceStat.st_mtim.tv_nsec;
+
+  // hash the canonical path -> the same file is recognized from every working directory //
+  char canonicalPath[PATH_MAX];
+  const char *path = realpath(sourceFile.c_str(), canonicalPath) ? canonicalPath : sourceFile.c_str();
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char *c = path; *c != '\0'; ++c) {
+    hash ^= (unsigned char)*c;
+    hash *= 1099511628211ULL;
+  }
+  header.sourcePathHash = hash;
+  return true;
+}
+
+bool MeshCache::write(const std::string &sourceFile, const MeshData &meshData, uint64_t settingsHash) {
+  MeshCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  if (!getSourceKey(sourceFile, header)) {
+    return false;
+  }
+  memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+  header.version = MESH_CACHE_VERSION;
+  header.settingsHash = settingsHash;
+  header.vertexCount = meshData.vertex_position.size() / 3;
+  header.indexCount = meshData.indices.size();
+
+  // interleave the attribute arrays //
+  const unsigned int vertexCount = header.vertexCount;
+  const std::vector<GLfloat> *attributes[5] = {&meshData.vertex_position, &meshData.vertex_normal, &meshData.vertex_texcoord,
+                                               &meshData.vertex_tangent, &meshData.vertex_binormal};
+  const unsigned int attributeSize[5] = {3, 3, 2, 3, 3};
+  std::vector<GLfloat> vertexData(vertexCount * MESH_CACHE_VERTEX_FLOATS, 0.0f);
+  unsigned int offset = 0;
+  for (unsigned int a = 0; a < 5; ++a) {
+    const std::vector<GLfloat> &attribute = *attributes[a];
+    if (attribute.size() == vertexCount * attributeSize[a] && vertexCount > 0) {
+      header.attributeMask |= (1 << a);
+      for (unsigned int v = 0; v < vertexCount; ++v) {
+        memcpy(&vertexData[v * MESH_CACHE_VERTEX_FLOATS + offset], &attribute[v * attributeSize[a]], attributeSize[a] * sizeof(GLfloat));
+      }
+    }
+    offset += attributeSize[a];
+  }
+
+  // bounding box //
+  for (unsigned int k = 0; k < 3; ++k) {
+    header.boundsMin[k] = (vertexCount > 0) ? meshData.vertex_position[k] : 0.0f;
+    header.boundsMax[k] = header.boundsMin[k];
+  }
+  for (unsigned int v = 0; v < vertexCount; ++v) {
+    for (unsigned int k = 0; k < 3; ++k) {
+      GLfloat value = meshData.vertex_position[3 * v + k];
+      if (value < header.boundsMin[k]) header.boundsMin[k] = value;
+      if (value > header.boundsMax[k]) header.boundsMax[k] = value;
+    }
+  }
+
+  // groups and their names //
+  std::vector<char> stringData;
+  for (size_t i = 0; i < meshData.materialLibraries.size(); ++i) {
+    appendString(stringData, meshData.materialLibraries[i]);
+  }
+  std::vector<MeshCacheGroup> groups(meshData.groups.size());
+  for (size_t i = 0; i < meshData.groups.size(); ++i) {
+    const MeshGroup &group = meshData.groups[i];
+    groups[i].firstIndex = group.firstIndex;
+    groups[i].indexCount = group.indexCount;
+    memcpy(groups[i].boundsMin, group.boundsMin, sizeof(groups[i].boundsMin));
+    memcpy(groups[i].boundsMax, group.boundsMax, sizeof(groups[i].boundsMax));
+    groups[i].nameOffset = appendString(stringData, group.name);
+    groups[i].materialOffset = appendString(stringData, group.material);
+  }
+  header.groupCount = groups.size();
+  header.materialLibraryCount = meshData.materialLibraries.size();
+  header.stringDataSize = stringData.size();
+
+  std::vector<MeshCacheLod> lods(meshData.lods.size());
+  for (size_t i = 0; i < meshData.lods.size(); ++i) {
+    lods[i].firstIndex = meshData.lods[i].firstIndex;
+    lods[i].indexCount = meshData.lods[i].indexCount;
+    lods[i].error = meshData.lods[i].error;
+  }
+  header.lodCount = lods.size();
+
+  std::vector<MeshCacheCluster> clusters(meshData.clusters.size());
+  for (size_t i = 0; i < meshData.clusters.size(); ++i) {
+    const MeshCluster &cluster = meshData.clusters[i];
+    clusters[i].firstIndex = cluster.firstIndex;
+    clusters[i].indexCount = cluster.indexCount;
+    memcpy(clusters[i].center, cluster.center, sizeof(clusters[i].center));
+    clusters[i].radius = cluster.radius;
+    memcpy(clusters[i].coneApex, cluster.coneApex, sizeof(clusters[i].coneApex));
+    memcpy(clusters[i].coneAxis, cluster.coneAxis, sizeof(clusters[i].coneAxis));
+    clusters[i].coneCutoff = cluster.coneCutoff;
+  }
+  header.clusterCount = clusters.size();
+
+  // write to a temporary file first -> readers never see a partially written cache //
+  std::string cacheFile = getCacheFileName(sourceFile);
+  std::string tempFile = cacheFile + ".tmp";
+  FILE *file = fopen(tempFile.c_str(), "wb");
+  if (file == NULL) {
+    std::cout << "(MeshCache::write) - Could not create \"" << cacheFile << "\"" << std::endl;
+    return false;
+  }
+  bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+  if (vertexData.size() > 0) {
+    success = success && fwrite(&vertexData[0], sizeof(GLfloat), vertexData.size(), file) == vertexData.size();
+  }
+  if (meshData.indices.size() > 0) {
+    success = success && fwrite(&meshData.indices[0], sizeof(GLuint), meshData.indices.size(), file) == meshData.indices.size();
+  }
+  if (groups.size() > 0) {
+    success = success && fwrite(&groups[0], sizeof(MeshCacheGroup), groups.size(), file) == groups.size();
+  }
+  if (lods.size() > 0) {
+    success = success && fwrite(&lods[0], sizeof(MeshCacheLod), lods.size(), file) == lods.size();
+  }
+  if (clusters.size() > 0) {
+    success = success && fwrite(&clusters[0], sizeof(MeshCacheCluster), clusters.size(), file) == clusters.size();
+  }
+  if (stringData.size() > 0) {
+    success = success && fwrite(&stringData[0], 1, stringData.size(), file) == stringData.size();
+  }
+  success = (fclose(file) == 0) && success;
+  if (!success || rename(tempFile.c_str(), cacheFile.c_str()) != 0) {
+    std::cout << "(MeshCache::write) - Could not write \"" << cacheFile << "\"" << std::endl;
+    remove(tempFile.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool MeshCache::open(const std::string &sourceFile, uint64_t settingsHash) {
+  close();
+
+  MeshCacheHeader sourceKey;
+  if (!getSourceKey(sourceFile, sourceKey)) {
+    return false;
+  }
+  if (!mFile.open(getCacheFileName(sourceFile)) || mFile.size() < sizeof(MeshCacheHeader)) {
+    mFile.close();
+    return false;
+  }
+
+  // validate format, source file state and import settings //
+  const MeshCacheHeader *header = reinterpret_cast<const MeshCacheHeader*>(mFile.data());
+  size_t expectedSize = sizeof(MeshCacheHeader) + (size_t)header->vertexCount * MESH_CACHE_VERTEX_FLOATS * sizeof(GLfloat)
+                        + (size_t)header->indexCount * sizeof(GLuint) + (size_t)header->groupCount * sizeof(MeshCacheGroup)
+                        + (size_t)header->lodCount * sizeof(MeshCacheLod) + (size_t)header->clusterCount * sizeof(MeshCacheCluster)
+                        + header->stringDataSize;
+  if (memcmp(header->magic, MESH_CACHE_MAGIC, sizeof(header->magic)) != 0 || header->version != MESH_CACHE_VERSION ||
+      header->sourceSize != sourceKey.sourceSize || header->sourceMtime != sourceKey.sourceMtime ||
+      header->sourcePathHash != sourceKey.sourcePathHash || header->settingsHash != settingsHash || mFile.size() != expectedSize) {
+    mFile.close();
+    return false;
+  }
+  mHeader = header;
+  if (!validateData()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void MeshCache::close(void) {
+  mFile.close();
+  mHeader = NULL;
+}
+
+const GLfloat* MeshCache::getVertexData(void) const {
+  return reinterpret_cast<const GLfloat*>(mFile.data() + sizeof(MeshCacheHeader));
+}
+
+const GLuint* MeshCache::getIndexData(void) const {
+  return reinterpret_cast<const GLuint*>(getVertexData() + (size_t)mHeader->vertexCount * MESH_CACHE_VERTEX_FLOATS);
+}
+
+const MeshCacheGroup* MeshCache::getGroupData(void) const {
+  return reinterpret_cast<const MeshCacheGroup*>(getIndexData() + mHeader->indexCount);
+}
+
+const MeshCacheLod* MeshCache::getLodData(void) const {
+  return reinterpret_cast<const MeshCacheLod*>(getGroupData() + mHeader->groupCount);
+}
+
+const MeshCacheCluster* MeshCache::getClusterData(void) const {
+  return reinterpret_cast<const MeshCacheCluster*>(getLodData() + mHeader->lodCount);
+}
+
+const char* MeshCache::getStringData(void) const {
+  return reinterpret_cast<const char*>(getClusterData() + mHeader->clusterCount);
+}
+
+bool MeshCache::validateData(void) const {
+  // the indices go straight to the GPU -> every one has to address a vertex //
+  const GLuint *indices = getIndexData();
+  for (uint32_t i = 0; i < mHeader->indexCount; ++i) {
+    if (indices[i] >= mHeader->vertexCount) {
+      return false;
+    }
+  }
+  const char *strings = getStringData();
+  size_t size = mHeader->stringDataSize;
+  if (size > 0 && strings[size - 1] != '\0') {
+    return false;
+  }
+  // the material libraries are the first strings //
+  size_t offset = 0;
+  for (uint32_t i = 0; i < mHeader->materialLibraryCount; ++i) {
+    if (offset >= size) {
+      return false;
+    }
+    offset += strlen(strings + offset) + 1;
+  }
+  const MeshCacheGroup *groups = getGroupData();
+  for (uint32_t i = 0; i < mHeader->groupCount; ++i) {
+    if (groups[i].nameOffset >= size || groups[i].materialOffset >= size ||
+        (uint64_t)groups[i].firstIndex + groups[i].indexCount > mHeader->indexCount) {
+      return false;
+    }
+  }
+  const MeshCacheLod *lods = getLodData();
+  for (uint32_t i = 0; i < mHeader->lodCount; ++i) {
+    if ((uint64_t)lods[i].firstIndex + lods[i].indexCount > mHeader->indexCount) {
+      return false;
+    }
+  }
+  const MeshCacheCluster *clusters = getClusterData();
+  for (uint32_t i = 0; i < mHeader->clusterCount; ++i) {
+    if ((uint64_t)clusters[i].firstIndex + clusters[i].indexCount > mHeader->indexCount) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void MeshCache::getGroups(std::vector<MeshGroup> &groups, std::vector<std::string> &materialLibraries) const {
+  const char *strings = getStringData();
+  materialLibraries.clear();
+  size_t offset = 0;
+  for (uint32_t i = 0; i < mHeader->materialLibraryCount; ++i) {
+    materialLibraries.push_back(std::string(strings + offset));
+    offset += materialLibraries.back().size() + 1;
+  }
+  const MeshCacheGroup *cacheGroups = getGroupData();
+  groups.resize(mHeader->groupCount);
+  for (uint32_t i = 0; i < mHeader->groupCount; ++i) {
+    groups[i].name = strings + cacheGroups[i].nameOffset;
+    groups[i].material = strings + cacheGroups[i].materialOffset;
+    groups[i].firstIndex = cacheGroups[i].firstIndex;
+    groups[i].indexCount = cacheGroups[i].indexCount;
+    memcpy(groups[i].boundsMin, cacheGroups[i].boundsMin, sizeof(groups[i].boundsMin));
+    memcpy(groups[i].boundsMax, cacheGroups[i].boundsMax, sizeof(groups[i].boundsMax));
+  }
+}
+
+void MeshCache::getLods(std::vector<MeshLod> &lods) const {
+  const MeshCacheLod *cacheLods = getLodData();
+  lods.resize(mHeader->lodCount);
+  for (uint32_t i = 0; i < mHeader->lodCount; ++i) {
+    lods[i].firstIndex = cacheLods[i].firstIndex;
+    lods[i].indexCount = cacheLods[i].indexCount;
+    lods[i].error = cacheLods[i].error;
+  }
+}
+
+void MeshCache::getClusters(std::vector<MeshCluster> &clusters) const {
+  const MeshCacheCluster *cacheClusters = getClusterData();
+  clusters.resize(mHeader->clusterCount);
+  for (uint32_t i = 0; i < mHeader->clusterCount; ++i) {
+    clusters[i].firstIndex = cacheClusters[i].firstIndex;
+    clusters[i].indexCount = cacheClusters[i].indexCount;
+    memcpy(clusters[i].center, cacheClusters[i].center, sizeof(clusters[i].center));
+    clusters[i].radius = cacheClusters[i].radius;
+    memcpy(clusters[i].coneApex, cacheClusters[i].coneApex, sizeof(clusters[i].coneApex));
+    memcpy(clusters[i].coneAxis, cacheClusters[i].coneAxis, sizeof(clusters[i].coneAxis));
+    clusters[i].coneCutoff = cacheClusters[i].coneCutoff;
+  }
+}
@@ -1,154 +1,315 @@
 #include "MeshObj.h"
 #include <iostream>
+#include <cstring>
 #include <limits>
+#include <algorithm>
 
 MeshObj::MeshObj() {
   mVAO = 0;
-  mVBO_position = 0;
-  mVBO_normal = 0;
-  mVBO_texcoord = 0;
-  mVBO_tangent = 0;
-  mVBO_binormal = 0;
+  mVBO = 0;
   mIBO = 0;
   mIndexCount = 0;
+  mIndexType = GL_UNSIGNED_INT;
+  mIndexSize = sizeof(GLuint);
+  mBufferSize = 0;
+  mVertexFormat = VERTEX_FORMAT_FLOAT;
+  mAttributeArrays = 0;
+  for (unsigned int k = 0; k < 3; ++k) {
+    mPositionOffset[k] = 0.0f;
+    mPositionScale[k] = 1.0f;
+  }
+  setLods(std::vector<MeshLod>());
 }
 
 MeshObj::~MeshObj() {
   glDeleteBuffers(1, &mIBO);
-  glDeleteBuffers(1, &mVBO_position);
-  glDeleteBuffers(1, &mVBO_normal);
-  glDeleteBuffers(1, &mVBO_texcoord);
-  glDeleteBuffers(1, &mVBO_tangent);
-  glDeleteBuffers(1, &mVBO_binormal);
-  glDeleteVertexArrays(1, &mVAO);
+  glDeleteBuffers(1, &mVBO);
+  GLStateCache::deleteVertexArrays(1, &mVAO);
 }
 
 void MeshObj::setData(const MeshData &meshData) {
-  mIndexCount = meshData.indices.size();
-  
-  // extend this method to upload tangent and binormal as VBOs //
-  // - tangents are at location 3 within the shader code
-  // - binormals are at location 4 within the shader code
-  
-  // create local storage arrays for vertices, normals and indices //
-  unsigned int vertexDataSize = meshData.vertex_position.size();
-  unsigned int vertexNormalSize = meshData.vertex_normal.size();
-  unsigned int vertexTexcoordSize = meshData.vertex_texcoord.size();
-  unsigned int vertexTangentSize = meshData.vertex_tangent.size();
-  unsigned int vertexBinormalSize = meshData.vertex_binormal.size();
-  
-  GLfloat *vertex_position = new GLfloat[vertexDataSize]();
-  std::copy(meshData.vertex_position.begin(), meshData.vertex_position.end(), vertex_position);
-  GLfloat *vertex_normal = NULL;
-  if (vertexNormalSize > 0) {
-    vertex_normal = new GLfloat[vertexNormalSize]();
-    std::copy(meshData.vertex_normal.begin(), meshData.vertex_normal.end(), vertex_normal);
-  }
-  GLfloat *vertex_texcoord = NULL;
-  if (vertexTexcoordSize > 0) {
-    vertex_texcoord = new GLfloat[vertexTexcoordSize]();
-    std::copy(meshData.vertex_texcoord.begin(), meshData.vertex_texcoord.end(), vertex_texcoord);
-  }
-  GLfloat *vertex_tangent = NULL;
-  if (vertexTangentSize > 0) {
-    vertex_tangent = new GLfloat[vertexTangentSize]();
-    std::copy(meshData.vertex_tangent.begin(), meshData.vertex_tangent.end(), vertex_tangent);
-  }
-  GLfloat *vertex_binormal = NULL;
-  if (vertexBinormalSize > 0) {
-    vertex_binormal = new GLfloat[vertexBinormalSize]();
-    std::copy(meshData.vertex_binormal.begin(), meshData.vertex_binormal.end(), vertex_binormal);
-  }
-  GLuint *indices = new GLuint[mIndexCount]();
-  std::copy(meshData.indices.begin(), meshData.indices.end(), indices);
+  if (mVertexFormat == VERTEX_FORMAT_COMPACT) {
+    setData<CompactVertexLayout>(meshData);
+  } else {
+    setData<FloatVertexLayout>(meshData);
+  }
+}
+
+VertexSource MeshObj::getVertexSource(const MeshData &meshData) {
+  VertexSource source(meshData.vertex_position.size() / 3);
+  const std::vector<GLfloat> *attributes[ATTRIB_COUNT] = {&meshData.vertex_position, &meshData.vertex_normal, &meshData.vertex_texcoord,
+                                                          &meshData.vertex_tangent, &meshData.vertex_binormal};
+  const GLuint attributeSize[ATTRIB_COUNT] = {3, 3, 2, 3, 3};
+  for (GLuint attribute = 0; attribute < ATTRIB_COUNT; ++attribute) {
+    if (source.vertexCount > 0 && attributes[attribute]->size() == source.vertexCount * attributeSize[attribute]) {
+      source.setAttribute((VertexAttribute)attribute, &(*attributes[attribute])[0], attributeSize[attribute]);
+    }
+  }
+  return source;
+}
+
+void MeshObj::setInterleavedData(const GLfloat *vertexData, GLuint vertexCount, GLuint attributeMask, const GLuint *indices, GLuint indexCount) {
+  mIndexCount = indexCount;
+  // a single level and group and no clusters until setLods() / setGroups() / setClusters() are called //
+  setLods(std::vector<MeshLod>());
+  setGroups(std::vector<MeshGroup>(), std::vector<std::string>());
+  setClusters(std::vector<MeshCluster>());
   
   // create VAO //
   if (mVAO == 0) {
     glGenVertexArrays(1, &mVAO);
   }
-  glBindVertexArray(mVAO);
-  
-  // create and bind VBOs and upload data (one VBO per available vertex attribute -> position, normal) //
-  if (mVBO_position == 0) {
-    glGenBuffers(1, &mVBO_position);
-  }
-  glBindBuffer(GL_ARRAY_BUFFER, mVBO_position);
-  glBufferData(GL_ARRAY_BUFFER, vertexDataSize * sizeof(GLfloat), &vertex_position[0], GL_STATIC_DRAW);
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-  glEnableVertexAttribArray(0);
+  GLStateCache::bindVertexArray(mVAO);
   
-  if (vertexNormalSize > 0) {
-    if (mVBO_normal == 0) {
-      glGenBuffers(1, &mVBO_normal);
+  if (mVertexFormat == VERTEX_FORMAT_COMPACT) {
+    // component count of the attributes in interleaved order //
+    const GLuint attributeSize[ATTRIB_COUNT] = {3, 3, 2, 3, 3};
+    VertexSource source(vertexCount);
+    GLuint offset = 0;
+    for (GLuint attribute = 0; attribute < ATTRIB_COUNT; ++attribute) {
+      if (attributeMask & (1 << attribute)) {
+        source.setAttribute((VertexAttribute)attribute, vertexData + offset, 14);
+      }
+      offset += attributeSize[attribute];
     }
-    glBindBuffer(GL_ARRAY_BUFFER, mVBO_normal);
-    glBufferData(GL_ARRAY_BUFFER, vertexNormalSize * sizeof(GLfloat), &vertex_normal[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-    glEnableVertexAttribArray(1);
+    uploadVertices<CompactVertexLayout>(source);
+  } else {
+    // the data already is in FloatVertexLayout (missing attributes are zero) -> copied directly from the given memory //
+    static_assert(sizeof(FloatVertexLayout::Vertex) == 14 * sizeof(GLfloat), "FloatVertexLayout has to match the interleaved data");
+    const GLsizei stride = sizeof(FloatVertexLayout::Vertex);
+    const GLsizeiptr size = (GLsizeiptr)vertexCount * stride;
+    void *mapped;
+    do {
+      mapped = mapVertexBuffer(size);
+      if (mapped != NULL) {
+        std::memcpy(mapped, vertexData, size);
+      }
+    } while (!unmapBuffer(GL_ARRAY_BUFFER, mapped));
+    FloatVertexLayout::setupAttributes(stride);
+    mAttributeArrays = FloatVertexLayout::ATTRIBUTE_ARRAYS;
+    setPositionDequantization(false, VertexSource(vertexCount));
   }
   
-  if (vertexTexcoordSize > 0) {
-    if (mVBO_texcoord == 0) {
-      glGenBuffers(1, &mVBO_texcoord);
+  // init and bind a IBO //
+  uploadIndices(indices, vertexCount);
+  
+  // unbind buffers //
+  GLStateCache::bindVertexArray(0);
+}
+
+void* MeshObj::mapVertexBuffer(GLsizeiptr size) {
+  void *mapped = mapBuffer(GL_ARRAY_BUFFER, mVBO, size);
+  // the layout enables its own attributes -> others (the binormal of compact vertices) read the constants set by render() //
+  for (GLuint attribute = 0; attribute < ATTRIB_COUNT; ++attribute) {
+    glDisableVertexAttribArray(attribute);
+  }
+  mBufferSize = size;
+  return mapped;
+}
+
+void* MeshObj::mapBuffer(GLenum target, GLuint &buffer, GLsizeiptr size) {
+  if (GLEW_ARB_buffer_storage) {
+    // immutable storage can not be respecified -> a new buffer for every upload //
+    glDeleteBuffers(1, &buffer);
+    buffer = 0;
+  }
+  if (buffer == 0) {
+    glGenBuffers(1, &buffer);
+  }
+  glBindBuffer(target, buffer);
+  if (GLEW_ARB_buffer_storage && size > 0) {
+    // written once through the mapping, never read back or changed -> the driver may place it in video memory //
+    glBufferStorage(target, size, NULL, GL_MAP_WRITE_BIT);
+  } else {
+    glBufferData(target, size, NULL, GL_STATIC_DRAW);
+  }
+  if (size == 0) {
+    return NULL;
+  }
+  void *mapped = glMapBufferRange(target, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  if (mapped == NULL) {
+    std::cout << "(MeshObj::mapBuffer) - ERROR: Could not map " << size << " bytes" << std::endl;
+  }
+  return mapped;
+}
+
+bool MeshObj::unmapBuffer(GLenum target, void *mapped) {
+  return mapped == NULL || glUnmapBuffer(target) == GL_TRUE;
+}
+
+void MeshObj::setPositionDequantization(bool quantized, const VertexSource &source) {
+  for (unsigned int k = 0; k < 3; ++k) {
+    mPositionOffset[k] = quantized ? source.positionMin[k] : 0.0f;
+    mPositionScale[k] = quantized ? source.positionExtent[k] : 1.0f;
+  }
+}
+
+void MeshObj::uploadIndices(const GLuint *indices, GLuint vertexCount) {
+  // expects the VAO to be bound -> the new index buffer is bound to it //
+  // every index fits into 16 bits -> half the index memory, the indices are narrowed while they are written
+  const bool shortIndices = vertexCount <= 65536;
+  mIndexType = shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+  mIndexSize = shortIndices ? sizeof(GLushort) : sizeof(GLuint);
+  void *mapped;
+  do {
+    mapped = mapBuffer(GL_ELEMENT_ARRAY_BUFFER, mIBO, (GLsizeiptr)mIndexCount * mIndexSize);
+    if (mapped != NULL && shortIndices) {
+      std::copy(indices, indices + mIndexCount, static_cast<GLushort*>(mapped));
+    } else if (mapped != NULL) {
+      std::memcpy(mapped, indices, (size_t)mIndexCount * mIndexSize);
     }
-    glBindBuffer(GL_ARRAY_BUFFER, mVBO_texcoord);
-    glBufferData(GL_ARRAY_BUFFER, vertexTexcoordSize * sizeof(GLfloat), &vertex_texcoord[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
-    glEnableVertexAttribArray(2);
+  } while (!unmapBuffer(GL_ELEMENT_ARRAY_BUFFER, mapped));
+  mBufferSize += mIndexCount * mIndexSize;
+}
+
+void MeshObj::setLods(const std::vector<MeshLod> &lods) {
+  mLods = lods;
+  if (mLods.empty()) {
+    MeshLod lod;
+    lod.firstIndex = 0;
+    lod.indexCount = mIndexCount;
+    lod.error = 0.0f;
+    mLods.push_back(lod);
   }
-  
-  if (vertexTangentSize > 0) {
-    if (mVBO_tangent == 0) {
-      glGenBuffers(1, &mVBO_tangent);
+}
+
+void MeshObj::setGroups(const std::vector<MeshGroup> &groups, const std::vector<std::string> &materialLibraries) {
+  mGroups = groups;
+  mMaterialLibraries = materialLibraries;
+  if (mGroups.empty() && mLods[0].indexCount > 0) {
+    MeshGroup group;
+    group.indexCount = mLods[0].indexCount;
+    mGroups.push_back(group);
+  }
+}
+
+void MeshObj::getBounds(glm::vec3 &boundsMin, glm::vec3 &boundsMax) const {
+  boundsMin = boundsMax = glm::vec3(0.0f);
+  for (GLuint group = 0; group < mGroups.size(); ++group) {
+    glm::vec3 groupMin(mGroups[group].boundsMin[0], mGroups[group].boundsMin[1], mGroups[group].boundsMin[2]);
+    glm::vec3 groupMax(mGroups[group].boundsMax[0], mGroups[group].boundsMax[1], mGroups[group].boundsMax[2]);
+    boundsMin = (group == 0) ? groupMin : glm::min(boundsMin, groupMin);
+    boundsMax = (group == 0) ? groupMax : glm::max(boundsMax, groupMax);
+  }
+}
+
+GLuint MeshObj::selectLod(float pixelsPerUnit, float maxPixelError) const {
+  // the errors grow with the level -> the last one that is small enough //
+  for (GLuint lod = mLods.size() - 1; lod > 0; --lod) {
+    if (mLods[lod].error * pixelsPerUnit <= maxPixelError) {
+      return lod;
     }
-    glBindBuffer(GL_ARRAY_BUFFER, mVBO_tangent);
-    glBufferData(GL_ARRAY_BUFFER, vertexTangentSize * sizeof(GLfloat), &vertex_tangent[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-    glEnableVertexAttribArray(3);
   }
-  
-  if (vertexBinormalSize > 0) {
-    if (mVBO_binormal == 0) {
-      glGenBuffers(1, &mVBO_binormal);
+  return 0;
+}
+
+int MeshObj::findGroup(const std::string &name) const {
+  for (GLuint group = 0; group < mGroups.size(); ++group) {
+    if (mGroups[group].name == name) {
+      return group;
     }
-    glBindBuffer(GL_ARRAY_BUFFER, mVBO_binormal);
-    glBufferData(GL_ARRAY_BUFFER, vertexBinormalSize * sizeof(GLfloat), &vertex_binormal[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-    glEnableVertexAttribArray(4);
   }
-  
-  // init and bind a IBO //
-  if (mIBO == 0) {
-    glGenBuffers(1, &mIBO);
+  return -1;
+}
+
+void MeshObj::render(void) {
+  // render your VAO //
+  // the groups cover the full mesh in order -> one call draws all of them
+  renderLod(0);
+}
+
+void MeshObj::renderLod(GLuint lod) {
+  if (mVAO != 0 && lod < mLods.size()) {
+    bindVertexArray();
+    glDrawElements(GL_TRIANGLES, mLods[lod].indexCount, mIndexType, (void*)((size_t)mLods[lod].firstIndex * mIndexSize));
   }
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIBO);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndexCount * sizeof(GLuint), &indices[0], GL_STATIC_DRAW);
-  
-  // unbind buffers //
-  glBindVertexArray(0);
-  
-  // make sure to clean up temporarily allocated data, if neccessary //
-  delete[] vertex_position;
-  if (vertexNormalSize > 0) {
-    delete[] vertex_normal;
+}
+
+void MeshObj::renderInstanced(GLuint instanceCount, GLuint instanceBuffer, GLuint lod, GLuint firstInstance) {
+  if (mVAO == 0 || lod >= mLods.size() || instanceCount == 0) {
+    return;
+  }
+  bindVertexArray();
+  // the matrix columns advance once per instance, the offset selects the first one //
+  // (no base instance in GL 3.3)
+  const GLsizei stride = sizeof(glm::mat4);
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+  for (GLuint column = 0; column < 4; ++column) {
+    glVertexAttribPointer(ATTRIB_INSTANCE_MODEL + column, 4, GL_FLOAT, GL_FALSE, stride,
+                          (void*)((size_t)firstInstance * stride + column * sizeof(glm::vec4)));
+    glVertexAttribDivisor(ATTRIB_INSTANCE_MODEL + column, 1);
+    glEnableVertexAttribArray(ATTRIB_INSTANCE_MODEL + column);
   }
-  if (vertexTexcoordSize > 0) {
-    delete[] vertex_texcoord;
+  glDrawElementsInstanced(GL_TRIANGLES, mLods[lod].indexCount, mIndexType, (void*)((size_t)mLods[lod].firstIndex * mIndexSize), instanceCount);
+  // disabled again -> the other render calls read the constant of setInstanceTransform(), which has to be set again //
+  for (GLuint column = 0; column < 4; ++column) {
+    glDisableVertexAttribArray(ATTRIB_INSTANCE_MODEL + column);
+    GLStateCache::invalidateVertexAttrib(ATTRIB_INSTANCE_MODEL + column);
   }
-  if (vertexTangentSize > 0) {
-    delete[] vertex_tangent;
+}
+
+void MeshObj::setInstanceTransform(const glm::mat4 &model) {
+  for (GLuint column = 0; column < 4; ++column) {
+    GLStateCache::vertexAttrib4fv(ATTRIB_INSTANCE_MODEL + column, &model[column][0]);
   }
-  if (vertexBinormalSize > 0) {
-    delete[] vertex_binormal;
+}
+
+void MeshObj::bindVertexArray(void) {
+  GLStateCache::bindVertexArray(mVAO);
+  // constant attribute values are no VAO state -> the cache sends them when they differ from the last draw //
+  GLStateCache::vertexAttrib3fv(ATTRIB_POSITION_OFFSET, mPositionOffset);
+  GLStateCache::vertexAttrib3fv(ATTRIB_POSITION_SCALE, mPositionScale);
+  if (mAttributeArrays & (1u << ATTRIB_BINORMAL)) {
+    // read from the VBO -> undefined after this draw //
+    GLStateCache::invalidateVertexAttrib(ATTRIB_BINORMAL);
+  } else {
+    static const GLfloat noBinormal[3] = {0.0f, 0.0f, 0.0f};
+    GLStateCache::vertexAttrib3fv(ATTRIB_BINORMAL, noBinormal);
   }
-  delete[] indices;
 }
 
-void MeshObj::render(void) {
-  // render your VAO //
-  if (mVAO != 0) {
-    glBindVertexArray(mVAO);
-    glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, (void*)0);
-    glBindVertexArray(0);
+void MeshObj::renderGroup(GLuint group) {
+  renderGroups(&group, 1);
+}
+
+void MeshObj::renderGroups(const GLuint *groups, GLuint groupCount) {
+  if (mVAO == 0) {
+    return;
+  }
+  bindVertexArray();
+  for (GLuint i = 0; i < groupCount; ++i) {
+    if (groups[i] >= mGroups.size()) {
+      continue;
+    }
+    const MeshGroup &group = mGroups[groups[i]];
+    glDrawElements(GL_TRIANGLES, group.indexCount, mIndexType, (void*)((size_t)group.firstIndex * mIndexSize));
+  }
+}
+
+void MeshObj::renderClusters(const GLuint *clusters, GLuint clusterCount) {
+  if (mVAO == 0) {
+    return;
+  }
+  bindVertexArray();
+  // ranges directly following each other are merged into one draw call //
+  GLuint firstIndex = 0;
+  GLuint indexCount = 0;
+  for (GLuint i = 0; i < clusterCount; ++i) {
+    if (clusters[i] >= mClusters.size()) {
+      continue;
+    }
+    const MeshCluster &cluster = mClusters[clusters[i]];
+    if (indexCount > 0 && cluster.firstIndex == firstIndex + indexCount) {
+      indexCount += cluster.indexCount;
+      continue;
+    }
+    if (indexCount > 0) {
+      glDrawElements(GL_TRIANGLES, indexCount, mIndexType, (void*)((size_t)firstIndex * mIndexSize));
+    }
+    firstIndex = cluster.firstIndex;
+    indexCount = cluster.indexCount;
+  }
+  if (indexCount > 0) {
+    glDrawElements(GL_TRIANGLES, indexCount, mIndexType, (void*)((size_t)firstIndex * mIndexSize));
   }
 }
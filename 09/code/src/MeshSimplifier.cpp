@@ -0,0 +1,535 @@
+#include "MeshSimplifier.h"
+
+#include <cmath>
+#include <algorithm>
+#include <cfloat>
+
+static const GLuint NO_VERTEX = 0xFFFFFFFF;
+// open borders are held in place by planes perpendicular to them, weighted higher than the faces //
+static const float BORDER_WEIGHT = 10.0f;
+// collapses turning a triangle's normal by more than ~75 degrees are rejected //
+static const float MIN_NORMAL_COSINE = 0.25f;
+// collapses of a pass may cost up to this factor more than the goal of the pass needs //
+static const float COST_LIMIT_SCALE = 1.5f;
+// levels that do not get smaller than this fraction of the previous one end the chain //
+static const float MIN_LOD_REDUCTION = 0.8f;
+
+MeshSimplifier::MeshSimplifier() {
+  mAttributeWeight = 0.01f;
+  mHasNormals = false;
+  mHasTexcoords = false;
+  mScale = 1.0f;
+  mMaxCost = 0.0f;
+}
+
+void MeshSimplifier::addPlane(Quadric &quadric, const glm::vec3 &normal, float distance, float weight) {
+  double a = normal.x, b = normal.y, c = normal.z, d = distance;
+  quadric.a2 += weight * a * a;
+  quadric.b2 += weight * b * b;
+  quadric.c2 += weight * c * c;
+  quadric.d2 += weight * d * d;
+  quadric.ab += weight * a * b;
+  quadric.ac += weight * a * c;
+  quadric.ad += weight * a * d;
+  quadric.bc += weight * b * c;
+  quadric.bd += weight * b * d;
+  quadric.cd += weight * c * d;
+  quadric.weight += weight;
+}
+
+void MeshSimplifier::addQuadric(Quadric &target, const Quadric &source) {
+  target.a2 += source.a2;
+  target.b2 += source.b2;
+  target.c2 += source.c2;
+  target.d2 += source.d2;
+  target.ab += source.ab;
+  target.ac += source.ac;
+  target.ad += source.ad;
+  target.bc += source.bc;
+  target.bd += source.bd;
+  target.cd += source.cd;
+  target.weight += source.weight;
+}
+
+float MeshSimplifier::evaluate(const Quadric &quadric, const glm::vec3 &point) {
+  double x = point.x, y = point.y, z = point.z;
+  double error = quadric.a2 * x * x + quadric.b2 * y * y + quadric.c2 * z * z + quadric.d2
+                 + 2.0 * (quadric.ab * x * y + quadric.ac * x * z + quadric.ad * x + quadric.bc * y * z + quadric.bd * y + quadric.cd * z);
+  // weighted mean of the squared plane distances //
+  return (quadric.weight > 0.0) ? (float)std::max(error / quadric.weight, 0.0) : 0.0f;
+}
+
+float MeshSimplifier::getError(void) const {
+  return std::sqrt(mMaxCost) / mScale;
+}
+
+void MeshSimplifier::generateLods(MeshData &meshData, unsigned int maxLodCount) {
+  // existing levels are replaced, the first one is the full mesh //
+  size_t fullIndexCount = meshData.lods.empty() ? meshData.indices.size() : meshData.lods[0].indexCount;
+  meshData.indices.resize(fullIndexCount);
+  meshData.lods.clear();
+  if (fullIndexCount == 0) {
+    return;
+  }
+  MeshLod full;
+  full.firstIndex = 0;
+  full.indexCount = fullIndexCount;
+  full.error = 0.0f;
+  meshData.lods.push_back(full);
+
+  begin(meshData, &meshData.indices[0], fullIndexCount);
+  while (meshData.lods.size() < maxLodCount) {
+    const MeshLod &previous = meshData.lods.back();
+    size_t targetIndexCount = (previous.indexCount / 6) * 3;
+    if (targetIndexCount < 3 * MIN_LOD_TRIANGLES) {
+      break;
+    }
+    size_t indexCount = simplify(targetIndexCount);
+    if (indexCount == 0 || indexCount > MIN_LOD_REDUCTION * previous.indexCount) {
+      // the remaining edges cannot collapse -> no more levels //
+      break;
+    }
+    MeshLod lod;
+    lod.firstIndex = meshData.indices.size();
+    lod.indexCount = indexCount;
+    lod.error = std::max(previous.error, getError());
+    meshData.indices.insert(meshData.indices.end(), mIndices.begin(), mIndices.end());
+    meshData.lods.push_back(lod);
+  }
+}
+
+void MeshSimplifier::begin(const MeshData &meshData, const GLuint *indices, size_t indexCount) {
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  mMaxCost = 0.0f;
+
+  // positions in the unit cube //
+  glm::vec3 boundsMin(0.0f);
+  glm::vec3 boundsMax(0.0f);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    glm::vec3 position(meshData.vertex_position[3 * v], meshData.vertex_position[3 * v + 1], meshData.vertex_position[3 * v + 2]);
+    boundsMin = (v == 0) ? position : glm::min(boundsMin, position);
+    boundsMax = (v == 0) ? position : glm::max(boundsMax, position);
+  }
+  glm::vec3 extent = boundsMax - boundsMin;
+  float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+  mScale = (maxExtent > 0.0f) ? 1.0f / maxExtent : 1.0f;
+  mPositions.resize(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    glm::vec3 position(meshData.vertex_position[3 * v], meshData.vertex_position[3 * v + 1], meshData.vertex_position[3 * v + 2]);
+    mPositions[v] = (position - boundsMin) * mScale;
+  }
+  mHasNormals = vertexCount > 0 && meshData.vertex_normal.size() == 3 * vertexCount;
+  mNormals.resize(mHasNormals ? vertexCount : 0);
+  for (size_t v = 0; v < mNormals.size(); ++v) {
+    mNormals[v] = glm::vec3(meshData.vertex_normal[3 * v], meshData.vertex_normal[3 * v + 1], meshData.vertex_normal[3 * v + 2]);
+  }
+  mHasTexcoords = vertexCount > 0 && meshData.vertex_texcoord.size() == 2 * vertexCount;
+  mTexcoords.resize(mHasTexcoords ? vertexCount : 0);
+  for (size_t v = 0; v < mTexcoords.size(); ++v) {
+    mTexcoords[v] = glm::vec2(meshData.vertex_texcoord[2 * v], meshData.vertex_texcoord[2 * v + 1]);
+  }
+
+  // vertices at the same position -> sorted next to each other, the first one represents them all //
+  mSortedVertices.resize(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    mSortedVertices[v] = v;
+  }
+  const std::vector<glm::vec3> &positions = mPositions;
+  std::sort(mSortedVertices.begin(), mSortedVertices.end(), [&positions](GLuint a, GLuint b) {
+    const glm::vec3 &pa = positions[a];
+    const glm::vec3 &pb = positions[b];
+    if (pa.x != pb.x) return pa.x < pb.x;
+    if (pa.y != pb.y) return pa.y < pb.y;
+    if (pa.z != pb.z) return pa.z < pb.z;
+    return a < b;
+  });
+  mRemap.resize(vertexCount);
+  mWedge.resize(vertexCount);
+  size_t runStart = 0;
+  for (size_t i = 0; i < vertexCount; ++i) {
+    bool runEnds = (i + 1 == vertexCount) || positions[mSortedVertices[i + 1]] != positions[mSortedVertices[i]];
+    if (runEnds) {
+      for (size_t j = runStart; j <= i; ++j) {
+        mRemap[mSortedVertices[j]] = mSortedVertices[runStart];
+        mWedge[mSortedVertices[j]] = mSortedVertices[(j == i) ? runStart : j + 1];
+      }
+      runStart = i + 1;
+    }
+  }
+
+  // triangles without area at their positions are dropped right away //
+  mIndices.clear();
+  mIndices.reserve(indexCount);
+  for (size_t i = 0; i + 2 < indexCount; i += 3) {
+    GLuint a = indices[i], b = indices[i + 1], c = indices[i + 2];
+    if (mRemap[a] != mRemap[b] && mRemap[a] != mRemap[c] && mRemap[b] != mRemap[c]) {
+      mIndices.push_back(a);
+      mIndices.push_back(b);
+      mIndices.push_back(c);
+    }
+  }
+
+  buildAdjacency();
+  classifyVertices();
+  initQuadrics();
+}
+
+void MeshSimplifier::buildAdjacency(void) {
+  const size_t vertexCount = mPositions.size();
+  mAdjacencyOffset.assign(vertexCount + 1, 0);
+  for (size_t i = 0; i < mIndices.size(); ++i) {
+    ++mAdjacencyOffset[mIndices[i] + 1];
+  }
+  for (size_t v = 0; v < vertexCount; ++v) {
+    mAdjacencyOffset[v + 1] += mAdjacencyOffset[v];
+  }
+  mAdjacency.resize(mIndices.size());
+  // the collapse targets serve as fill counters while the adjacency is built //
+  mCollapseTarget.assign(vertexCount, 0);
+  for (size_t i = 0; i < mIndices.size(); ++i) {
+    GLuint v = mIndices[i];
+    mAdjacency[mAdjacencyOffset[v] + mCollapseTarget[v]++] = i / 3;
+  }
+}
+
+// the corner following 'vertex' in triangle 'triangle' //
+static inline GLuint getNextCorner(const std::vector<GLuint> &indices, unsigned int triangle, GLuint vertex) {
+  const GLuint *corners = &indices[3 * triangle];
+  return (corners[0] == vertex) ? corners[1] : (corners[1] == vertex) ? corners[2] : corners[0];
+}
+
+static inline GLuint getPreviousCorner(const std::vector<GLuint> &indices, unsigned int triangle, GLuint vertex) {
+  const GLuint *corners = &indices[3 * triangle];
+  return (corners[0] == vertex) ? corners[2] : (corners[1] == vertex) ? corners[0] : corners[1];
+}
+
+bool MeshSimplifier::hasEdge(GLuint from, GLuint to) const {
+  for (unsigned int a = mAdjacencyOffset[from]; a < mAdjacencyOffset[from + 1]; ++a) {
+    if (getNextCorner(mIndices, mAdjacency[a], from) == to) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MeshSimplifier::hasPositionEdge(GLuint from, GLuint to) const {
+  GLuint wedge = from;
+  do {
+    for (unsigned int a = mAdjacencyOffset[wedge]; a < mAdjacencyOffset[wedge + 1]; ++a) {
+      if (mRemap[getNextCorner(mIndices, mAdjacency[a], wedge)] == mRemap[to]) {
+        return true;
+      }
+    }
+    wedge = mWedge[wedge];
+  } while (wedge != from);
+  return false;
+}
+
+void MeshSimplifier::classifyVertices(void) {
+  const size_t vertexCount = mPositions.size();
+  // open edges -> no triangle uses them in the opposite direction //
+  std::vector<unsigned char> openOutCount(vertexCount, 0);
+  std::vector<unsigned char> openInCount(vertexCount, 0);
+  std::vector<unsigned char> borderEdgeCount(vertexCount, 0);
+  mOpenOut.assign(vertexCount, NO_VERTEX);
+  mOpenIn.assign(vertexCount, NO_VERTEX);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    for (unsigned int a = mAdjacencyOffset[v]; a < mAdjacencyOffset[v + 1]; ++a) {
+      GLuint next = getNextCorner(mIndices, mAdjacency[a], v);
+      GLuint previous = getPreviousCorner(mIndices, mAdjacency[a], v);
+      if (!hasEdge(next, v)) {
+        openOutCount[v] = std::min(openOutCount[v] + 1, 255);
+        mOpenOut[v] = next;
+        // open at the positions too -> a border, otherwise a seam //
+        if (!hasPositionEdge(next, v)) {
+          borderEdgeCount[v] = std::min(borderEdgeCount[v] + 1, 255);
+        }
+      }
+      if (!hasEdge(v, previous)) {
+        openInCount[v] = std::min(openInCount[v] + 1, 255);
+        mOpenIn[v] = previous;
+        if (!hasPositionEdge(v, previous)) {
+          borderEdgeCount[v] = std::min(borderEdgeCount[v] + 1, 255);
+        }
+      }
+    }
+  }
+
+  mKind.assign(vertexCount, KIND_LOCKED);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    if (mRemap[v] != v) {
+      continue;
+    }
+    // the vertices at this position which are in use //
+    GLuint wedges[2];
+    unsigned int wedgeCount = 0;
+    GLuint wedge = v;
+    do {
+      if (mAdjacencyOffset[wedge + 1] > mAdjacencyOffset[wedge]) {
+        if (wedgeCount < 2) {
+          wedges[wedgeCount] = wedge;
+        }
+        ++wedgeCount;
+      }
+      wedge = mWedge[wedge];
+    } while (wedge != v);
+
+    VertexKind kind = KIND_LOCKED;
+    if (wedgeCount == 1) {
+      GLuint w = wedges[0];
+      if (openOutCount[w] == 0 && openInCount[w] == 0) {
+        kind = KIND_MANIFOLD;
+      } else if (openOutCount[w] == 1 && openInCount[w] == 1 && borderEdgeCount[w] == 2) {
+        kind = KIND_BORDER;
+      }
+    } else if (wedgeCount == 2) {
+      bool seam = true;
+      for (unsigned int k = 0; k < 2; ++k) {
+        GLuint w = wedges[k];
+        seam = seam && openOutCount[w] == 1 && openInCount[w] == 1 && borderEdgeCount[w] == 0;
+      }
+      kind = seam ? KIND_SEAM : KIND_LOCKED;
+    }
+    wedge = v;
+    do {
+      mKind[wedge] = kind;
+      wedge = mWedge[wedge];
+    } while (wedge != v);
+  }
+}
+
+void MeshSimplifier::initQuadrics(void) {
+  const size_t vertexCount = mPositions.size();
+  Quadric zero = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  mQuadrics.assign(vertexCount, zero);
+  for (size_t t = 0; t < mIndices.size() / 3; ++t) {
+    const GLuint *corners = &mIndices[3 * t];
+    const glm::vec3 &p0 = mPositions[corners[0]];
+    const glm::vec3 &p1 = mPositions[corners[1]];
+    const glm::vec3 &p2 = mPositions[corners[2]];
+    glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+    float doubleArea = glm::length(normal);
+    if (doubleArea <= 0.0f) {
+      continue;
+    }
+    normal /= doubleArea;
+    // the face plane, weighted by area //
+    for (unsigned int k = 0; k < 3; ++k) {
+      addPlane(mQuadrics[mRemap[corners[k]]], normal, -glm::dot(normal, p0), 0.5f * doubleArea);
+    }
+    // border edges add a plane through the edge, perpendicular to the face //
+    for (unsigned int k = 0; k < 3; ++k) {
+      GLuint a = corners[k];
+      GLuint b = corners[(k + 1) % 3];
+      if ((mKind[a] != KIND_BORDER && mKind[b] != KIND_BORDER) || hasPositionEdge(b, a)) {
+        continue;
+      }
+      glm::vec3 edge = mPositions[b] - mPositions[a];
+      glm::vec3 edgeNormal = glm::cross(edge, normal);
+      float length = glm::length(edgeNormal);
+      if (length <= 0.0f) {
+        continue;
+      }
+      edgeNormal /= length;
+      float weight = BORDER_WEIGHT * glm::dot(edge, edge);
+      addPlane(mQuadrics[mRemap[a]], edgeNormal, -glm::dot(edgeNormal, mPositions[a]), weight);
+      addPlane(mQuadrics[mRemap[b]], edgeNormal, -glm::dot(edgeNormal, mPositions[a]), weight);
+    }
+  }
+}
+
+float MeshSimplifier::getAttributeError(GLuint from, GLuint to) const {
+  float error = 0.0f;
+  if (mHasNormals) {
+    glm::vec3 difference = mNormals[from] - mNormals[to];
+    error += glm::dot(difference, difference);
+  }
+  if (mHasTexcoords) {
+    glm::vec2 difference = mTexcoords[from] - mTexcoords[to];
+    error += glm::dot(difference, difference);
+  }
+  return mAttributeWeight * mAttributeWeight * error;
+}
+
+bool MeshSimplifier::getCollapse(GLuint from, GLuint to, Collapse &collapse) const {
+  if (mRemap[from] == mRemap[to]) {
+    return false;
+  }
+  collapse.from = from;
+  collapse.to = to;
+  collapse.twinFrom = NO_VERTEX;
+  collapse.twinTo = NO_VERTEX;
+  switch (mKind[from]) {
+    case KIND_MANIFOLD:
+      break;
+    case KIND_BORDER:
+      // only along the border //
+      if (to != mOpenOut[from] && to != mOpenIn[from]) {
+        return false;
+      }
+      break;
+    case KIND_SEAM: {
+      // along the seam, the vertex on the other side follows to the other side of 'to' //
+      if (to != mOpenOut[from] && to != mOpenIn[from]) {
+        return false;
+      }
+      GLuint twin = mWedge[from];
+      while (mAdjacencyOffset[twin + 1] == mAdjacencyOffset[twin]) {
+        twin = mWedge[twin];
+      }
+      if (mOpenOut[twin] != NO_VERTEX && mRemap[mOpenOut[twin]] == mRemap[to]) {
+        collapse.twinTo = mOpenOut[twin];
+      } else if (mOpenIn[twin] != NO_VERTEX && mRemap[mOpenIn[twin]] == mRemap[to]) {
+        collapse.twinTo = mOpenIn[twin];
+      } else {
+        return false;
+      }
+      collapse.twinFrom = twin;
+      break;
+    }
+    default:
+      return false;
+  }
+  collapse.cost = evaluate(mQuadrics[mRemap[from]], mPositions[to]) + getAttributeError(from, to);
+  if (collapse.twinFrom != NO_VERTEX) {
+    collapse.cost += getAttributeError(collapse.twinFrom, collapse.twinTo);
+  }
+  return true;
+}
+
+bool MeshSimplifier::flipsTriangles(GLuint vertex, GLuint target) const {
+  const glm::vec3 &moved = mPositions[target];
+  for (unsigned int a = mAdjacencyOffset[vertex]; a < mAdjacencyOffset[vertex + 1]; ++a) {
+    const GLuint *corners = &mIndices[3 * mAdjacency[a]];
+    if (mRemap[corners[0]] == mRemap[target] || mRemap[corners[1]] == mRemap[target] || mRemap[corners[2]] == mRemap[target]) {
+      // collapses to nothing //
+      continue;
+    }
+    glm::vec3 p[3];
+    glm::vec3 q[3];
+    for (unsigned int k = 0; k < 3; ++k) {
+      p[k] = mPositions[corners[k]];
+      q[k] = (corners[k] == vertex) ? moved : p[k];
+    }
+    glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+    glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+    float beforeLength = glm::length(before);
+    if (beforeLength > 0.0f && glm::dot(before, after) <= MIN_NORMAL_COSINE * beforeLength * glm::length(after)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void MeshSimplifier::lockRing(GLuint vertex) {
+  for (unsigned int a = mAdjacencyOffset[vertex]; a < mAdjacencyOffset[vertex + 1]; ++a) {
+    const GLuint *corners = &mIndices[3 * mAdjacency[a]];
+    for (unsigned int k = 0; k < 3; ++k) {
+      mLocked[mRemap[corners[k]]] = 1;
+    }
+  }
+}
+
+unsigned int MeshSimplifier::countCollapsedTriangles(GLuint vertex, GLuint target) const {
+  unsigned int count = 0;
+  for (unsigned int a = mAdjacencyOffset[vertex]; a < mAdjacencyOffset[vertex + 1]; ++a) {
+    const GLuint *corners = &mIndices[3 * mAdjacency[a]];
+    if (mRemap[corners[0]] == mRemap[target] || mRemap[corners[1]] == mRemap[target] || mRemap[corners[2]] == mRemap[target]) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+size_t MeshSimplifier::simplify(size_t targetIndexCount) {
+  while (mIndices.size() > targetIndexCount) {
+    // cheaper direction of every edge that may collapse //
+    mCollapses.clear();
+    for (size_t t = 0; t < mIndices.size() / 3; ++t) {
+      for (unsigned int k = 0; k < 3; ++k) {
+        GLuint a = mIndices[3 * t + k];
+        GLuint b = mIndices[3 * t + (k + 1) % 3];
+        Collapse forward, backward;
+        bool canForward = getCollapse(a, b, forward);
+        bool canBackward = getCollapse(b, a, backward);
+        if (canForward && (!canBackward || forward.cost <= backward.cost)) {
+          mCollapses.push_back(forward);
+        } else if (canBackward) {
+          mCollapses.push_back(backward);
+        }
+      }
+    }
+    if (mCollapses.empty()) {
+      break;
+    }
+    mCollapseOrder.resize(mCollapses.size());
+    for (size_t i = 0; i < mCollapses.size(); ++i) {
+      mCollapseOrder[i] = i;
+    }
+    const std::vector<Collapse> &collapses = mCollapses;
+    std::sort(mCollapseOrder.begin(), mCollapseOrder.end(), [&collapses](unsigned int a, unsigned int b) {
+      return collapses[a].cost < collapses[b].cost;
+    });
+
+    // cheapest collapses first, the triangles around a collapsed vertex are not touched again in this pass //
+    const size_t vertexCount = mPositions.size();
+    mLocked.assign(vertexCount, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+      mCollapseTarget[v] = v;
+    }
+    const size_t triangleGoal = (mIndices.size() - targetIndexCount + 2) / 3;
+    // a collapse removes two triangles and most edges are listed twice -> the cost at 'triangleGoal' would reach the //
+    // goal, more expensive collapses wait for the next pass (cheaper ones may become possible once the locks are gone)
+    float costLimit = (triangleGoal < mCollapseOrder.size()) ? COST_LIMIT_SCALE * mCollapses[mCollapseOrder[triangleGoal]].cost : FLT_MAX;
+    size_t removedTriangles = 0;
+    size_t performed = 0;
+    for (size_t i = 0; i < mCollapseOrder.size() && removedTriangles < triangleGoal; ++i) {
+      const Collapse &collapse = mCollapses[mCollapseOrder[i]];
+      if (collapse.cost > costLimit) {
+        break;
+      }
+      if (mLocked[mRemap[collapse.from]] || mLocked[mRemap[collapse.to]]) {
+        continue;
+      }
+      bool hasTwin = collapse.twinFrom != NO_VERTEX;
+      if (flipsTriangles(collapse.from, collapse.to) || (hasTwin && flipsTriangles(collapse.twinFrom, collapse.twinTo))) {
+        continue;
+      }
+      removedTriangles += countCollapsedTriangles(collapse.from, collapse.to);
+      lockRing(collapse.from);
+      mCollapseTarget[collapse.from] = collapse.to;
+      if (hasTwin) {
+        removedTriangles += countCollapsedTriangles(collapse.twinFrom, collapse.twinTo);
+        lockRing(collapse.twinFrom);
+        mCollapseTarget[collapse.twinFrom] = collapse.twinTo;
+      }
+      // the position keeps the error of everything merged into it //
+      addQuadric(mQuadrics[mRemap[collapse.to]], mQuadrics[mRemap[collapse.from]]);
+      mMaxCost = std::max(mMaxCost, collapse.cost);
+      ++performed;
+    }
+    if (performed == 0) {
+      break;
+    }
+    removeCollapsedTriangles();
+    buildAdjacency();
+  }
+  return mIndices.size();
+}
+
+size_t MeshSimplifier::removeCollapsedTriangles(void) {
+  size_t writePosition = 0;
+  for (size_t i = 0; i + 2 < mIndices.size(); i += 3) {
+    GLuint a = mCollapseTarget[mIndices[i]];
+    GLuint b = mCollapseTarget[mIndices[i + 1]];
+    GLuint c = mCollapseTarget[mIndices[i + 2]];
+    if (mRemap[a] == mRemap[b] || mRemap[a] == mRemap[c] || mRemap[b] == mRemap[c]) {
+      continue;
+    }
+    mIndices[writePosition++] = a;
+    mIndices[writePosition++] = b;
+    mIndices[writePosition++] = c;
+  }
+  mIndices.resize(writePosition);
+  return writePosition;
+}
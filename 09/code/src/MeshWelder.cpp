@@ -0,0 +1,246 @@
+#include "MeshWelder.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include "Parallel.h"
+
+static const GLuint NO_VERTEX = 0xFFFFFFFF;
+// vertices per task of the parallel stages //
+static const size_t BLOCK_VERTICES = 1 << 14;
+// finest grid, relative to the size of the mesh -> cell coordinates stay far from the int limits //
+static const float MIN_CELL_SIZE = 1.0f / (1 << 20);
+
+MeshWelder::MeshWelder() {
+  mPositionTolerance = 1e-6f;
+  setNormalTolerance(1.0f);
+  mTexcoordTolerance = 1e-5f;
+  mThreadCount = 0;
+  mDistance = 0.0f;
+  mCellSize = 1.0f;
+  mOrigin[0] = mOrigin[1] = mOrigin[2] = 0.0f;
+  mHasNormals = false;
+  mHasTexcoords = false;
+  mBucketMask = 0;
+}
+
+void MeshWelder::setNormalTolerance(float degrees) {
+  mCosNormalTolerance = std::cos(glm::clamp(degrees, 0.0f, 180.0f) * (float)M_PI / 180.0f);
+}
+
+size_t MeshWelder::hash(int x, int y, int z) {
+  return (size_t)((unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u ^ (unsigned int)z * 83492791u);
+}
+
+unsigned int MeshWelder::weld(MeshData &meshData) {
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  if (vertexCount < 2) {
+    return 0;
+  }
+  mHasNormals = meshData.vertex_normal.size() == 3 * vertexCount;
+  mHasTexcoords = meshData.vertex_texcoord.size() == 2 * vertexCount;
+
+  // the tolerance and the grid follow the size of the mesh //
+  glm::vec3 boundsMin(meshData.vertex_position[0], meshData.vertex_position[1], meshData.vertex_position[2]);
+  glm::vec3 boundsMax = boundsMin;
+  for (size_t v = 1; v < vertexCount; ++v) {
+    glm::vec3 position(meshData.vertex_position[3 * v], meshData.vertex_position[3 * v + 1], meshData.vertex_position[3 * v + 2]);
+    boundsMin = glm::min(boundsMin, position);
+    boundsMax = glm::max(boundsMax, position);
+  }
+  float diagonal = glm::length(boundsMax - boundsMin);
+  mDistance = mPositionTolerance * diagonal;
+  mCellSize = std::max(mDistance, MIN_CELL_SIZE * diagonal);
+  if (mCellSize <= 0.0f) {
+    mCellSize = 1.0f;
+  }
+  for (unsigned int k = 0; k < 3; ++k) {
+    mOrigin[k] = boundsMin[k];
+  }
+
+  const unsigned int blockCount = (vertexCount + BLOCK_VERTICES - 1) / BLOCK_VERTICES;
+  mCells.resize(vertexCount);
+  mHashes.resize(vertexCount);
+  parallelFor(blockCount, mThreadCount, [&](unsigned int block) {
+    computeCells(meshData, block * BLOCK_VERTICES, std::min((block + 1) * BLOCK_VERTICES, vertexCount));
+  });
+  buildBuckets(vertexCount);
+
+  // every vertex looks for an earlier one to merge into, chains are resolved in order afterwards //
+  mRemap.resize(vertexCount);
+  parallelFor(blockCount, mThreadCount, [&](unsigned int block) {
+    const size_t endVertex = std::min((block + 1) * BLOCK_VERTICES, vertexCount);
+    for (size_t v = block * BLOCK_VERTICES; v < endVertex; ++v) {
+      mRemap[v] = findMatch(meshData, v);
+    }
+  });
+  unsigned int mergedCount = 0;
+  for (size_t v = 0; v < vertexCount; ++v) {
+    if (mRemap[v] != v) {
+      mRemap[v] = mRemap[mRemap[v]];
+      ++mergedCount;
+    }
+  }
+  if (mergedCount == 0) {
+    return 0;
+  }
+  for (size_t i = 0; i < meshData.indices.size(); ++i) {
+    meshData.indices[i] = mRemap[meshData.indices[i]];
+  }
+  compact(meshData);
+  return vertexCount - meshData.vertex_position.size() / 3;
+}
+
+void MeshWelder::computeCells(const MeshData &meshData, size_t firstVertex, size_t endVertex) {
+  const float scale = 1.0f / mCellSize;
+  for (size_t v = firstVertex; v < endVertex; ++v) {
+    const GLfloat *position = &meshData.vertex_position[3 * v];
+    Cell &cell = mCells[v];
+    cell.x = (int)std::floor((position[0] - mOrigin[0]) * scale);
+    cell.y = (int)std::floor((position[1] - mOrigin[1]) * scale);
+    cell.z = (int)std::floor((position[2] - mOrigin[2]) * scale);
+    mHashes[v] = hash(cell.x, cell.y, cell.z);
+  }
+}
+
+void MeshWelder::buildBuckets(size_t vertexCount) {
+  // as many buckets as vertices (power of two), the vertices of a bucket stay in index order //
+  size_t bucketCount = 1;
+  while (bucketCount < vertexCount) {
+    bucketCount <<= 1;
+  }
+  mBucketMask = bucketCount - 1;
+  mBucketOffset.assign(bucketCount + 1, 0);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    ++mBucketOffset[(mHashes[v] & mBucketMask) + 1];
+  }
+  for (size_t b = 0; b < bucketCount; ++b) {
+    mBucketOffset[b + 1] += mBucketOffset[b];
+  }
+  mBucketVertices.resize(vertexCount);
+  mFillCount.assign(bucketCount, 0);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    size_t bucket = mHashes[v] & mBucketMask;
+    mBucketVertices[mBucketOffset[bucket] + mFillCount[bucket]++] = v;
+  }
+}
+
+GLuint MeshWelder::findMatch(const MeshData &meshData, GLuint vertex) const {
+  const Cell &cell = mCells[vertex];
+  GLuint match = vertex;
+  // positions within the tolerance are at most one cell away //
+  for (int dz = -1; dz <= 1; ++dz) {
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        const int x = cell.x + dx, y = cell.y + dy, z = cell.z + dz;
+        const size_t bucket = hash(x, y, z) & mBucketMask;
+        for (unsigned int i = mBucketOffset[bucket]; i < mBucketOffset[bucket + 1]; ++i) {
+          GLuint other = mBucketVertices[i];
+          if (other >= match) {
+            break;
+          }
+          const Cell &otherCell = mCells[other];
+          if (otherCell.x == x && otherCell.y == y && otherCell.z == z && matches(meshData, vertex, other)) {
+            match = other;
+            break;
+          }
+        }
+      }
+    }
+  }
+  return match;
+}
+
+bool MeshWelder::matches(const MeshData &meshData, GLuint a, GLuint b) const {
+  const GLfloat *positionA = &meshData.vertex_position[3 * a];
+  const GLfloat *positionB = &meshData.vertex_position[3 * b];
+  glm::vec3 offset(positionA[0] - positionB[0], positionA[1] - positionB[1], positionA[2] - positionB[2]);
+  if (glm::dot(offset, offset) > mDistance * mDistance) {
+    return false;
+  }
+  if (mHasNormals) {
+    glm::vec3 normalA(meshData.vertex_normal[3 * a], meshData.vertex_normal[3 * a + 1], meshData.vertex_normal[3 * a + 2]);
+    glm::vec3 normalB(meshData.vertex_normal[3 * b], meshData.vertex_normal[3 * b + 1], meshData.vertex_normal[3 * b + 2]);
+    float lengths = glm::length(normalA) * glm::length(normalB);
+    // missing (zero) normals only match each other //
+    if (lengths == 0.0f) {
+      if (normalA != normalB) {
+        return false;
+      }
+    } else if (glm::dot(normalA, normalB) < mCosNormalTolerance * lengths) {
+      return false;
+    }
+  }
+  if (mHasTexcoords) {
+    const GLfloat *texcoordA = &meshData.vertex_texcoord[2 * a];
+    const GLfloat *texcoordB = &meshData.vertex_texcoord[2 * b];
+    if (std::fabs(texcoordA[0] - texcoordB[0]) > mTexcoordTolerance || std::fabs(texcoordA[1] - texcoordB[1]) > mTexcoordTolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void MeshWelder::compact(MeshData &meshData) {
+  // triangles whose corners were merged are dropped, the groups keep covering the index list in order //
+  std::vector<GLuint> &indices = meshData.indices;
+  std::vector<MeshGroup> wholeMesh;
+  if (meshData.groups.empty()) {
+    wholeMesh.resize(1);
+    wholeMesh[0].indexCount = indices.size() - indices.size() % 3;
+  }
+  std::vector<MeshGroup> &groups = meshData.groups.empty() ? wholeMesh : meshData.groups;
+  size_t writeIndex = 0;
+  for (size_t g = 0; g < groups.size(); ++g) {
+    MeshGroup &group = groups[g];
+    const size_t firstIndex = writeIndex;
+    for (size_t i = group.firstIndex; i + 2 < (size_t)group.firstIndex + group.indexCount; i += 3) {
+      if (indices[i] == indices[i + 1] || indices[i] == indices[i + 2] || indices[i + 1] == indices[i + 2]) {
+        continue;
+      }
+      indices[writeIndex++] = indices[i];
+      indices[writeIndex++] = indices[i + 1];
+      indices[writeIndex++] = indices[i + 2];
+    }
+    group.firstIndex = firstIndex;
+    group.indexCount = writeIndex - firstIndex;
+  }
+  indices.resize(writeIndex);
+
+  // the used vertices keep their order //
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  mRemap.assign(vertexCount, NO_VERTEX);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    mRemap[indices[i]] = 0;
+  }
+  GLuint keptCount = 0;
+  std::vector<GLfloat> *attributes[ATTRIB_COUNT] = {&meshData.vertex_position, &meshData.vertex_normal, &meshData.vertex_texcoord,
+                                                    &meshData.vertex_tangent, &meshData.vertex_binormal};
+  const GLuint attributeSize[ATTRIB_COUNT] = {3, 3, 2, 3, 3};
+  for (size_t v = 0; v < vertexCount; ++v) {
+    if (mRemap[v] == NO_VERTEX) {
+      continue;
+    }
+    mRemap[v] = keptCount;
+    // the kept vertex moves to a lower or the same index -> the arrays are compacted in place //
+    for (GLuint attribute = 0; attribute < ATTRIB_COUNT; ++attribute) {
+      std::vector<GLfloat> &data = *attributes[attribute];
+      const GLuint size = attributeSize[attribute];
+      if (data.size() == vertexCount * size) {
+        std::copy(&data[v * size], &data[v * size] + size, &data[keptCount * size]);
+      }
+    }
+    ++keptCount;
+  }
+  for (GLuint attribute = 0; attribute < ATTRIB_COUNT; ++attribute) {
+    std::vector<GLfloat> &data = *attributes[attribute];
+    if (data.size() == vertexCount * attributeSize[attribute]) {
+      data.resize(keptCount * attributeSize[attribute]);
+    }
+  }
+  for (size_t i = 0; i < indices.size(); ++i) {
+    indices[i] = mRemap[indices[i]];
+  }
+}
@@ -0,0 +1,195 @@
+#include "NormalGenerator.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "Parallel.h"
+
+static const GLuint NO_VERTEX = 0xFFFFFFFF;
+// triangles per task of the parallel stages //
+static const size_t BLOCK_TRIANGLES = 1 << 14;
+
+NormalGenerator::NormalGenerator() {
+  setCreaseAngle(60.0f);
+  mWeighting = WEIGHT_ANGLE;
+  mThreadCount = 0;
+}
+
+void NormalGenerator::setCreaseAngle(float degrees) {
+  mCosCreaseAngle = std::cos(glm::clamp(degrees, 0.0f, 180.0f) * (float)M_PI / 180.0f);
+}
+
+unsigned int NormalGenerator::generate(MeshData &meshData) {
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  const size_t triangleCount = meshData.indices.size() / 3;
+  if (meshData.vertex_normal.size() != 3 * vertexCount) {
+    meshData.vertex_normal.assign(3 * vertexCount, 0.0f);
+  }
+  // vertices without a normal //
+  mMissing.resize(vertexCount);
+  bool anyMissing = false;
+  for (size_t v = 0; v < vertexCount; ++v) {
+    const GLfloat *normal = &meshData.vertex_normal[3 * v];
+    mMissing[v] = normal[0] == 0.0f && normal[1] == 0.0f && normal[2] == 0.0f;
+    anyMissing = anyMissing || mMissing[v];
+  }
+  if (!anyMissing || triangleCount == 0) {
+    return 0;
+  }
+
+  const unsigned int blockCount = (triangleCount + BLOCK_TRIANGLES - 1) / BLOCK_TRIANGLES;
+  mFaceX.resize(triangleCount);
+  mFaceY.resize(triangleCount);
+  mFaceZ.resize(triangleCount);
+  mCornerWeight.resize(3 * triangleCount);
+  parallelFor(blockCount, mThreadCount, [&](unsigned int block) {
+    computeFaceNormals(meshData, block * BLOCK_TRIANGLES, std::min((block + 1) * BLOCK_TRIANGLES, triangleCount));
+  });
+  buildPositionAdjacency(meshData);
+  mCornerX.resize(3 * triangleCount);
+  mCornerY.resize(3 * triangleCount);
+  mCornerZ.resize(3 * triangleCount);
+  parallelFor(blockCount, mThreadCount, [&](unsigned int block) {
+    computeCornerNormals(meshData, 3 * block * BLOCK_TRIANGLES, 3 * std::min((block + 1) * BLOCK_TRIANGLES, triangleCount));
+  });
+
+  // the first corner of a vertex sets its normal, corners with another one use (or create) a copy //
+  mAssigned.assign(vertexCount, 0);
+  mNextCopy.assign(vertexCount, NO_VERTEX);
+  unsigned int generatedCount = 0;
+  for (size_t c = 0; c < 3 * triangleCount; ++c) {
+    GLuint vertex = meshData.indices[c];
+    if (!mMissing[vertex]) {
+      continue;
+    }
+    const GLfloat normal[3] = {mCornerX[c], mCornerY[c], mCornerZ[c]};
+    if (!mAssigned[vertex]) {
+      std::copy(normal, normal + 3, &meshData.vertex_normal[3 * vertex]);
+      mAssigned[vertex] = 1;
+      ++generatedCount;
+      continue;
+    }
+    // triangles without area have no normal of their own -> they simply keep the vertex //
+    if (mFaceX[c / 3] == 0.0f && mFaceY[c / 3] == 0.0f && mFaceZ[c / 3] == 0.0f) {
+      continue;
+    }
+    GLuint copy = vertex;
+    while (!std::equal(normal, normal + 3, &meshData.vertex_normal[3 * copy])) {
+      if (mNextCopy[copy] == NO_VERTEX) {
+        GLuint newCopy = meshData.copyVertex(vertex);
+        std::copy(normal, normal + 3, &meshData.vertex_normal[3 * newCopy]);
+        mNextCopy[copy] = newCopy;
+        mNextCopy.push_back(NO_VERTEX);
+        ++generatedCount;
+      }
+      copy = mNextCopy[copy];
+    }
+    meshData.indices[c] = copy;
+  }
+  return generatedCount;
+}
+
+void NormalGenerator::computeFaceNormals(const MeshData &meshData, size_t firstTriangle, size_t endTriangle) {
+  const GLfloat *positions = &meshData.vertex_position[0];
+  const GLuint *indices = &meshData.indices[0];
+  const bool weightByArea = mWeighting == WEIGHT_AREA;
+  for (size_t t = firstTriangle; t < endTriangle; ++t) {
+    const GLfloat *p0 = &positions[3 * indices[3 * t]];
+    const GLfloat *p1 = &positions[3 * indices[3 * t + 1]];
+    const GLfloat *p2 = &positions[3 * indices[3 * t + 2]];
+    const float e1x = p1[0] - p0[0], e1y = p1[1] - p0[1], e1z = p1[2] - p0[2];
+    const float e2x = p2[0] - p0[0], e2y = p2[1] - p0[1], e2z = p2[2] - p0[2];
+    const float nx = e1y * e2z - e1z * e2y;
+    const float ny = e1z * e2x - e1x * e2z;
+    const float nz = e1x * e2y - e1y * e2x;
+    const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+    const float scale = (length > 0.0f) ? 1.0f / length : 0.0f;
+    mFaceX[t] = nx * scale;
+    mFaceY[t] = ny * scale;
+    mFaceZ[t] = nz * scale;
+
+    if (weightByArea) {
+      mCornerWeight[3 * t] = mCornerWeight[3 * t + 1] = mCornerWeight[3 * t + 2] = 0.5f * length;
+      continue;
+    }
+    // |cross| is the same for all corners -> the angles follow from the dot products of the edges //
+    const float e3x = p2[0] - p1[0], e3y = p2[1] - p1[1], e3z = p2[2] - p1[2];
+    const float dot0 = e1x * e2x + e1y * e2y + e1z * e2z;
+    const float dot1 = -(e1x * e3x + e1y * e3y + e1z * e3z);
+    const float dot2 = e2x * e3x + e2y * e3y + e2z * e3z;
+    mCornerWeight[3 * t] = std::atan2(length, dot0);
+    mCornerWeight[3 * t + 1] = std::atan2(length, dot1);
+    mCornerWeight[3 * t + 2] = std::atan2(length, dot2);
+  }
+}
+
+void NormalGenerator::buildPositionAdjacency(const MeshData &meshData) {
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  const size_t indexCount = meshData.indices.size() - meshData.indices.size() % 3;
+  const GLfloat *positions = &meshData.vertex_position[0];
+
+  // vertices at the same position -> sorted next to each other, the first one represents them all //
+  mSortedVertices.resize(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    mSortedVertices[v] = v;
+  }
+  std::sort(mSortedVertices.begin(), mSortedVertices.end(), [positions](GLuint a, GLuint b) {
+    const GLfloat *pa = &positions[3 * a];
+    const GLfloat *pb = &positions[3 * b];
+    if (pa[0] != pb[0]) return pa[0] < pb[0];
+    if (pa[1] != pb[1]) return pa[1] < pb[1];
+    if (pa[2] != pb[2]) return pa[2] < pb[2];
+    return a < b;
+  });
+  mRemap.resize(vertexCount);
+  for (size_t i = 0; i < vertexCount; ++i) {
+    GLuint vertex = mSortedVertices[i];
+    bool samePosition = i > 0 && std::equal(&positions[3 * vertex], &positions[3 * vertex + 3], &positions[3 * mSortedVertices[i - 1]]);
+    mRemap[vertex] = samePosition ? mRemap[mSortedVertices[i - 1]] : vertex;
+  }
+
+  // corners per position //
+  mAdjacencyOffset.assign(vertexCount + 1, 0);
+  for (size_t c = 0; c < indexCount; ++c) {
+    ++mAdjacencyOffset[mRemap[meshData.indices[c]] + 1];
+  }
+  for (size_t v = 0; v < vertexCount; ++v) {
+    mAdjacencyOffset[v + 1] += mAdjacencyOffset[v];
+  }
+  mAdjacency.resize(indexCount);
+  mFillCount.assign(vertexCount, 0);
+  for (size_t c = 0; c < indexCount; ++c) {
+    GLuint position = mRemap[meshData.indices[c]];
+    mAdjacency[mAdjacencyOffset[position] + mFillCount[position]++] = c;
+  }
+}
+
+void NormalGenerator::computeCornerNormals(const MeshData &meshData, size_t firstCorner, size_t endCorner) {
+  for (size_t c = firstCorner; c < endCorner; ++c) {
+    GLuint vertex = meshData.indices[c];
+    if (!mMissing[vertex]) {
+      continue;
+    }
+    const size_t t = c / 3;
+    const float fx = mFaceX[t], fy = mFaceY[t], fz = mFaceZ[t];
+    // triangles without area take every triangle around the position //
+    const float cosCrease = (fx == 0.0f && fy == 0.0f && fz == 0.0f) ? -1.0f : mCosCreaseAngle;
+    float nx = 0.0f, ny = 0.0f, nz = 0.0f;
+    const GLuint position = mRemap[vertex];
+    for (unsigned int a = mAdjacencyOffset[position]; a < mAdjacencyOffset[position + 1]; ++a) {
+      const unsigned int corner = mAdjacency[a];
+      const unsigned int other = corner / 3;
+      // triangles without area add nothing (zero normal) //
+      const float cosAngle = fx * mFaceX[other] + fy * mFaceY[other] + fz * mFaceZ[other];
+      const float weight = (cosAngle >= cosCrease || other == t) ? mCornerWeight[corner] : 0.0f;
+      nx += weight * mFaceX[other];
+      ny += weight * mFaceY[other];
+      nz += weight * mFaceZ[other];
+    }
+    const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+    const float scale = (length > 0.0f) ? 1.0f / length : 0.0f;
+    mCornerX[c] = nx * scale;
+    mCornerY[c] = ny * scale;
+    mCornerZ[c] = nz * scale;
+  }
+}
@@ -1,14 +1,69 @@
 #include "ObjLoader.h"
 
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <future>
+
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "ObjParser.h"
+#include "ObjMeshAssembler.h"
+#include "PlyImporter.h"
+#include "StlImporter.h"
+#include "Parallel.h"
+#include "MeshWelder.h"
+#include "NormalGenerator.h"
+#include "TangentGenerator.h"
+#include "VertexCacheOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ClusterBuilder.h"
+
+// files are split into chunks of at least this size for parallel import //
+static const size_t MIN_CHUNK_SIZE = 1 << 20;
+
+struct ObjLoader::PendingImport {
+  PendingImport() : meshObj(NULL), fromCache(false), success(false) {};
+  
+  std::string fileName;
+  std::string ID;
+  // copy of the loader's settings when the import was started //
+  ImportSettings settings;
+  MeshObj *meshObj;
+  // an up to date binary cache is mapped and uploaded straight from the mapping //
+  MeshCache cache;
+  // otherwise the text file is imported into 'meshData' //
+  MeshData meshData;
+  bool fromCache;
+  bool success;
+  // set for background imports //
+  std::future<void> finished;
+};
 
 ObjLoader::ObjLoader() {
+  mSettings.threadCount = 0;
+  mSettings.useMeshCache = true;
+  mSettings.weldVertices = true;
+  mSettings.weldTolerance = 1e-6f;
+  mSettings.normalCreaseAngle = 60.0f;
+  mSettings.optimizeVertexCache = true;
+  mSettings.generateLods = true;
+  mSettings.buildClusters = false;
+  mVertexFormat = VERTEX_FORMAT_FLOAT;
 }
 
 ObjLoader::~ObjLoader() {
+  // wait for background imports, their MeshObjs are deleted with the others //
+  for (std::list<PendingImport*>::iterator iter = mPendingImports.begin(); iter != mPendingImports.end(); ++iter) {
+    (*iter)->finished.wait();
+    delete *iter;
+  }
+  mPendingImports.clear();
+  for (std::vector<MeshObj*>::iterator iter = mFailedMeshes.begin(); iter != mFailedMeshes.end(); ++iter) {
+    delete *iter;
+  }
+  mFailedMeshes.clear();
   for (std::map<std::string, MeshObj*>::iterator iter = mMeshMap.begin(); iter != mMeshMap.end(); ++iter) {
     delete iter->second;
     iter->second = NULL;
@@ -28,200 +83,284 @@ MeshObj* ObjLoader::loadObjFile(std::string fileName, std::string ID) {
     return meshObj;
   }
   // ID is not known yet -> try to load mesh from file //
+  PendingImport import;
+  import.fileName = fileName;
+  import.settings = mSettings;
+  runImport(import);
+  if (!uploadImport(import)) {
+    return NULL;
+  }
+  meshObj = import.meshObj;
   
-  // import mesh from given file //
-  // setup variables used for parsing //
-  std::string key;
-  float x, y, z;
+  // insert MeshObj into map //
+  mMeshMap.insert(std::make_pair(ID, meshObj));
+  
+  // return newly created MeshObj //
+  return meshObj;
+}
 
-  // local lists //
-  // these lists are used to store the imported information
-  // before putting the data into the MeshData container for the MeshObj
-  std::vector<glm::vec3> localVertexPosition;
-  std::vector<glm::vec3> localVertexNormal;
-  std::vector<glm::vec2> localVertexTexcoord;
-  std::vector<std::vector<glm::vec3> > localFace;
+MeshObj* ObjLoader::loadObjFileAsync(std::string fileName, std::string ID) {
+  // sanity check for identfier -> must not be empty //
+  if (ID.length() == 0) {
+    return NULL;
+  }
+  // a known ID (loaded or still loading) is returned directly //
+  MeshObj* meshObj = getMeshObj(ID);
+  if (meshObj != NULL) {
+    return meshObj;
+  }
   
-  // setup tools for parsing a line correctly //
-  std::string line;
-  std::stringstream sstr;
+  // the MeshObj exists right away, so it can be placed in the scene -> it gets its data later //
+  PendingImport *pending = new PendingImport();
+  pending->fileName = fileName;
+  pending->ID = ID;
+  pending->settings = mSettings;
+  pending->meshObj = new MeshObj();
+  pending->finished = std::async(std::launch::async, &ObjLoader::runImport, this, std::ref(*pending));
+  mPendingImports.push_back(pending);
+  
+  mMeshMap.insert(std::make_pair(ID, pending->meshObj));
+  return pending->meshObj;
+}
 
-  // open file //
-  unsigned int lineNumber = 0;
-  std::ifstream file(fileName.c_str());
-  if (file.is_open()) {
-    while (file.good()) {
-      key = "";
-      getline(file, line);
-      sstr.clear();
-      sstr.str(line);
-      sstr >> key;
-      if (!key.compare("v")) {
-        // read in vertex //
-        sstr >> x >> y >> z;
-	localVertexPosition.push_back(glm::vec3(x, y, z));
-      }
-      // implement parsing of vertex normal and tecture coordinate //
-      if (!key.compare("vn")) {
-        // read in vertex normal //
-        sstr >> x >> y >> z;
-	localVertexNormal.push_back(glm::vec3(x, y, z));
-      }
-      if (!key.compare("vt")) {
-        // read in vertex normal //
-        sstr >> x >> y;
-	localVertexTexcoord.push_back(glm::vec2(x, y));
+unsigned int ObjLoader::processFinishedImports(void) {
+  unsigned int uploadCount = 0;
+  std::list<PendingImport*>::iterator iter = mPendingImports.begin();
+  while (iter != mPendingImports.end()) {
+    PendingImport *pending = *iter;
+    if (pending->finished.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      ++iter;
+      continue;
+    }
+    // import done -> upload on this (the GL) thread //
+    if (uploadImport(*pending)) {
+      ++uploadCount;
+    } else {
+      // the ID is unknown again as after a failed loadObjFile() -> getMeshObj() returns NULL, a new load retries //
+      // the empty MeshObj stays alive with the loader, the pointer returned by loadObjFileAsync() remains valid
+      std::cout << "(ObjLoader::processFinishedImports) - ERROR: Could not import \"" << pending->fileName << "\"" << std::endl;
+      std::map<std::string, MeshObj*>::iterator entry = mMeshMap.find(pending->ID);
+      if (entry != mMeshMap.end() && entry->second == pending->meshObj) {
+        mMeshMap.erase(entry);
       }
-      // implement parsing of a face definition //
-      // note: faces using normals and tex-coords are defines as "f vi0/ti0/ni0 ... viN/tiN/niN"
-      //       vi0 .. viN : vertex index of vertex 0..N
-      //       ti0 .. tiN : texture coordinate index of vertex 0..N
-      //       ni0 .. niN : vertex normal index of vertex 0..N
-      //       faces without normals and texCoords are defined as  "f vi0// ... viN//"
-      //       faces without texCoords are defined as              "f vi0//ni0 ... viN//niN"
-      //       make your parser robust against ALL possible combinations
-      //       also allow to import QUADS as faces. directly split them up into two triangles!
-      // put every face definition into the 'localFace' vector
-      // -> a face is represented as set of index triplets (vertexId, normalId, texCoordId)
-      //    thus is can be stored in a std::vector<glm::vec3>
-      if (!key.compare("f")) {
-	// read in vertex indices for a face //
-        unsigned int vCount = 0;
-	// indices for vertex (vi), normal (ni) and texture (ti) //
-	int vi[4];
-	int ni[4];
-	int ti[4];
-  
-        sstr.peek();
-        while (sstr.good() && vCount < 4) {
-          sstr >> vi[vCount];
-          if (!sstr.good()) {
-            // import of vertex index failed -> end of line reached //
-            vi[vCount] = 0;
-          } else {
-            // vertex index import successful -> try to load texture and normal indices //
-            if (sstr.peek() == '/') {
-              sstr.get(); // skip '/' symbol //
-              if (sstr.peek() != '/') {
-                // there is a texture coordinate //
-                sstr >> ti[vCount];
-              } else {
-                ti[vCount] = 0;
-              }
-              sstr.get(); // skip '/' symbol //
-              sstr >> ni[vCount];
-            } else {
-              ti[vCount] = 0;
-              ni[vCount] = 0;
-            }
-            ++vCount;
-          }
-        }
-        
-        // insert index data into face //
-        if (vCount < 3) {
-          std::cout << "(ObjLoader::loadObjFile) - WARNING: Malformed face in line " << lineNumber << std::endl;
-          continue; // not a real face //
-        } else if (vCount > 3) {
-          // quad face loaded -> split into two triangles (0,1,2) and (0,2,3) //
-          std::vector<glm::vec3> face0, face1;
-	  for (unsigned int v = 0; v < vCount; ++v) {
-            if (v < 3) {
-	      face0.push_back(glm::vec3(vi[v] - 1, ni[v] - 1, ti[v] - 1));
-            }
-            if (v != 1) {
-              face1.push_back(glm::vec3(vi[v] - 1, ni[v] - 1, ti[v] - 1));
-            }
-          }
-	  localFace.push_back(face0);
-	  localFace.push_back(face1);
-        } else {
-          std::vector<glm::vec3> face;
-          for (unsigned int v = 0; v < vCount; ++v) {
-	    face.push_back(glm::vec3(vi[v] - 1, ni[v] - 1, ti[v] - 1));
-          }
-          localFace.push_back(face);
-        }
+      mFailedMeshes.push_back(pending->meshObj);
+    }
+    delete pending;
+    iter = mPendingImports.erase(iter);
+  }
+  return uploadCount;
+}
+
+void ObjLoader::runImport(PendingImport &pending) {
+  // an up to date binary cache skips the text import completely //
+  // only the copied settings are used -> the loader may be changed meanwhile //
+  const ImportSettings &settings = pending.settings;
+  const uint64_t settingsHash = hashImportSettings(settings);
+  if (settings.useMeshCache && pending.cache.open(pending.fileName, settingsHash)) {
+    pending.fromCache = true;
+    pending.success = true;
+    return;
+  }
+  pending.success = importMeshFile(pending.fileName, pending.meshData, settings);
+  if (pending.success && settings.useMeshCache) {
+    MeshCache::write(pending.fileName, pending.meshData, settingsHash);
+  }
+}
+
+bool ObjLoader::uploadImport(PendingImport &pending) {
+  if (!pending.success) {
+    return false;
+  }
+  // create new MeshObj, if not done before //
+  if (pending.meshObj == NULL) {
+    pending.meshObj = new MeshObj();
+  }
+  // assign imported data to this MeshObj //
+  pending.meshObj->setVertexFormat(mVertexFormat);
+  if (pending.fromCache) {
+    // the cache pages are handed to the GL directly from the mapping //
+    const MeshCacheHeader &header = pending.cache.getHeader();
+    pending.meshObj->setInterleavedData(pending.cache.getVertexData(), header.vertexCount, header.attributeMask,
+                                        pending.cache.getIndexData(), header.indexCount);
+    std::vector<MeshLod> lods;
+    pending.cache.getLods(lods);
+    pending.meshObj->setLods(lods);
+    std::vector<MeshGroup> groups;
+    std::vector<std::string> materialLibraries;
+    pending.cache.getGroups(groups, materialLibraries);
+    pending.meshObj->setGroups(groups, materialLibraries);
+    std::vector<MeshCluster> clusters;
+    pending.cache.getClusters(clusters);
+    pending.meshObj->setClusters(clusters);
+    pending.cache.close();
+  } else {
+    pending.meshObj->setData(pending.meshData);
+    pending.meshData = MeshData();
+  }
+  return true;
+}
+
+bool ObjLoader::importObjFile(const std::string &fileName, MeshData &meshData) {
+  return importObjFile(fileName, meshData, mSettings);
+}
+
+bool ObjLoader::importObjFile(const std::string &fileName, MeshData &meshData, const ImportSettings &settings) {
+  // import mesh from given file //
+  // map the whole file into memory and scan it in place //
+  MappedFile file;
+  if (file.open(fileName)) {
+    const char *begin = file.data();
+    const char *end = begin + file.size();
+
+    // the assembler welds and indexes the triangles while they are read //
+    // OBJ files need roughly 100+ bytes per unique vertex -> initial size of the weld table
+    ObjMeshAssembler assembler(meshData, file.size() / 128);
+
+    // split large files at line boundaries and parse the chunks in parallel //
+    unsigned int chunkCount = resolveThreadCount(settings.threadCount);
+    if (chunkCount > 1) {
+      size_t maxChunkCount = file.size() / MIN_CHUNK_SIZE;
+      chunkCount = (unsigned int)std::min((size_t)chunkCount, std::max(maxChunkCount, (size_t)1));
+    }
+    std::vector<const char*> bounds;
+    splitObjChunks(begin, end, chunkCount, bounds);
+    chunkCount = bounds.size() - 1;
+
+    if (chunkCount == 1) {
+      // stream the file straight into the assembler //
+      parseObjLines(begin, end, assembler);
+    } else {
+      // chunks are parsed concurrently and assembled in file order afterwards //
+      std::vector<ObjChunk> chunks(chunkCount);
+      parallelFor(chunkCount, chunkCount, [&](unsigned int i) {
+        chunks[i].lineCount = parseObjLines(bounds[i], bounds[i + 1], chunks[i]);
+      });
+      for (unsigned int i = 0; i < chunkCount; ++i) {
+        assembler.appendChunk(chunks[i]);
       }
-      ++lineNumber;
     }
     file.close();
-    
-    std::cout << "Imported " << localFace.size() << " faces from \"" << fileName << "\"" << std::endl;
-    
-    // create an indexed vertex for every triplet of vertexId, normalId and texCoordId //
-    //  every face is able to use a different set of vertex normals and texture coordinates
-    //  when using a single vertex for multiple faces, however, this conflicts multiple normals
-    //  rearrange and complete the imported data in the following way:
-    //  - if a vertex uses multiple normals and/or texture coordinates, create copies of that vertex
-    //  - every triplet (vertexId, texCoordId, normalId) is unique and indexed by meshData.indices
-    // one vertex definition per index-triplet (vertexId, texCoordId, normalId) //
-    // this vertex definition is distributed over the separate vertex attribute arrays
-    //  - meshData.vertex_position
-    //  - meshData.vertex_normal
-    //  - meshData.vertex_texcoord
-    // add a new set of values to these array, whenever adding a new vertex for a new triplet
-    // when adding this new vertex defintion, assign a new index to put into meshData.indices
-    // when reuisng a vertex definition of an already known triplet, reuse the index for that triplet and put it into meshData.indices
-    // hint: you might want to use a std::map to remember already known id-triplets and their indices
-    MeshData meshData;
-    std::map<std::string, unsigned int> vertexIdMap;
-    for (std::vector<std::vector<glm::vec3> >::iterator faceIter = localFace.begin(); faceIter != localFace.end(); ++faceIter) {
-      std::string vertexId("");
-      const char* idPattern = "%08d|%08d|%08d";
-      char idStr[27];
-      // iterate over face vertices //
-      for (unsigned int i = 0; i < 3; ++i) {
-	int vi = (*faceIter)[i][0];
-	int ni = (*faceIter)[i][1];
-	int ti = (*faceIter)[i][2];
-        sprintf(idStr, idPattern, vi, ni, ti);
-        vertexId = std::string(idStr);
-	// vertexId is now "vertexIndex/normalIndex/textureIndex" //
-        std::map<std::string, unsigned int>::iterator vertexIdIter = vertexIdMap.find(vertexId);
-        if (vertexIdIter == vertexIdMap.end()) {
-          // vertex not known yet -> insert new one //
-          unsigned int newIndex = meshData.vertex_position.size() / 3;
-	  // add vertex position data //
-          glm::vec3 position = localVertexPosition[vi];
-          meshData.vertex_position.push_back(position.x);
-	  meshData.vertex_position.push_back(position.y);
-	  meshData.vertex_position.push_back(position.z);
-          // add vertex normal data //
-          glm::vec3 normal = localVertexNormal[ni];
-          meshData.vertex_normal.push_back(normal.x);
-	  meshData.vertex_normal.push_back(normal.y);
-	  meshData.vertex_normal.push_back(normal.z);
-	  // add vertex texture coord data //
-	  glm::vec2 texcoord = localVertexTexcoord[ti];
-          meshData.vertex_texcoord.push_back(texcoord.x);
-	  meshData.vertex_texcoord.push_back(texcoord.y);
-	  // insert new index into index list AND index map //
-	  meshData.indices.push_back((GLuint)newIndex);
-	  vertexIdMap.insert(std::make_pair(vertexId, newIndex));
-        } else {
-	  // vertex already defined -> use index and add to indexList //
-          meshData.indices.push_back((GLuint)vertexIdIter->second);
-        }
-      }
+
+    const std::vector<unsigned int> &malformedLines = assembler.getMalformedLines();
+    for (size_t i = 0; i < malformedLines.size(); ++i) {
+      std::cout << "(ObjLoader::importObjFile) - WARNING: Malformed face in line " << malformedLines[i] << std::endl;
     }
+    if (assembler.getInvalidFaceCount() > 0) {
+      std::cout << "(ObjLoader::importObjFile) - WARNING: Skipped " << assembler.getInvalidFaceCount()
+                << " faces referencing undefined vertices" << std::endl;
+    }
+    std::cout << "Imported " << assembler.getTriangleCount() << " faces";
+    if (assembler.getGroupCount() > 1) {
+      std::cout << " in " << assembler.getGroupCount() << " groups";
+    }
+    std::cout << " from \"" << fileName << "\"" << std::endl;
     
-    // compute tangent space //
-    computeTangentSpace(meshData);
-    
-    // create new MeshObj and set imported geoemtry data //
-    meshObj = new MeshObj();
-    // assign imported data to this new MeshObj //
-    meshObj->setData(meshData);
-    
-    // insert MeshObj into map //
-    mMeshMap.insert(std::make_pair(ID, meshObj));
-    
-    // return newly created MeshObj //
-    return meshObj;
+    processImportedMesh(meshData, settings);
+    return true;
   } else {
-    std::cout << "(ObjLoader::loadObjFile) : Could not open file: \"" << fileName << "\"" << std::endl;
-    return NULL;
+    std::cout << "(ObjLoader::importObjFile) : Could not open file: \"" << fileName << "\"" << std::endl;
+    return false;
+  }
+}
+
+bool ObjLoader::importMeshFile(const std::string &fileName, MeshData &meshData) {
+  return importMeshFile(fileName, meshData, mSettings);
+}
+
+bool ObjLoader::importMeshFile(const std::string &fileName, MeshData &meshData, const ImportSettings &settings) {
+  // the format follows the extension, anything else is read as OBJ //
+  std::string extension = fileName.substr(std::min(fileName.rfind('.'), fileName.size()));
+  std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+  if (extension != ".ply" && extension != ".stl") {
+    return importObjFile(fileName, meshData, settings);
+  }
+
+  // binary files are read in place from the mapping as well //
+  MappedFile file;
+  if (!file.open(fileName)) {
+    std::cout << "(ObjLoader::importMeshFile) : Could not open file: \"" << fileName << "\"" << std::endl;
+    return false;
+  }
+  bool success;
+  std::string error;
+  if (extension == ".ply") {
+    PlyImporter importer;
+    success = importer.import(file.data(), file.size(), meshData);
+    error = importer.getError();
+    if (importer.getInvalidFaceCount() > 0) {
+      std::cout << "(ObjLoader::importMeshFile) - WARNING: Skipped " << importer.getInvalidFaceCount()
+                << " faces referencing undefined vertices" << std::endl;
+    }
+  } else {
+    StlImporter importer;
+    success = importer.import(file.data(), file.size(), meshData);
+    error = importer.getError();
+  }
+  file.close();
+  if (!success) {
+    std::cout << "(ObjLoader::importMeshFile) - ERROR: \"" << fileName << "\": " << error << std::endl;
+    meshData = MeshData();
+    return false;
+  }
+  std::cout << "Imported " << meshData.indices.size() / 3 << " faces from \"" << fileName << "\"" << std::endl;
+  processImportedMesh(meshData, settings);
+  return true;
+}
+
+void ObjLoader::processImportedMesh(MeshData &meshData, const ImportSettings &settings) {
+  // duplicated vertices would split the normals and the simplification of the mesh //
+  if (settings.weldVertices) {
+    MeshWelder welder;
+    welder.setPositionTolerance(settings.weldTolerance);
+    welder.setThreadCount(settings.threadCount);
+    unsigned int removedCount = welder.weld(meshData);
+    if (removedCount > 0) {
+      std::cout << "Welded " << removedCount << " vertices" << std::endl;
+    }
+  }
+
+  // smooth normals for vertices the file gives none //
+  NormalGenerator normalGenerator;
+  normalGenerator.setCreaseAngle(settings.normalCreaseAngle);
+  normalGenerator.setThreadCount(settings.threadCount);
+  unsigned int generatedCount = normalGenerator.generate(meshData);
+  if (generatedCount > 0) {
+    std::cout << "Generated normals for " << generatedCount << " vertices" << std::endl;
+  }
+
+  // compute tangent space //
+  TangentGenerator tangentGenerator;
+  tangentGenerator.setThreadCount(settings.threadCount);
+  tangentGenerator.generate(meshData);
+
+  // simplified versions for distant copies, they share the vertices of the full mesh //
+  if (settings.generateLods && !meshData.indices.empty()) {
+    MeshSimplifier simplifier;
+    simplifier.generateLods(meshData);
+    std::cout << "Levels of detail:";
+    for (size_t l = 0; l < meshData.lods.size(); ++l) {
+      std::cout << (l > 0 ? "," : "") << " " << meshData.lods[l].indexCount / 3 << " (error " << meshData.lods[l].error << ")";
+    }
+    std::cout << std::endl;
+  }
+
+  // clusters of the full mesh, the vertex cache optimization keeps their triangles within them //
+  if (settings.buildClusters && !meshData.indices.empty()) {
+    ClusterBuilder builder;
+    builder.build(meshData);
+    std::cout << "Clusters: " << meshData.clusters.size() << std::endl;
+  }
+
+  // file order -> triangle order suited for the vertex cache //
+  if (settings.optimizeVertexCache && !meshData.indices.empty()) {
+    size_t vertexCount = meshData.vertex_position.size() / 3;
+    size_t fullIndexCount = meshData.lods.empty() ? meshData.indices.size() : meshData.lods[0].indexCount;
+    VertexCacheStats before = VertexCacheOptimizer::measure(&meshData.indices[0], fullIndexCount, vertexCount);
+    VertexCacheOptimizer optimizer;
+    optimizer.optimize(meshData);
+    VertexCacheStats after = VertexCacheOptimizer::measure(&meshData.indices[0], fullIndexCount, vertexCount);
+    std::cout << "Vertex cache: ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr
+              << std::endl;
   }
 }
 
@@ -238,85 +377,21 @@ MeshObj* ObjLoader::getMeshObj(std::string ID) {
   return NULL;
 }
 
-void ObjLoader::computeTangentSpace(MeshData &meshData) {
-  // reserve memory for tangents and binormals -> same count as vertices //
-  meshData.vertex_tangent.resize(meshData.vertex_position.size(), 0);
-  meshData.vertex_binormal.resize(meshData.vertex_position.size(), 0);
-  
-  // iterator over faces (given by index triplets) and calculate tangents for each incident vertex //
-  unsigned int indexCount = meshData.indices.size();
-  for (unsigned int i = 0; i < (indexCount - 2); i += 3) {
-    // get the 3 vertices and the 3 texture coordinates for this face //
-    glm::vec3 v[3];
-    glm::vec2 t[3];
-    int positionIndex[3];
-    int textureIndex[3];
-    for (int j = 0; j < 3; ++j) {
-      positionIndex[j] = 3 * meshData.indices[i+j];
-      textureIndex[j] = 2 * meshData.indices[i+j];
-      v[j] = glm::vec3(meshData.vertex_position[positionIndex[j]],
-		       meshData.vertex_position[positionIndex[j] + 1],
-		       meshData.vertex_position[positionIndex[j] + 2]);
-      t[j] = glm::vec2(meshData.vertex_texcoord[textureIndex[j]],
-		       meshData.vertex_texcoord[textureIndex[j] + 1]);
-    }
-    
-    // compute traingle edges Q1, Q2 //
-    glm::vec3 Q1 = v[1] - v[0];
-    glm::vec3 Q2 = v[2] - v[0];
-    
-    // compute dU and dV //
-    GLfloat du1 = t[1].x - t[0].x;
-    GLfloat dv1 = t[1].y - t[0].y;
-    GLfloat du2 = t[2].x - t[0].x;
-    GLfloat dv2 = t[2].y - t[0].y;
-                     
-    // compute determinant //
-    GLfloat det = du1 * dv2 - dv1 * du2;
-    
-    // compute the tangent for this triangle //
-    glm::vec3 tangent(1, 0, 0);
-    if (det != 0) {
-      GLfloat invDet = 1.0f / det;
-      // compute only tangent (binormal gets recomputed later anyways) //
-      tangent = (Q1 * dv2 - Q2 * dv1) * invDet;
-    }
-    // add tangent to all vertex tangents of this face //
-    // this will average all the tangents from the incident faces for each vertex //
-    for (int j = 0; j < 3; ++j) {
-      meshData.vertex_tangent[positionIndex[j]] += tangent.x;
-      meshData.vertex_tangent[positionIndex[j] + 1] += tangent.y;
-      meshData.vertex_tangent[positionIndex[j] + 2] += tangent.z;
-    }
-  }
-  
-  // use gram-schmidt approach to reorthogonalize tangent to normal //
-  unsigned int vertexCount = meshData.vertex_position.size();
-  for (unsigned int i = 0; i < (vertexCount - 2); i += 3) {
-    glm::vec3 tangent = glm::vec3(meshData.vertex_tangent[i],
-				  meshData.vertex_tangent[i + 1],
-				  meshData.vertex_tangent[i + 2]);
-    tangent = glm::normalize(tangent);
-    
-    glm::vec3 normal = glm::vec3(meshData.vertex_normal[i],
-				 meshData.vertex_normal[i + 1],
-				 meshData.vertex_normal[i + 2]);
-    
-    GLfloat NdotT = glm::dot(normal, tangent);
-    
-    for (unsigned int j = 0; j < 3; ++j) {
-      tangent[j] = tangent[j] - NdotT * normal[j];
-    }
-    tangent = glm::normalize(tangent);
-    
-    // cross product of tangent and normal yields binormal //
-    glm::vec3 binormal = glm::cross(tangent, normal);
-    binormal = glm::normalize(binormal);
-    
-    // set values back into meshData //
-    for (int j = 0; j < 3; ++j) {
-      meshData.vertex_tangent[i+j] = tangent[j];
-      meshData.vertex_binormal[i+j] = binormal[j];
-    }
+
+uint64_t ObjLoader::hashImportSettings(const ImportSettings &settings) {
+  // FNV-1a over the settings that change the imported data //
+  // thread count and cache use do not change it -> not part of the hash
+  unsigned char data[sizeof(float) * 2 + 4];
+  memcpy(data, &settings.weldTolerance, sizeof(float));
+  memcpy(data + sizeof(float), &settings.normalCreaseAngle, sizeof(float));
+  data[sizeof(float) * 2] = settings.weldVertices;
+  data[sizeof(float) * 2 + 1] = settings.optimizeVertexCache;
+  data[sizeof(float) * 2 + 2] = settings.generateLods;
+  data[sizeof(float) * 2 + 3] = settings.buildClusters;
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    hash ^= data[i];
+    hash *= 1099511628211ULL;
   }
+  return hash;
 }
@@ -0,0 +1,173 @@
+#include "ObjMeshAssembler.h"
+
+#include <algorithm>
+
+ObjMeshAssembler::ObjMeshAssembler(MeshData &meshData, size_t expectedVertexCount)
+  : mMeshData(meshData), mWelder(expectedVertexCount), mGroupChanged(false), mInvalidFaceCount(0), mLineOffset(0) {
+}
+
+void ObjMeshAssembler::setGroupName(const std::string &name) {
+  mGroupName = name;
+  mGroupChanged = true;
+}
+
+void ObjMeshAssembler::setMaterial(const std::string &name) {
+  mMaterial = name;
+  mGroupChanged = true;
+}
+
+void ObjMeshAssembler::addMaterialLibrary(const std::string &fileName) {
+  std::vector<std::string> &libraries = mMeshData.materialLibraries;
+  if (std::find(libraries.begin(), libraries.end(), fileName) == libraries.end()) {
+    libraries.push_back(fileName);
+  }
+}
+
+void ObjMeshAssembler::addFace(const int *face, const unsigned char *relative, unsigned int vertexCount) {
+  // relative indices have been resolved against all records so far -> nothing to rebase //
+  (void)relative;
+  int recordCount[3];
+  recordCount[0] = (int)mPositions.size();
+  recordCount[1] = (int)mNormals.size();
+  recordCount[2] = (int)mTexcoords.size();
+  addPolygon(face, vertexCount, recordCount);
+}
+
+void ObjMeshAssembler::addPolygon(const int *face, unsigned int vertexCount, const int *recordCount) {
+  // references to vertices which do not exist (yet) make the face invalid //
+  for (unsigned int c = 0; c < 3 * vertexCount; c += 3) {
+    if (face[c] < 0 || face[c] >= recordCount[0]) {
+      ++mInvalidFaceCount;
+      return;
+    }
+  }
+  // groups are started lazily -> records without faces in between do not leave empty groups //
+  std::vector<MeshGroup> &groups = mMeshData.groups;
+  if (groups.empty() || (mGroupChanged && (groups.back().name != mGroupName || groups.back().material != mMaterial))) {
+    MeshGroup group;
+    group.name = mGroupName;
+    group.material = mMaterial;
+    group.firstIndex = mMeshData.indices.size();
+    groups.push_back(group);
+  }
+  mGroupChanged = false;
+  if (vertexCount == 3) {
+    for (unsigned int c = 0; c < 9; c += 3) {
+      addCorner(face[c], face[c + 1], face[c + 2], recordCount);
+    }
+    return;
+  }
+  // larger polygons are split up by their corner positions //
+  mPolygonPoints.resize(vertexCount);
+  for (unsigned int i = 0; i < vertexCount; ++i) {
+    mPolygonPoints[i] = mPositions[face[3 * i]];
+  }
+  unsigned int triangleCount = mTriangulator.triangulate(&mPolygonPoints[0], vertexCount);
+  const unsigned int *triangles = mTriangulator.getTriangles();
+  for (unsigned int i = 0; i < 3 * triangleCount; ++i) {
+    const int *corner = &face[3 * triangles[i]];
+    addCorner(corner[0], corner[1], corner[2], recordCount);
+  }
+}
+
+void ObjMeshAssembler::addCorner(int vi, int ni, int ti, const int *recordCount) {
+  // undefined or invalid normals and texture coordinates are treated as not given //
+  if (ni >= recordCount[1]) {
+    ni = -1;
+  }
+  if (ti >= recordCount[2]) {
+    ti = -1;
+  }
+  // every triplet (vertexId, normalId, texCoordId) is a unique vertex //
+  //  - if a vertex uses multiple normals and/or texture coordinates, copies of that vertex are created
+  //  - the welder hands out a new index for unknown triplets and the known index otherwise
+  unsigned int index;
+  if (mWelder.weld(vi, ni, ti, index)) {
+    // vertex not known yet -> add its attributes //
+    const glm::vec3 &position = mPositions[vi];
+    mMeshData.vertex_position.push_back(position.x);
+    mMeshData.vertex_position.push_back(position.y);
+    mMeshData.vertex_position.push_back(position.z);
+    // add vertex normal data //
+    glm::vec3 normal = (ni >= 0) ? mNormals[ni] : glm::vec3(0);
+    mMeshData.vertex_normal.push_back(normal.x);
+    mMeshData.vertex_normal.push_back(normal.y);
+    mMeshData.vertex_normal.push_back(normal.z);
+    // add vertex texture coord data //
+    glm::vec2 texcoord = (ti >= 0) ? mTexcoords[ti] : glm::vec2(0);
+    mMeshData.vertex_texcoord.push_back(texcoord.x);
+    mMeshData.vertex_texcoord.push_back(texcoord.y);
+  }
+  mMeshData.indices.push_back((GLuint)index);
+
+  // extend the current group //
+  MeshGroup &group = mMeshData.groups.back();
+  const glm::vec3 &position = mPositions[vi];
+  for (unsigned int k = 0; k < 3; ++k) {
+    if (group.indexCount == 0 || position[k] < group.boundsMin[k]) group.boundsMin[k] = position[k];
+    if (group.indexCount == 0 || position[k] > group.boundsMax[k]) group.boundsMax[k] = position[k];
+  }
+  ++group.indexCount;
+}
+
+void ObjMeshAssembler::applyStateChange(const ObjChunk::StateChange &change) {
+  switch (change.type) {
+    case ObjChunk::StateChange::GROUP_NAME:
+      setGroupName(change.value);
+      break;
+    case ObjChunk::StateChange::MATERIAL:
+      setMaterial(change.value);
+      break;
+    case ObjChunk::StateChange::MATERIAL_LIBRARY:
+      addMaterialLibrary(change.value);
+      break;
+  }
+}
+
+void ObjMeshAssembler::appendChunk(ObjChunk &chunk) {
+  // element counts of all preceding lines -> base for relative indices //
+  int base[3];
+  base[0] = (int)mPositions.size();
+  base[1] = (int)mNormals.size();
+  base[2] = (int)mTexcoords.size();
+
+  mPositions.insert(mPositions.end(), chunk.positions.begin(), chunk.positions.end());
+  mNormals.insert(mNormals.end(), chunk.normals.begin(), chunk.normals.end());
+  mTexcoords.insert(mTexcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+  std::vector<glm::vec3>().swap(chunk.positions);
+  std::vector<glm::vec3>().swap(chunk.normals);
+  std::vector<glm::vec2>().swap(chunk.texcoords);
+
+  std::vector<int> &corners = chunk.corners;
+  for (size_t i = 0; i < chunk.relativeCorners.size(); ++i) {
+    size_t slot = chunk.relativeCorners[i];
+    corners[slot] += base[slot % 3];
+  }
+  for (size_t i = 0; i < chunk.malformedLines.size(); ++i) {
+    mMalformedLines.push_back(mLineOffset + chunk.malformedLines[i]);
+  }
+  // faces and state records in file order //
+  // each face is checked against the records read before it, as in the serial import
+  size_t c = 0;
+  size_t change = 0;
+  size_t count = 0;
+  int recordCount[3] = {base[0], base[1], base[2]};
+  for (size_t f = 0; f < chunk.faceSizes.size(); ++f) {
+    for (; change < chunk.stateChanges.size() && chunk.stateChanges[change].faceIndex <= f; ++change) {
+      applyStateChange(chunk.stateChanges[change]);
+    }
+    for (; count < chunk.recordCounts.size() && chunk.recordCounts[count].faceIndex <= f; ++count) {
+      for (unsigned int k = 0; k < 3; ++k) {
+        recordCount[k] = base[k] + chunk.recordCounts[count].count[k];
+      }
+    }
+    addPolygon(&corners[c], chunk.faceSizes[f], recordCount);
+    c += 3 * chunk.faceSizes[f];
+  }
+  for (; change < chunk.stateChanges.size(); ++change) {
+    applyStateChange(chunk.stateChanges[change]);
+  }
+  mLineOffset += chunk.lineCount;
+
+  chunk = ObjChunk();
+}
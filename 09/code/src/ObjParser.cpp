@@ -0,0 +1,347 @@
+#include "ObjParser.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cfloat>
+#include <climits>
+
+// #INFO# helpers for scanning the memory mapped file in place //
+// all of them work on the range [cursor, end) and return the position after the consumed characters
+
+static inline bool isBlank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool isLineEnd(char c) {
+  return c == '\n' || c == '#';
+}
+
+static inline bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+static inline const char* skipBlanks(const char *cursor, const char *end) {
+  while (cursor < end && isBlank(*cursor)) {
+    ++cursor;
+  }
+  return cursor;
+}
+
+static inline const char* skipLine(const char *cursor, const char *end) {
+  while (cursor < end && *cursor != '\n') {
+    ++cursor;
+  }
+  return (cursor < end) ? cursor + 1 : end;
+}
+
+// true if the line at 'cursor' starts with 'keyword' followed by a blank //
+static inline bool isKeyword(const char *cursor, const char *end, const char *keyword, size_t length) {
+  return (size_t)(end - cursor) > length && memcmp(cursor, keyword, length) == 0 && isBlank(cursor[length]);
+}
+
+// reads a name up to the next blank (or the end of line if 'toLineEnd' is set), trailing blanks are cut off //
+static inline const char* parseName(const char *cursor, const char *end, bool toLineEnd, std::string &name) {
+  cursor = skipBlanks(cursor, end);
+  const char *start = cursor;
+  while (cursor < end && !isLineEnd(*cursor) && (toLineEnd || !isBlank(*cursor))) {
+    ++cursor;
+  }
+  const char *nameEnd = cursor;
+  while (nameEnd > start && isBlank(nameEnd[-1])) {
+    --nameEnd;
+  }
+  name.assign(start, nameEnd);
+  return cursor;
+}
+
+// parses a (signed) decimal integer, returns 'cursor' if there is none //
+// values beyond the int range are clamped to +-INT_MAX -> rejected as out of range instead of wrapping around
+static inline const char* parseInt(const char *cursor, const char *end, int &value) {
+  const char *start = cursor;
+  bool negative = false;
+  if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+    negative = (*cursor == '-');
+    ++cursor;
+  }
+  if (cursor == end || !isDigit(*cursor)) {
+    value = 0;
+    return start;
+  }
+  int result = 0;
+  while (cursor < end && isDigit(*cursor)) {
+    const int digit = *cursor - '0';
+    result = (result > (INT_MAX - digit) / 10) ? INT_MAX : 10 * result + digit;
+    ++cursor;
+  }
+  value = negative ? -result : result;
+  return cursor;
+}
+
+// parses a floating point number (leading blanks are skipped) //
+// the common case of a short decimal number is handled without strtof, the
+// result is the same correctly rounded value 'operator>>' would produce
+static const char* parseFloat(const char *cursor, const char *end, float &value) {
+  static const float floatPow10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+  static const double doublePow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  cursor = skipBlanks(cursor, end);
+  const char *start = cursor;
+
+  bool negative = false;
+  if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+    negative = (*cursor == '-');
+    ++cursor;
+  }
+  // collect the significant digits and the decimal exponent //
+  unsigned long long mantissa = 0;
+  int digitCount = 0;
+  int exponent = 0;
+  bool anyDigit = false;
+  while (cursor < end && isDigit(*cursor)) {
+    if (mantissa != 0 || *cursor != '0') {
+      ++digitCount;
+    }
+    mantissa = 10 * mantissa + (*cursor - '0');
+    anyDigit = true;
+    ++cursor;
+  }
+  if (cursor < end && *cursor == '.') {
+    ++cursor;
+    while (cursor < end && isDigit(*cursor)) {
+      if (mantissa != 0 || *cursor != '0') {
+        ++digitCount;
+      }
+      mantissa = 10 * mantissa + (*cursor - '0');
+      --exponent;
+      anyDigit = true;
+      ++cursor;
+    }
+  }
+  if (anyDigit && cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+    int exponentValue = 0;
+    const char *next = parseInt(cursor + 1, end, exponentValue);
+    if (next != cursor + 1) {
+      // a clamped exponent saturates -> far outside the fast paths below, strtof sees the original text //
+      if (exponentValue > 0 && exponent > INT_MAX - exponentValue) {
+        exponent = INT_MAX;
+      } else if (exponentValue < 0 && exponent < INT_MIN - exponentValue) {
+        exponent = INT_MIN;
+      } else {
+        exponent += exponentValue;
+      }
+      cursor = next;
+    }
+  }
+
+  if (anyDigit && digitCount <= 19) {
+    if (mantissa <= (1ULL << 24) && exponent >= -10 && exponent <= 10) {
+      // mantissa and power of ten are exact floats -> one correctly rounded operation //
+      float result = (float)mantissa;
+      result = (exponent < 0) ? result / floatPow10[-exponent] : result * floatPow10[exponent];
+      value = negative ? -result : result;
+      return cursor;
+    }
+    if (mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+      double result = (double)mantissa;
+      result = (exponent < 0) ? result / doublePow10[-exponent] : result * doublePow10[exponent];
+      // rounding double -> float is only ambiguous if the double lies exactly between two floats //
+      unsigned long long bits;
+      memcpy(&bits, &result, sizeof(bits));
+      if ((bits & 0x1FFFFFFFULL) != 0x10000000ULL && (result == 0.0 || result >= FLT_MIN)) {
+        value = (float)(negative ? -result : result);
+        return cursor;
+      }
+    }
+  }
+
+  // rare case (long mantissa, huge exponent, inf, nan, ...) -> let the C library handle it //
+  char token[64];
+  size_t length = 0;
+  cursor = start;
+  while (cursor < end && length < sizeof(token) - 1 && !isBlank(*cursor) && !isLineEnd(*cursor)) {
+    token[length++] = *cursor++;
+  }
+  token[length] = '\0';
+  char *tokenEnd = token;
+  value = strtof(token, &tokenEnd);
+  return start + (tokenEnd - token);
+}
+
+// converts an OBJ index into a 0-based index relative to 'count' elements, -1 if undefined //
+// negative indices count back from the end of the list, these are flagged as 'relative'
+static inline int resolveIndex(int index, size_t count, bool &relative) {
+  relative = (index < 0);
+  if (index > 0) {
+    return index - 1;
+  }
+  if (index < 0) {
+    return (int)count + index;
+  }
+  return -1;
+}
+
+unsigned int parseObjLines(const char *begin, const char *end, ObjRecordHandler &handler) {
+  // setup variables used for parsing //
+  float x, y, z;
+  // records seen so far -> needed to resolve relative indices //
+  size_t positionCount = 0;
+  size_t normalCount = 0;
+  size_t texcoordCount = 0;
+  unsigned int lineCount = 0;
+  // index triplets (vertexId, normalId, texCoordId) of the current face and their relative flags //
+  // reused for all faces -> no allocation per face
+  std::vector<int> face;
+  std::vector<unsigned char> relative;
+  face.reserve(3 * 64);
+  relative.reserve(3 * 64);
+  std::string name;
+
+  const char *cursor = begin;
+  while (cursor < end) {
+    cursor = skipBlanks(cursor, end);
+    if (cursor == end) {
+      break;
+    }
+    if (cursor[0] == 'v' && cursor + 1 < end) {
+      if (isBlank(cursor[1])) {
+        // read in vertex //
+        cursor = parseFloat(cursor + 1, end, x);
+        cursor = parseFloat(cursor, end, y);
+        cursor = parseFloat(cursor, end, z);
+        handler.addPosition(glm::vec3(x, y, z));
+        ++positionCount;
+      } else if (cursor[1] == 'n' && cursor + 2 < end && isBlank(cursor[2])) {
+        // read in vertex normal //
+        cursor = parseFloat(cursor + 2, end, x);
+        cursor = parseFloat(cursor, end, y);
+        cursor = parseFloat(cursor, end, z);
+        handler.addNormal(glm::vec3(x, y, z));
+        ++normalCount;
+      } else if (cursor[1] == 't' && cursor + 2 < end && isBlank(cursor[2])) {
+        // read in vertex texcoord //
+        cursor = parseFloat(cursor + 2, end, x);
+        cursor = parseFloat(cursor, end, y);
+        handler.addTexcoord(glm::vec2(x, y));
+        ++texcoordCount;
+      }
+    } else if (cursor[0] == 'f' && cursor + 1 < end && isBlank(cursor[1])) {
+      // faces are defined as "f vi0/ti0/ni0 ... viN/tiN/niN"
+      //  - texture and normal indices are optional ("vi", "vi//ni", "vi/ti")
+      //  - negative indices are relative to the end of the respective list
+      // polygons of any size are handed out as a whole, triangulating them needs the positions
+      unsigned int vCount = 0;
+      face.clear();
+      relative.clear();
+
+      cursor = skipBlanks(cursor + 1, end);
+      while (cursor < end && !isLineEnd(*cursor)) {
+        int index = 0;
+        const char *next = parseInt(cursor, end, index);
+        if (next == cursor) {
+          // not a vertex index -> end of face definition //
+          break;
+        }
+        cursor = next;
+        int triplet[3] = {-1, -1, -1};
+        bool tripletRelative[3] = {false, false, false};
+        triplet[0] = resolveIndex(index, positionCount, tripletRelative[0]);
+        if (cursor < end && *cursor == '/') {
+          ++cursor; // skip '/' symbol //
+          if (cursor < end && *cursor != '/') {
+            // there is a texture coordinate //
+            cursor = parseInt(cursor, end, index);
+            triplet[2] = resolveIndex(index, texcoordCount, tripletRelative[2]);
+          }
+          if (cursor < end && *cursor == '/') {
+            ++cursor; // skip '/' symbol //
+            cursor = parseInt(cursor, end, index);
+            triplet[1] = resolveIndex(index, normalCount, tripletRelative[1]);
+          }
+        }
+        for (unsigned int k = 0; k < 3; ++k) {
+          face.push_back(triplet[k]);
+          relative.push_back(tripletRelative[k]);
+        }
+        ++vCount;
+        cursor = skipBlanks(cursor, end);
+      }
+
+      if (vCount < 3) {
+        // not a real face //
+        handler.addMalformedFace(lineCount + 1);
+      } else {
+        handler.addFace(&face[0], &relative[0], vCount);
+      }
+    } else if ((cursor[0] == 'o' || cursor[0] == 'g') && cursor + 1 < end && (isBlank(cursor[1]) || isLineEnd(cursor[1]))) {
+      // object and group names apply to the following faces, no name -> default group //
+      cursor = parseName(cursor + 1, end, true, name);
+      handler.setGroupName(name);
+    } else if (isKeyword(cursor, end, "usemtl", 6)) {
+      cursor = parseName(cursor + 6, end, true, name);
+      handler.setMaterial(name);
+    } else if (isKeyword(cursor, end, "mtllib", 6)) {
+      // a list of material files //
+      cursor += 6;
+      while (true) {
+        cursor = parseName(cursor, end, false, name);
+        if (name.empty()) {
+          break;
+        }
+        handler.addMaterialLibrary(name);
+      }
+    }
+    // ignore the remainder of this line (comments, unsupported keys, ...) //
+    cursor = skipLine(cursor, end);
+    ++lineCount;
+  }
+  return lineCount;
+}
+
+void splitObjChunks(const char *begin, const char *end, unsigned int chunkCount, std::vector<const char*> &bounds) {
+  bounds.clear();
+  bounds.push_back(begin);
+  size_t size = end - begin;
+  for (unsigned int i = 1; i < chunkCount; ++i) {
+    // move the split point to the start of the next line //
+    const char *split = begin + (size * i) / chunkCount;
+    if (split <= bounds.back()) {
+      continue;
+    }
+    const char *lineEnd = static_cast<const char*>(memchr(split - 1, '\n', end - (split - 1)));
+    if (lineEnd == NULL) {
+      break;
+    }
+    split = lineEnd + 1;
+    if (split > bounds.back() && split < end) {
+      bounds.push_back(split);
+    }
+  }
+  bounds.push_back(end);
+}
+
+void ObjChunk::addFace(const int *face, const unsigned char *relative, unsigned int vertexCount) {
+  RecordCount recordCount;
+  recordCount.faceIndex = faceSizes.size();
+  recordCount.count[0] = (int)positions.size();
+  recordCount.count[1] = (int)normals.size();
+  recordCount.count[2] = (int)texcoords.size();
+  if (recordCounts.empty() || memcmp(recordCounts.back().count, recordCount.count, sizeof(recordCount.count)) != 0) {
+    recordCounts.push_back(recordCount);
+  }
+  for (unsigned int i = 0; i < 3 * vertexCount; ++i) {
+    if (relative[i]) {
+      relativeCorners.push_back(corners.size());
+    }
+    corners.push_back(face[i]);
+  }
+  faceSizes.push_back(vertexCount);
+}
+
+void ObjChunk::addStateChange(StateChange::Type type, const std::string &value) {
+  StateChange change;
+  change.type = type;
+  change.faceIndex = faceSizes.size();
+  change.value = value;
+  stateChanges.push_back(change);
+}
@@ -0,0 +1,432 @@
+#include "PlyImporter.h"
+
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+#include "ByteSwap.h"
+
+// vertex properties used, with their alternative names -> position (0 - 2), normal (3 - 5), texcoord (6, 7) //
+static const struct {
+  const char *name;
+  unsigned int component;
+} VERTEX_PROPERTIES[] = {{"x", 0}, {"y", 1}, {"z", 2}, {"nx", 3}, {"ny", 4}, {"nz", 5},
+                         {"u", 6}, {"s", 6}, {"texture_u", 6}, {"v", 7}, {"t", 7}, {"texture_v", 7}};
+static const unsigned int COMPONENT_COUNT = 8;
+
+PlyImporter::PlyImporter() {
+  mVertexCount = 0;
+  mSwap = false;
+  mInvalidFaceCount = 0;
+}
+
+PlyImporter::Type PlyImporter::parseType(const std::string &name) {
+  // the original names and the sized ones of newer exporters //
+  if (name == "char" || name == "int8") return TYPE_INT8;
+  if (name == "uchar" || name == "uint8") return TYPE_UINT8;
+  if (name == "short" || name == "int16") return TYPE_INT16;
+  if (name == "ushort" || name == "uint16") return TYPE_UINT16;
+  if (name == "int" || name == "int32") return TYPE_INT32;
+  if (name == "uint" || name == "uint32") return TYPE_UINT32;
+  if (name == "float" || name == "float32") return TYPE_FLOAT32;
+  if (name == "double" || name == "float64") return TYPE_FLOAT64;
+  return TYPE_INVALID;
+}
+
+size_t PlyImporter::getTypeSize(Type type) {
+  switch (type) {
+    case TYPE_INT8: case TYPE_UINT8: return 1;
+    case TYPE_INT16: case TYPE_UINT16: return 2;
+    case TYPE_INT32: case TYPE_UINT32: case TYPE_FLOAT32: return 4;
+    case TYPE_FLOAT64: return 8;
+    default: return 0;
+  }
+}
+
+double PlyImporter::readValue(const char *data, Type type, bool swap) {
+  char bytes[8];
+  const size_t size = getTypeSize(type);
+  std::memcpy(bytes, data, size);
+  if (swap) {
+    std::reverse(bytes, bytes + size);
+  }
+  switch (type) {
+    case TYPE_INT8: { int8_t value; std::memcpy(&value, bytes, 1); return value; }
+    case TYPE_UINT8: { uint8_t value; std::memcpy(&value, bytes, 1); return value; }
+    case TYPE_INT16: { int16_t value; std::memcpy(&value, bytes, 2); return value; }
+    case TYPE_UINT16: { uint16_t value; std::memcpy(&value, bytes, 2); return value; }
+    case TYPE_INT32: { int32_t value; std::memcpy(&value, bytes, 4); return value; }
+    case TYPE_UINT32: { uint32_t value; std::memcpy(&value, bytes, 4); return value; }
+    case TYPE_FLOAT32: { float value; std::memcpy(&value, bytes, 4); return value; }
+    case TYPE_FLOAT64: { double value; std::memcpy(&value, bytes, 8); return value; }
+    default: return 0.0;
+  }
+}
+
+bool PlyImporter::import(const char *data, size_t size, MeshData &meshData) {
+  mError.clear();
+  mInvalidFaceCount = 0;
+  size_t headerSize = 0;
+  if (!parseHeader(data, size, headerSize)) {
+    return false;
+  }
+
+  const char *cursor = data + headerSize;
+  const char *end = data + size;
+  for (size_t e = 0; e < mElements.size(); ++e) {
+    const Element &element = mElements[e];
+    bool success;
+    if (element.name == "vertex") {
+      success = readVertices(element, cursor, end, meshData);
+    } else if (element.name == "face") {
+      success = readFaces(element, cursor, end, meshData);
+    } else {
+      success = skipElement(element, cursor, end);
+    }
+    if (!success) {
+      return false;
+    }
+  }
+
+  if (!meshData.indices.empty()) {
+    removeUnusedVertices(meshData);
+  }
+
+  // one group with the bounds of the used vertices, like an OBJ file without groups //
+  MeshGroup group;
+  group.indexCount = meshData.indices.size();
+  for (size_t i = 0; i < meshData.indices.size(); ++i) {
+    const GLfloat *position = &meshData.vertex_position[3 * meshData.indices[i]];
+    for (unsigned int k = 0; k < 3; ++k) {
+      if (i == 0 || position[k] < group.boundsMin[k]) group.boundsMin[k] = position[k];
+      if (i == 0 || position[k] > group.boundsMax[k]) group.boundsMax[k] = position[k];
+    }
+  }
+  meshData.groups.assign(1, group);
+  return true;
+}
+
+bool PlyImporter::parseHeader(const char *data, size_t size, size_t &headerSize) {
+  mElements.clear();
+  mVertexCount = 0;
+  const char *cursor = data;
+  const char *end = data + size;
+  if (size < 4 || std::memcmp(data, "ply", 3) != 0 || (data[3] != '\n' && data[3] != '\r')) {
+    mError = "no PLY file";
+    return false;
+  }
+  bool formatFound = false;
+  while (true) {
+    const char *lineEnd = std::find(cursor, end, '\n');
+    if (lineEnd == end) {
+      mError = "header without end_header";
+      return false;
+    }
+    std::istringstream line(std::string(cursor, lineEnd));
+    cursor = lineEnd + 1;
+    std::string keyword;
+    line >> keyword;
+    if (keyword == "ply" || keyword == "comment" || keyword == "obj_info" || keyword.empty()) {
+      continue;
+    }
+    if (keyword == "end_header") {
+      break;
+    }
+    if (keyword == "format") {
+      std::string format;
+      line >> format;
+      if (format == "binary_little_endian") {
+        mSwap = !isLittleEndianHost();
+      } else if (format == "binary_big_endian") {
+        mSwap = isLittleEndianHost();
+      } else {
+        mError = "format \"" + format + "\" is not supported, only binary PLY files are";
+        return false;
+      }
+      formatFound = true;
+    } else if (keyword == "element") {
+      Element element;
+      line >> element.name >> element.count;
+      if (line.fail()) {
+        mError = "malformed element";
+        return false;
+      }
+      element.recordSize = 0;
+      mElements.push_back(element);
+      if (element.name == "vertex") {
+        mVertexCount = element.count;
+      }
+    } else if (keyword == "property") {
+      if (mElements.empty()) {
+        mError = "property outside of an element";
+        return false;
+      }
+      Property property;
+      std::string typeName;
+      line >> typeName;
+      property.isList = (typeName == "list");
+      property.countType = TYPE_INVALID;
+      if (property.isList) {
+        std::string countTypeName;
+        line >> countTypeName >> typeName;
+        property.countType = parseType(countTypeName);
+      }
+      property.type = parseType(typeName);
+      line >> property.name;
+      if (line.fail() || property.type == TYPE_INVALID || (property.isList && property.countType == TYPE_INVALID)) {
+        mError = "malformed property";
+        return false;
+      }
+      mElements.back().properties.push_back(property);
+    } else {
+      mError = "unknown header line \"" + keyword + "\"";
+      return false;
+    }
+  }
+  if (!formatFound) {
+    mError = "no format given";
+    return false;
+  }
+
+  // records without lists have a fixed layout //
+  for (size_t e = 0; e < mElements.size(); ++e) {
+    Element &element = mElements[e];
+    size_t offset = 0;
+    for (size_t p = 0; p < element.properties.size() && offset != (size_t)-1; ++p) {
+      Property &property = element.properties[p];
+      property.offset = offset;
+      offset = property.isList ? (size_t)-1 : offset + getTypeSize(property.type);
+    }
+    element.recordSize = (offset == (size_t)-1) ? 0 : offset;
+  }
+  headerSize = cursor - data;
+  return true;
+}
+
+bool PlyImporter::readVertices(const Element &element, const char *&cursor, const char *end, MeshData &meshData) {
+  if (element.recordSize == 0) {
+    mError = "vertices with list properties are not supported";
+    return false;
+  }
+  if (element.count > 0xFFFFFFFFu || element.count > (size_t)(end - cursor) / element.recordSize) {
+    mError = "file ends within the vertices";
+    return false;
+  }
+  const size_t blockSize = element.count * element.recordSize;
+
+  // property read for each component, -1 if there is none //
+  int components[COMPONENT_COUNT];
+  std::fill(components, components + COMPONENT_COUNT, -1);
+  for (size_t p = 0; p < element.properties.size(); ++p) {
+    for (size_t n = 0; n < sizeof(VERTEX_PROPERTIES) / sizeof(VERTEX_PROPERTIES[0]); ++n) {
+      if (element.properties[p].name == VERTEX_PROPERTIES[n].name && components[VERTEX_PROPERTIES[n].component] < 0) {
+        components[VERTEX_PROPERTIES[n].component] = p;
+      }
+    }
+  }
+  if (components[0] < 0 || components[1] < 0 || components[2] < 0) {
+    mError = "vertices without x, y, z";
+    return false;
+  }
+  // incomplete normals or texture coordinates are left out //
+  if (components[3] < 0 || components[4] < 0 || components[5] < 0) {
+    components[3] = components[4] = components[5] = -1;
+  }
+  if (components[6] < 0 || components[7] < 0) {
+    components[6] = components[7] = -1;
+  }
+
+  // the other byte order -> the whole block is swapped at once, value by value if the sizes differ //
+  const char *block = cursor;
+  if (mSwap && blockSize > 0) {
+    mBlock.resize((blockSize + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    char *bytes = reinterpret_cast<char*>(&mBlock[0]);
+    std::memcpy(bytes, cursor, blockSize);
+    const size_t valueSize = getTypeSize(element.properties[0].type);
+    bool uniform = true;
+    for (size_t p = 1; p < element.properties.size(); ++p) {
+      uniform = uniform && getTypeSize(element.properties[p].type) == valueSize;
+    }
+    if (uniform) {
+      swapBytes(bytes, valueSize, blockSize / valueSize);
+    } else {
+      for (size_t v = 0; v < element.count; ++v) {
+        char *record = bytes + v * element.recordSize;
+        for (size_t p = 0; p < element.properties.size(); ++p) {
+          char *value = record + element.properties[p].offset;
+          std::reverse(value, value + getTypeSize(element.properties[p].type));
+        }
+      }
+    }
+    block = bytes;
+  }
+
+  const size_t vertexCount = element.count;
+  meshData.vertex_position.resize(3 * vertexCount);
+  meshData.vertex_normal.assign(3 * vertexCount, 0.0f);
+  meshData.vertex_texcoord.assign(2 * vertexCount, 0.0f);
+  GLfloat *destinations[COMPONENT_COUNT];
+  const unsigned int strides[COMPONENT_COUNT] = {3, 3, 3, 3, 3, 3, 2, 2};
+  for (unsigned int c = 0; c < COMPONENT_COUNT; ++c) {
+    std::vector<GLfloat> &attribute = (c < 3) ? meshData.vertex_position : (c < 6) ? meshData.vertex_normal : meshData.vertex_texcoord;
+    // x, y, z / nx, ny, nz / u, v -> the component within its attribute is c % 3 //
+    destinations[c] = vertexCount > 0 ? &attribute[c % 3] : NULL;
+  }
+  // one component of all vertices at a time -> the type switch stays the same within a loop //
+  for (unsigned int c = 0; c < COMPONENT_COUNT; ++c) {
+    if (components[c] < 0) {
+      continue;
+    }
+    const Property &property = element.properties[components[c]];
+    const char *value = block + property.offset;
+    for (size_t v = 0; v < vertexCount; ++v, value += element.recordSize) {
+      destinations[c][strides[c] * v] = (GLfloat)readValue(value, property.type, false);
+    }
+  }
+  cursor += blockSize;
+  return true;
+}
+
+bool PlyImporter::readFaces(const Element &element, const char *&cursor, const char *end, MeshData &meshData) {
+  int indexProperty = -1;
+  for (size_t p = 0; p < element.properties.size(); ++p) {
+    const Property &property = element.properties[p];
+    if (property.isList && (property.name == "vertex_indices" || property.name == "vertex_index")) {
+      indexProperty = p;
+    }
+  }
+  if (indexProperty < 0) {
+    mError = "faces without vertex_indices";
+    return false;
+  }
+
+  // mostly triangles -> 3 indices per face //
+  meshData.indices.reserve(meshData.indices.size() + 3 * element.count);
+  for (size_t f = 0; f < element.count; ++f) {
+    mPolygon.clear();
+    bool valid = true;
+    for (size_t p = 0; p < element.properties.size(); ++p) {
+      const Property &property = element.properties[p];
+      const size_t valueSize = getTypeSize(property.type);
+      if (!property.isList) {
+        if ((size_t)(end - cursor) < valueSize) {
+          mError = "file ends within the faces";
+          return false;
+        }
+        cursor += valueSize;
+        continue;
+      }
+      const size_t countSize = getTypeSize(property.countType);
+      if ((size_t)(end - cursor) < countSize) {
+        mError = "file ends within the faces";
+        return false;
+      }
+      const double count = readValue(cursor, property.countType, mSwap);
+      cursor += countSize;
+      if (count < 0.0 || (size_t)(end - cursor) < (size_t)count * valueSize) {
+        mError = "file ends within the faces";
+        return false;
+      }
+      if ((int)p == indexProperty) {
+        for (size_t i = 0; i < (size_t)count; ++i) {
+          const double index = readValue(cursor + i * valueSize, property.type, mSwap);
+          valid = valid && index >= 0.0 && index < (double)mVertexCount;
+          mPolygon.push_back(valid ? (GLuint)index : 0);
+        }
+      }
+      cursor += (size_t)count * valueSize;
+    }
+    if (!valid) {
+      ++mInvalidFaceCount;
+    } else if (mPolygon.size() >= 3) {
+      addPolygon(meshData);
+    }
+  }
+  return true;
+}
+
+void PlyImporter::addPolygon(MeshData &meshData) {
+  const unsigned int cornerCount = mPolygon.size();
+  // the vertices may follow the faces -> without their positions polygons are split up as a fan //
+  if (cornerCount == 3 || meshData.vertex_position.size() != 3 * mVertexCount) {
+    for (unsigned int c = 1; c + 1 < cornerCount; ++c) {
+      meshData.indices.push_back(mPolygon[0]);
+      meshData.indices.push_back(mPolygon[c]);
+      meshData.indices.push_back(mPolygon[c + 1]);
+    }
+    return;
+  }
+  mPolygonPoints.resize(cornerCount);
+  for (unsigned int c = 0; c < cornerCount; ++c) {
+    const GLfloat *position = &meshData.vertex_position[3 * mPolygon[c]];
+    mPolygonPoints[c] = glm::vec3(position[0], position[1], position[2]);
+  }
+  unsigned int triangleCount = mTriangulator.triangulate(&mPolygonPoints[0], cornerCount);
+  const unsigned int *triangles = mTriangulator.getTriangles();
+  for (unsigned int i = 0; i < 3 * triangleCount; ++i) {
+    meshData.indices.push_back(mPolygon[triangles[i]]);
+  }
+}
+
+void PlyImporter::removeUnusedVertices(MeshData &meshData) {
+  static const GLuint UNUSED = 0xFFFFFFFF;
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  mRemap.assign(vertexCount, UNUSED);
+  for (size_t i = 0; i < meshData.indices.size(); ++i) {
+    mRemap[meshData.indices[i]] = 0;
+  }
+  GLuint usedCount = 0;
+  for (size_t v = 0; v < vertexCount; ++v) {
+    if (mRemap[v] == UNUSED) {
+      continue;
+    }
+    mRemap[v] = usedCount;
+    // the vertex moves to a lower or the same index -> compacted in place //
+    std::copy(&meshData.vertex_position[3 * v], &meshData.vertex_position[3 * v] + 3, &meshData.vertex_position[3 * usedCount]);
+    std::copy(&meshData.vertex_normal[3 * v], &meshData.vertex_normal[3 * v] + 3, &meshData.vertex_normal[3 * usedCount]);
+    std::copy(&meshData.vertex_texcoord[2 * v], &meshData.vertex_texcoord[2 * v] + 2, &meshData.vertex_texcoord[2 * usedCount]);
+    ++usedCount;
+  }
+  if (usedCount == vertexCount) {
+    return;
+  }
+  meshData.vertex_position.resize(3 * usedCount);
+  meshData.vertex_normal.resize(3 * usedCount);
+  meshData.vertex_texcoord.resize(2 * usedCount);
+  for (size_t i = 0; i < meshData.indices.size(); ++i) {
+    meshData.indices[i] = mRemap[meshData.indices[i]];
+  }
+}
+
+bool PlyImporter::skipElement(const Element &element, const char *&cursor, const char *end) {
+  if (element.recordSize > 0) {
+    if (element.count > (size_t)(end - cursor) / element.recordSize) {
+      mError = "file ends within element \"" + element.name + "\"";
+      return false;
+    }
+    cursor += element.count * element.recordSize;
+    return true;
+  }
+  for (size_t r = 0; r < element.count; ++r) {
+    for (size_t p = 0; p < element.properties.size(); ++p) {
+      const Property &property = element.properties[p];
+      size_t skipSize = getTypeSize(property.type);
+      if (property.isList) {
+        const size_t countSize = getTypeSize(property.countType);
+        if ((size_t)(end - cursor) < countSize) {
+          mError = "file ends within element \"" + element.name + "\"";
+          return false;
+        }
+        const double count = readValue(cursor, property.countType, mSwap);
+        cursor += countSize;
+        skipSize = (count > 0.0) ? (size_t)count * skipSize : 0;
+      }
+      if ((size_t)(end - cursor) < skipSize) {
+        mError = "file ends within element \"" + element.name + "\"";
+        return false;
+      }
+      cursor += skipSize;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,123 @@
+#include "PolygonTriangulator.h"
+
+#include <cmath>
+
+// twice the signed area of the 2D triangle (a, b, c), positive for counter clockwise order //
+static inline float orientation(const glm::vec2 &a, const glm::vec2 &b, const glm::vec2 &c) {
+  return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+unsigned int PolygonTriangulator::triangulate(const glm::vec3 *points, unsigned int vertexCount) {
+  mTriangles.clear();
+  if (vertexCount < 3) {
+    return 0;
+  }
+  if (vertexCount == 3) {
+    addTriangle(0, 1, 2);
+    return 1;
+  }
+
+  // polygon normal (Newell's method, robust for non planar polygons) //
+  glm::vec3 normal(0);
+  for (unsigned int i = 0; i < vertexCount; ++i) {
+    const glm::vec3 &current = points[i];
+    const glm::vec3 &next = points[(i + 1) % vertexCount];
+    normal.x += (current.y - next.y) * (current.z + next.z);
+    normal.y += (current.z - next.z) * (current.x + next.x);
+    normal.z += (current.x - next.x) * (current.y + next.y);
+  }
+  // project onto the plane of the dominant normal axis, keeping the polygon counter clockwise //
+  unsigned int axis = 0;
+  if (std::fabs(normal.y) > std::fabs(normal[axis])) axis = 1;
+  if (std::fabs(normal.z) > std::fabs(normal[axis])) axis = 2;
+  if (normal[axis] == 0.0f) {
+    // degenerated polygon -> nothing to clip, keep the fan //
+    return triangulateFan(vertexCount);
+  }
+  unsigned int u = (axis + 1) % 3;
+  unsigned int v = (axis + 2) % 3;
+  float flip = (normal[axis] > 0.0f) ? 1.0f : -1.0f;
+  mProjected.resize(vertexCount);
+  for (unsigned int i = 0; i < vertexCount; ++i) {
+    mProjected[i] = glm::vec2(points[i][u], flip * points[i][v]);
+  }
+
+  // convex polygons (every corner turns left) are split up as a fan //
+  bool convex = true;
+  for (unsigned int i = 0; i < vertexCount && convex; ++i) {
+    const glm::vec2 &prev = mProjected[(i + vertexCount - 1) % vertexCount];
+    const glm::vec2 &next = mProjected[(i + 1) % vertexCount];
+    convex = orientation(prev, mProjected[i], next) >= 0.0f;
+  }
+  if (convex) {
+    return triangulateFan(vertexCount);
+  }
+  return triangulateEars(vertexCount);
+}
+
+void PolygonTriangulator::addTriangle(unsigned int a, unsigned int b, unsigned int c) {
+  mTriangles.push_back(a);
+  mTriangles.push_back(b);
+  mTriangles.push_back(c);
+}
+
+unsigned int PolygonTriangulator::triangulateFan(unsigned int vertexCount) {
+  for (unsigned int i = 1; i + 1 < vertexCount; ++i) {
+    addTriangle(0, i, i + 1);
+  }
+  return vertexCount - 2;
+}
+
+unsigned int PolygonTriangulator::triangulateEars(unsigned int vertexCount) {
+  // remaining corners as doubly linked ring //
+  mPrev.resize(vertexCount);
+  mNext.resize(vertexCount);
+  for (unsigned int i = 0; i < vertexCount; ++i) {
+    mPrev[i] = (i + vertexCount - 1) % vertexCount;
+    mNext[i] = (i + 1) % vertexCount;
+  }
+
+  unsigned int remaining = vertexCount;
+  unsigned int current = 0;
+  while (remaining > 3) {
+    // search an ear: a convex corner whose triangle contains no other (reflex) corner //
+    bool found = false;
+    for (unsigned int step = 0; step < remaining && !found; ++step, current = mNext[current]) {
+      unsigned int prev = mPrev[current];
+      unsigned int next = mNext[current];
+      const glm::vec2 &a = mProjected[prev];
+      const glm::vec2 &b = mProjected[current];
+      const glm::vec2 &c = mProjected[next];
+      if (orientation(a, b, c) <= 0.0f) {
+        continue;
+      }
+      bool isEar = true;
+      for (unsigned int other = mNext[next]; other != prev && isEar; other = mNext[other]) {
+        const glm::vec2 &p = mProjected[other];
+        // only reflex corners can lie inside an ear //
+        if (orientation(mProjected[mPrev[other]], p, mProjected[mNext[other]]) > 0.0f) {
+          continue;
+        }
+        if (p == a || p == b || p == c) {
+          continue;
+        }
+        isEar = !(orientation(a, b, p) >= 0.0f && orientation(b, c, p) >= 0.0f && orientation(c, a, p) >= 0.0f);
+      }
+      if (isEar) {
+        found = true;
+        break;
+      }
+    }
+    // self intersecting polygons may have no ear left -> clip the current corner anyway //
+    unsigned int prev = mPrev[current];
+    unsigned int next = mNext[current];
+    addTriangle(prev, current, next);
+    mNext[prev] = next;
+    mPrev[next] = prev;
+    --remaining;
+    // continue the search with the neighbor, which may have become an ear //
+    current = prev;
+  }
+  addTriangle(mPrev[current], current, mNext[current]);
+  return vertexCount - 2;
+}
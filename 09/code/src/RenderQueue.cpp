@@ -0,0 +1,129 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+static const unsigned int STATE_BITS = RenderQueue::PROGRAM_BITS + RenderQueue::TEXTURE_SET_BITS + RenderQueue::MATERIAL_BITS + RenderQueue::MESH_BITS;
+static const unsigned int TRANSLUCENT_SHIFT = STATE_BITS + RenderQueue::DEPTH_BITS;
+static const unsigned int PASS_SHIFT = TRANSLUCENT_SHIFT + 1;
+static_assert(PASS_SHIFT + RenderQueue::PASS_BITS == 64, "the key fields have to fill 64 bits");
+
+static uint64_t field(GLuint value, unsigned int bits) {
+  return (uint64_t)value & (((uint64_t)1 << bits) - 1);
+}
+
+static uint64_t makeStateBits(GLuint program, GLuint textureSet, GLuint material, GLuint mesh) {
+  uint64_t state = field(program, RenderQueue::PROGRAM_BITS);
+  state = (state << RenderQueue::TEXTURE_SET_BITS) | field(textureSet, RenderQueue::TEXTURE_SET_BITS);
+  state = (state << RenderQueue::MATERIAL_BITS) | field(material, RenderQueue::MATERIAL_BITS);
+  state = (state << RenderQueue::MESH_BITS) | field(mesh, RenderQueue::MESH_BITS);
+  return state;
+}
+
+RenderQueue::RenderQueue() {
+}
+
+void RenderQueue::clear(void) {
+  mItems.clear();
+}
+
+void RenderQueue::submit(uint64_t key, GLuint index) {
+  Item item;
+  item.key = key;
+  item.index = index;
+  mItems.push_back(item);
+}
+
+void RenderQueue::sort(void) {
+  const size_t count = mItems.size();
+  if (count < 2) {
+    return;
+  }
+  // one pass over the keys counts all 8 digits //
+  size_t histograms[8][256] = {};
+  for (size_t i = 0; i < count; ++i) {
+    const uint64_t key = mItems[i].key;
+    for (unsigned int digit = 0; digit < 8; ++digit) {
+      ++histograms[digit][(key >> (digit * 8)) & 0xFF];
+    }
+  }
+
+  mSortBuffer.resize(count);
+  Item *source = &mItems[0];
+  Item *target = &mSortBuffer[0];
+  for (unsigned int digit = 0; digit < 8; ++digit) {
+    size_t *histogram = histograms[digit];
+    const unsigned int shift = digit * 8;
+    // all keys share this byte (unused fields, a single pass, ...) -> nothing to reorder //
+    if (histogram[(source[0].key >> shift) & 0xFF] == count) {
+      continue;
+    }
+    size_t offset = 0;
+    for (unsigned int bucket = 0; bucket < 256; ++bucket) {
+      const size_t bucketSize = histogram[bucket];
+      histogram[bucket] = offset;
+      offset += bucketSize;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      target[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+    }
+    std::swap(source, target);
+  }
+  if (source != &mItems[0]) {
+    mItems.swap(mSortBuffer);
+  }
+}
+
+uint64_t RenderQueue::makeOpaqueKey(GLuint pass, GLuint program, GLuint textureSet, GLuint material, GLuint mesh, GLuint depth) {
+  return (field(pass, PASS_BITS) << PASS_SHIFT) |
+         (makeStateBits(program, textureSet, material, mesh) << DEPTH_BITS) |
+         field(depth, DEPTH_BITS);
+}
+
+uint64_t RenderQueue::makeTranslucentKey(GLuint pass, GLuint program, GLuint textureSet, GLuint material, GLuint mesh, GLuint depth) {
+  const GLuint maxDepth = (1u << DEPTH_BITS) - 1;
+  return (field(pass, PASS_BITS) << PASS_SHIFT) |
+         ((uint64_t)1 << TRANSLUCENT_SHIFT) |
+         (field(maxDepth - std::min(depth, maxDepth), DEPTH_BITS) << STATE_BITS) |
+         makeStateBits(program, textureSet, material, mesh);
+}
+
+GLuint RenderQueue::quantizeDepth(float depth, float nearPlane, float farPlane) {
+  const GLuint maxDepth = (1u << DEPTH_BITS) - 1;
+  if (!(farPlane > nearPlane) || !(depth > nearPlane)) {
+    return 0;
+  }
+  if (depth >= farPlane) {
+    return maxDepth;
+  }
+  return (GLuint)((depth - nearPlane) / (farPlane - nearPlane) * maxDepth);
+}
+
+uint64_t RenderQueue::getStateBits(uint64_t key) {
+  const uint64_t mask = ((uint64_t)1 << STATE_BITS) - 1;
+  // opaque keys have the depth below the state bits, translucent ones above //
+  return isTranslucent(key) ? (key & mask) : ((key >> DEPTH_BITS) & mask);
+}
+
+GLuint RenderQueue::getPass(uint64_t key) {
+  return (GLuint)(key >> PASS_SHIFT);
+}
+
+bool RenderQueue::isTranslucent(uint64_t key) {
+  return ((key >> TRANSLUCENT_SHIFT) & 1) != 0;
+}
+
+GLuint RenderQueue::getProgram(uint64_t key) {
+  return (GLuint)(getStateBits(key) >> (TEXTURE_SET_BITS + MATERIAL_BITS + MESH_BITS));
+}
+
+GLuint RenderQueue::getTextureSet(uint64_t key) {
+  return (GLuint)field((GLuint)(getStateBits(key) >> (MATERIAL_BITS + MESH_BITS)), TEXTURE_SET_BITS);
+}
+
+GLuint RenderQueue::getMaterial(uint64_t key) {
+  return (GLuint)field((GLuint)(getStateBits(key) >> MESH_BITS), MATERIAL_BITS);
+}
+
+GLuint RenderQueue::getMesh(uint64_t key) {
+  return (GLuint)field((GLuint)getStateBits(key), MESH_BITS);
+}
@@ -0,0 +1,68 @@
+#include "StlImporter.h"
+
+#include <cstring>
+
+#include "ByteSwap.h"
+
+// 80 bytes of free text, then the triangle count //
+static const size_t HEADER_SIZE = 84;
+// face normal, 3 positions (12 floats) and a 16-bit attribute //
+static const size_t TRIANGLE_SIZE = 50;
+static const size_t NORMAL_SIZE = 3 * sizeof(float);
+static const size_t CORNERS_SIZE = 9 * sizeof(float);
+
+bool StlImporter::import(const char *data, size_t size, MeshData &meshData) {
+  mError.clear();
+  if (size < HEADER_SIZE) {
+    mError = "file too small";
+    return false;
+  }
+  uint32_t triangleCount;
+  std::memcpy(&triangleCount, data + 80, sizeof(triangleCount));
+  if (!isLittleEndianHost()) {
+    swapBytes32(&triangleCount, 1);
+  }
+  // ASCII files start with "solid", but so do the headers of some binary ones -> the size decides //
+  if ((size - HEADER_SIZE) / TRIANGLE_SIZE < triangleCount) {
+    mError = (std::strncmp(data, "solid", 5) == 0) ? "ASCII STL files are not supported, only binary ones" : "file ends within the triangles";
+    return false;
+  }
+
+  const size_t vertexCount = 3 * (size_t)triangleCount;
+  meshData.vertex_position.resize(3 * vertexCount);
+  meshData.vertex_normal.assign(3 * vertexCount, 0.0f);
+  meshData.vertex_texcoord.assign(2 * vertexCount, 0.0f);
+  meshData.indices.resize(vertexCount);
+  if (triangleCount == 0) {
+    meshData.groups.clear();
+    return true;
+  }
+
+  // the records are 50 bytes -> the positions are unaligned, copied one triangle at a time //
+  char *positions = reinterpret_cast<char*>(&meshData.vertex_position[0]);
+  if (!isLittleEndianHost()) {
+    mWords.resize(3 * vertexCount);
+    positions = reinterpret_cast<char*>(&mWords[0]);
+  }
+  const char *record = data + HEADER_SIZE;
+  for (uint32_t t = 0; t < triangleCount; ++t, record += TRIANGLE_SIZE) {
+    std::memcpy(positions + t * CORNERS_SIZE, record + NORMAL_SIZE, CORNERS_SIZE);
+  }
+  if (!isLittleEndianHost()) {
+    swapBytes32(&mWords[0], mWords.size());
+    std::memcpy(&meshData.vertex_position[0], &mWords[0], mWords.size() * sizeof(uint32_t));
+  }
+
+  MeshGroup group;
+  for (size_t v = 0; v < vertexCount; ++v) {
+    meshData.indices[v] = v;
+    const GLfloat *position = &meshData.vertex_position[3 * v];
+    for (unsigned int k = 0; k < 3; ++k) {
+      if (v == 0 || position[k] < group.boundsMin[k]) group.boundsMin[k] = position[k];
+      if (v == 0 || position[k] > group.boundsMax[k]) group.boundsMax[k] = position[k];
+    }
+  }
+  group.indexCount = vertexCount;
+  meshData.groups.assign(1, group);
+  return true;
+}
@@ -0,0 +1,166 @@
+#include "TangentGenerator.h"
+
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+#include "Parallel.h"
+
+static const GLuint NO_VERTEX = 0xFFFFFFFF;
+static const unsigned char NO_ORIENTATION = 2;
+// triangles / vertices per task of the parallel stages //
+static const size_t BLOCK_SIZE = 1 << 14;
+
+// length test of MikkTSpace -> anything but denormals counts //
+static inline bool isNotZero(float value) {
+  return std::fabs(value) > FLT_MIN;
+}
+
+static inline glm::vec3 getVector(const std::vector<GLfloat> &data, GLuint vertex) {
+  return glm::vec3(data[3 * vertex], data[3 * vertex + 1], data[3 * vertex + 2]);
+}
+
+// 'vector' without its part along 'normal', normalized if not zero //
+static inline glm::vec3 projectOntoPlane(const glm::vec3 &vector, const glm::vec3 &normal) {
+  glm::vec3 projected = vector - glm::dot(normal, vector) * normal;
+  float length = glm::length(projected);
+  return isNotZero(length) ? projected / length : projected;
+}
+
+TangentGenerator::TangentGenerator() {
+  mThreadCount = 0;
+}
+
+unsigned int TangentGenerator::generate(MeshData &meshData) {
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  const size_t triangleCount = meshData.indices.size() / 3;
+  meshData.vertex_tangent.assign(3 * vertexCount, 0.0f);
+  meshData.vertex_binormal.assign(3 * vertexCount, 0.0f);
+  if (meshData.vertex_normal.size() != 3 * vertexCount || meshData.vertex_texcoord.size() != 2 * vertexCount) {
+    return 0;
+  }
+
+  mTriangleTangent.resize(triangleCount);
+  mOrientation.resize(triangleCount);
+  parallelFor((triangleCount + BLOCK_SIZE - 1) / BLOCK_SIZE, mThreadCount, [&](unsigned int block) {
+    computeTriangleFrames(meshData, block * BLOCK_SIZE, std::min((block + 1) * BLOCK_SIZE, triangleCount));
+  });
+  unsigned int copyCount = splitMirroredVertices(meshData);
+  buildAdjacency(meshData);
+  const size_t splitVertexCount = meshData.vertex_position.size() / 3;
+  parallelFor((splitVertexCount + BLOCK_SIZE - 1) / BLOCK_SIZE, mThreadCount, [&](unsigned int block) {
+    computeVertexFrames(meshData, block * BLOCK_SIZE, std::min((block + 1) * BLOCK_SIZE, splitVertexCount));
+  });
+  return copyCount;
+}
+
+void TangentGenerator::computeTriangleFrames(const MeshData &meshData, size_t firstTriangle, size_t endTriangle) {
+  for (size_t t = firstTriangle; t < endTriangle; ++t) {
+    const GLuint *corners = &meshData.indices[3 * t];
+    glm::vec3 p0 = getVector(meshData.vertex_position, corners[0]);
+    glm::vec3 d1 = getVector(meshData.vertex_position, corners[1]) - p0;
+    glm::vec3 d2 = getVector(meshData.vertex_position, corners[2]) - p0;
+    const GLfloat *t0 = &meshData.vertex_texcoord[2 * corners[0]];
+    const GLfloat *t1 = &meshData.vertex_texcoord[2 * corners[1]];
+    const GLfloat *t2 = &meshData.vertex_texcoord[2 * corners[2]];
+    float t21x = t1[0] - t0[0], t21y = t1[1] - t0[1];
+    float t31x = t2[0] - t0[0], t31y = t2[1] - t0[1];
+
+    // twice the signed area in texture space, its sign is the orientation of the mapping //
+    float signedArea = t21x * t31y - t21y * t31x;
+    if (!isNotZero(signedArea)) {
+      // degenerate UVs -> the triangle has no texture direction //
+      mTriangleTangent[t] = glm::vec3(0.0f);
+      mOrientation[t] = NO_ORIENTATION;
+      continue;
+    }
+    // direction of increasing u, times the area -> normalized and turned by the orientation //
+    glm::vec3 tangent = t31y * d1 - t21y * d2;
+    float length = glm::length(tangent);
+    mTriangleTangent[t] = isNotZero(length) ? tangent * ((signedArea > 0.0f ? 1.0f : -1.0f) / length) : glm::vec3(0.0f);
+    mOrientation[t] = (signedArea > 0.0f) ? 1 : 0;
+  }
+}
+
+unsigned int TangentGenerator::splitMirroredVertices(MeshData &meshData) {
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  mVertexOrientation.assign(vertexCount, NO_ORIENTATION);
+  mMirroredCopy.assign(vertexCount, NO_VERTEX);
+  unsigned int copyCount = 0;
+  for (size_t c = 0; c < meshData.indices.size() - meshData.indices.size() % 3; ++c) {
+    const unsigned char orientation = mOrientation[c / 3];
+    GLuint vertex = meshData.indices[c];
+    if (orientation == NO_ORIENTATION || orientation == mVertexOrientation[vertex]) {
+      continue;
+    }
+    if (mVertexOrientation[vertex] == NO_ORIENTATION) {
+      mVertexOrientation[vertex] = orientation;
+      continue;
+    }
+    if (mMirroredCopy[vertex] == NO_VERTEX) {
+      mMirroredCopy[vertex] = meshData.copyVertex(vertex);
+      mVertexOrientation.push_back(orientation);
+      mMirroredCopy.push_back(NO_VERTEX);
+      ++copyCount;
+    }
+    meshData.indices[c] = mMirroredCopy[vertex];
+  }
+  return copyCount;
+}
+
+void TangentGenerator::buildAdjacency(const MeshData &meshData) {
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  const size_t indexCount = meshData.indices.size() - meshData.indices.size() % 3;
+  mAdjacencyOffset.assign(vertexCount + 1, 0);
+  for (size_t c = 0; c < indexCount; ++c) {
+    ++mAdjacencyOffset[meshData.indices[c] + 1];
+  }
+  for (size_t v = 0; v < vertexCount; ++v) {
+    mAdjacencyOffset[v + 1] += mAdjacencyOffset[v];
+  }
+  mAdjacency.resize(indexCount);
+  mFillCount.assign(vertexCount, 0);
+  for (size_t c = 0; c < indexCount; ++c) {
+    GLuint vertex = meshData.indices[c];
+    mAdjacency[mAdjacencyOffset[vertex] + mFillCount[vertex]++] = c;
+  }
+}
+
+void TangentGenerator::computeVertexFrames(MeshData &meshData, size_t firstVertex, size_t endVertex) {
+  const std::vector<GLfloat> &positions = meshData.vertex_position;
+  for (size_t v = firstVertex; v < endVertex; ++v) {
+    const glm::vec3 normal = getVector(meshData.vertex_normal, v);
+    const glm::vec3 position = getVector(positions, v);
+    glm::vec3 tangentSum(0.0f);
+    for (unsigned int a = mAdjacencyOffset[v]; a < mAdjacencyOffset[v + 1]; ++a) {
+      const unsigned int corner = mAdjacency[a];
+      const unsigned int triangle = corner / 3;
+      if (mOrientation[triangle] == NO_ORIENTATION) {
+        continue;
+      }
+      // angle of the triangle at the vertex, measured within the plane of the normal //
+      const GLuint *corners = &meshData.indices[3 * triangle];
+      const unsigned int k = corner % 3;
+      glm::vec3 toPrevious = projectOntoPlane(getVector(positions, corners[(k + 2) % 3]) - position, normal);
+      glm::vec3 toNext = projectOntoPlane(getVector(positions, corners[(k + 1) % 3]) - position, normal);
+      float angle = std::acos(glm::clamp(glm::dot(toPrevious, toNext), -1.0f, 1.0f));
+      tangentSum += angle * projectOntoPlane(mTriangleTangent[triangle], normal);
+    }
+
+    float length = glm::length(tangentSum);
+    glm::vec3 tangent;
+    if (isNotZero(length)) {
+      tangent = tangentSum / length;
+    } else {
+      // no triangle with texture area -> any direction perpendicular to the normal //
+      glm::vec3 axis = (std::fabs(normal.x) < 0.9f) ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+      tangent = projectOntoPlane(axis, normal);
+    }
+    const float sign = (mVertexOrientation[v] == 0) ? -1.0f : 1.0f;
+    const glm::vec3 binormal = sign * glm::cross(normal, tangent);
+    for (unsigned int k = 0; k < 3; ++k) {
+      meshData.vertex_tangent[3 * v + k] = tangent[k];
+      meshData.vertex_binormal[3 * v + k] = binormal[k];
+    }
+  }
+}
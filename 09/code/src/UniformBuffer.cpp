@@ -0,0 +1,65 @@
+#include "UniformBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+UniformBuffer::UniformBuffer() {
+  mBuffer = 0;
+  mBinding = 0;
+  mDirtyBegin = 0;
+  mDirtyEnd = 0;
+}
+
+UniformBuffer::~UniformBuffer() {
+  glDeleteBuffers(1, &mBuffer);
+}
+
+void UniformBuffer::create(GLsizeiptr size, GLuint binding) {
+  mData.assign(size, 0);
+  mBinding = binding;
+  mDirtyBegin = mDirtyEnd = 0;
+  if (mBuffer == 0) {
+    glGenBuffers(1, &mBuffer);
+  }
+  glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+  glBufferData(GL_UNIFORM_BUFFER, size, &mData[0], GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding, mBuffer);
+}
+
+void UniformBuffer::write(size_t offset, const void *data, size_t size) {
+  if (offset + size > mData.size()) {
+    return;
+  }
+  const unsigned char *bytes = static_cast<const unsigned char*>(data);
+  // only the part that differs widens the dirty range //
+  size_t first = 0;
+  while (first < size && bytes[first] == mData[offset + first]) {
+    ++first;
+  }
+  if (first == size) {
+    return;
+  }
+  size_t last = size;
+  while (bytes[last - 1] == mData[offset + last - 1]) {
+    --last;
+  }
+  std::memcpy(&mData[offset + first], bytes + first, last - first);
+  if (isDirty()) {
+    mDirtyBegin = std::min(mDirtyBegin, offset + first);
+    mDirtyEnd = std::max(mDirtyEnd, offset + last);
+  } else {
+    mDirtyBegin = offset + first;
+    mDirtyEnd = offset + last;
+  }
+}
+
+void UniformBuffer::upload(void) {
+  if (!isDirty()) {
+    return;
+  }
+  glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, mDirtyBegin, mDirtyEnd - mDirtyBegin, &mData[mDirtyBegin]);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  mDirtyBegin = mDirtyEnd = 0;
+}
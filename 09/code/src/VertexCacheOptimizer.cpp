@@ -0,0 +1,281 @@
+#include "VertexCacheOptimizer.h"
+
+#include <cmath>
+#include <algorithm>
+
+// scoring constants of the original algorithm //
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+static const unsigned int VALENCE_TABLE_SIZE = 64;
+
+void VertexCacheOptimizer::initScoreTables(void) {
+  mCacheScore.resize(CACHE_SIZE);
+  for (unsigned int position = 0; position < CACHE_SIZE; ++position) {
+    if (position < 3) {
+      // the vertices of the last triangle get a fixed score -> avoids using them again right away //
+      mCacheScore[position] = LAST_TRIANGLE_SCORE;
+    } else {
+      float scale = 1.0f - (float)(position - 3) / (float)(CACHE_SIZE - 3);
+      mCacheScore[position] = std::pow(scale, CACHE_DECAY_POWER);
+    }
+  }
+  mValenceScore.resize(VALENCE_TABLE_SIZE);
+  mValenceScore[0] = 0.0f;
+  for (unsigned int valence = 1; valence < VALENCE_TABLE_SIZE; ++valence) {
+    mValenceScore[valence] = VALENCE_BOOST_SCALE * std::pow((float)valence, -VALENCE_BOOST_POWER);
+  }
+}
+
+float VertexCacheOptimizer::getVertexScore(int cachePosition, unsigned int remainingTriangles) const {
+  if (remainingTriangles == 0) {
+    // no triangle left to use this vertex //
+    return -1.0f;
+  }
+  float score = (cachePosition >= 0) ? mCacheScore[cachePosition] : 0.0f;
+  // vertices with few triangles left are preferred -> finishes them instead of leaving lone triangles behind //
+  if (remainingTriangles < VALENCE_TABLE_SIZE) {
+    score += mValenceScore[remainingTriangles];
+  } else {
+    score += VALENCE_BOOST_SCALE * std::pow((float)remainingTriangles, -VALENCE_BOOST_POWER);
+  }
+  return score;
+}
+
+void VertexCacheOptimizer::optimize(MeshData &meshData) {
+  if (!meshData.clusters.empty()) {
+    // clusters are draw ranges within the groups -> optimizing them keeps the groups valid too //
+    for (size_t c = 0; c < meshData.clusters.size(); ++c) {
+      const MeshCluster &cluster = meshData.clusters[c];
+      optimizeTriangleOrder(&meshData.indices[cluster.firstIndex], cluster.indexCount);
+    }
+  } else if (meshData.groups.empty()) {
+    size_t fullIndexCount = meshData.lods.empty() ? meshData.indices.size() : meshData.lods[0].indexCount;
+    optimizeTriangleOrder(meshData.indices.empty() ? NULL : &meshData.indices[0], fullIndexCount);
+  } else {
+    // groups are draw ranges -> their triangles stay within them //
+    for (size_t g = 0; g < meshData.groups.size(); ++g) {
+      const MeshGroup &group = meshData.groups[g];
+      optimizeTriangleOrder(&meshData.indices[group.firstIndex], group.indexCount);
+    }
+  }
+  // the groups cover the full mesh, the other levels of detail are drawn as a whole //
+  for (size_t l = 1; l < meshData.lods.size(); ++l) {
+    optimizeTriangleOrder(&meshData.indices[meshData.lods[l].firstIndex], meshData.lods[l].indexCount);
+  }
+  optimizeVertexOrder(meshData);
+}
+
+void VertexCacheOptimizer::optimizeTriangleOrder(GLuint *indices, size_t indexCount) {
+  const size_t triangleCount = indexCount / 3;
+  if (triangleCount < 2) {
+    return;
+  }
+  if (mCacheScore.empty()) {
+    initScoreTables();
+  }
+
+  // number the vertices used by these triangles locally -> the work arrays fit the range, not the mesh //
+  GLuint maxVertex = *std::max_element(indices, indices + 3 * triangleCount);
+  if (mLocalVertex.size() <= maxVertex) {
+    mLocalVertex.resize(maxVertex + 1, -1);
+  }
+  mGlobalVertex.clear();
+  for (size_t i = 0; i < 3 * triangleCount; ++i) {
+    if (mLocalVertex[indices[i]] < 0) {
+      mLocalVertex[indices[i]] = mGlobalVertex.size();
+      mGlobalVertex.push_back(indices[i]);
+    }
+  }
+  const size_t vertexCount = mGlobalVertex.size();
+
+  // triangles per vertex //
+  mCorners.resize(3 * triangleCount);
+  mRemaining.assign(vertexCount, 0);
+  for (size_t i = 0; i < 3 * triangleCount; ++i) {
+    mCorners[i] = mLocalVertex[indices[i]];
+    ++mRemaining[mCorners[i]];
+  }
+  mAdjacencyOffset.resize(vertexCount + 1);
+  mAdjacencyOffset[0] = 0;
+  for (size_t v = 0; v < vertexCount; ++v) {
+    mAdjacencyOffset[v + 1] = mAdjacencyOffset[v] + mRemaining[v];
+  }
+  mAdjacency.resize(3 * triangleCount);
+  // the cache positions serve as fill counters while the adjacency is built //
+  mCachePosition.assign(vertexCount, 0);
+  for (size_t t = 0; t < triangleCount; ++t) {
+    for (unsigned int k = 0; k < 3; ++k) {
+      int v = mCorners[3 * t + k];
+      mAdjacency[mAdjacencyOffset[v] + mCachePosition[v]++] = t;
+    }
+  }
+
+  // initial scores, nothing is cached yet //
+  mCachePosition.assign(vertexCount, -1);
+  mVertexScore.resize(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    mVertexScore[v] = getVertexScore(-1, mRemaining[v]);
+  }
+  mTriangleScore.resize(triangleCount);
+  mTriangleEmitted.assign(triangleCount, 0);
+  int bestTriangle = 0;
+  for (size_t t = 0; t < triangleCount; ++t) {
+    mTriangleScore[t] = mVertexScore[mCorners[3 * t]] + mVertexScore[mCorners[3 * t + 1]] + mVertexScore[mCorners[3 * t + 2]];
+    if (mTriangleScore[t] > mTriangleScore[bestTriangle]) {
+      bestTriangle = t;
+    }
+  }
+
+  mCache.clear();
+  mOrderedIndices.clear();
+  mOrderedIndices.reserve(3 * triangleCount);
+  size_t scanPosition = 0;
+  for (size_t emitted = 0; emitted < triangleCount; ++emitted) {
+    if (bestTriangle < 0) {
+      // no triangle touches the cache -> continue with the next one in input order //
+      while (mTriangleEmitted[scanPosition]) {
+        ++scanPosition;
+      }
+      bestTriangle = scanPosition;
+    }
+    const size_t triangle = bestTriangle;
+    mTriangleEmitted[triangle] = 1;
+    int corners[3];
+    for (unsigned int k = 0; k < 3; ++k) {
+      mOrderedIndices.push_back(indices[3 * triangle + k]);
+      corners[k] = mCorners[3 * triangle + k];
+    }
+
+    // remove the triangle from the lists of its vertices (once per corner, like it was added) //
+    for (unsigned int k = 0; k < 3; ++k) {
+      int v = corners[k];
+      unsigned int *adjacency = &mAdjacency[mAdjacencyOffset[v]];
+      unsigned int remaining = mRemaining[v];
+      for (unsigned int a = 0; a < remaining; ++a) {
+        if (adjacency[a] == triangle) {
+          std::swap(adjacency[a], adjacency[remaining - 1]);
+          break;
+        }
+      }
+      --mRemaining[v];
+    }
+
+    // the triangle's vertices move to the front of the LRU cache //
+    mNextCache.clear();
+    mNextCache.push_back(corners[0]);
+    if (corners[1] != corners[0]) {
+      mNextCache.push_back(corners[1]);
+    }
+    if (corners[2] != corners[0] && corners[2] != corners[1]) {
+      mNextCache.push_back(corners[2]);
+    }
+    for (size_t c = 0; c < mCache.size(); ++c) {
+      if (mCache[c] != corners[0] && mCache[c] != corners[1] && mCache[c] != corners[2]) {
+        mNextCache.push_back(mCache[c]);
+      }
+    }
+
+    // rescore the cached vertices (and the ones just pushed out), their triangles get the score difference //
+    for (size_t c = 0; c < mNextCache.size(); ++c) {
+      int v = mNextCache[c];
+      mCachePosition[v] = (c < CACHE_SIZE) ? (int)c : -1;
+      float score = getVertexScore(mCachePosition[v], mRemaining[v]);
+      float delta = score - mVertexScore[v];
+      mVertexScore[v] = score;
+      const unsigned int *adjacency = &mAdjacency[mAdjacencyOffset[v]];
+      for (unsigned int a = 0; a < mRemaining[v]; ++a) {
+        mTriangleScore[adjacency[a]] += delta;
+      }
+    }
+    // the next triangle is the best one using a cached vertex //
+    bestTriangle = -1;
+    float bestScore = -1.0f;
+    for (size_t c = 0; c < mNextCache.size() && c < CACHE_SIZE; ++c) {
+      int v = mNextCache[c];
+      const unsigned int *adjacency = &mAdjacency[mAdjacencyOffset[v]];
+      for (unsigned int a = 0; a < mRemaining[v]; ++a) {
+        if (mTriangleScore[adjacency[a]] > bestScore) {
+          bestScore = mTriangleScore[adjacency[a]];
+          bestTriangle = adjacency[a];
+        }
+      }
+    }
+    if (mNextCache.size() > CACHE_SIZE) {
+      mNextCache.resize(CACHE_SIZE);
+    }
+    mCache.swap(mNextCache);
+  }
+
+  std::copy(mOrderedIndices.begin(), mOrderedIndices.end(), indices);
+  // leave the local numbering clean for the next range //
+  for (size_t v = 0; v < vertexCount; ++v) {
+    mLocalVertex[mGlobalVertex[v]] = -1;
+  }
+}
+
+// moves the vertices of 'attribute' to their new position, arrays not matching the vertex count are left alone //
+static void reorderAttribute(std::vector<GLfloat> &attribute, unsigned int componentCount, const std::vector<GLuint> &newIndex,
+                             std::vector<GLfloat> &buffer) {
+  const size_t vertexCount = newIndex.size();
+  if (attribute.size() != vertexCount * componentCount) {
+    return;
+  }
+  buffer.resize(attribute.size());
+  for (size_t v = 0; v < vertexCount; ++v) {
+    std::copy(&attribute[v * componentCount], &attribute[v * componentCount] + componentCount, &buffer[newIndex[v] * componentCount]);
+  }
+  attribute.swap(buffer);
+}
+
+void VertexCacheOptimizer::optimizeVertexOrder(MeshData &meshData) {
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  const GLuint UNUSED = 0xFFFFFFFF;
+  std::vector<GLuint> newIndex(vertexCount, UNUSED);
+  GLuint nextIndex = 0;
+  for (size_t i = 0; i < meshData.indices.size(); ++i) {
+    GLuint &index = meshData.indices[i];
+    if (newIndex[index] == UNUSED) {
+      newIndex[index] = nextIndex++;
+    }
+    index = newIndex[index];
+  }
+  // unreferenced vertices go to the end //
+  for (size_t v = 0; v < vertexCount; ++v) {
+    if (newIndex[v] == UNUSED) {
+      newIndex[v] = nextIndex++;
+    }
+  }
+
+  std::vector<GLfloat> buffer;
+  reorderAttribute(meshData.vertex_position, 3, newIndex, buffer);
+  reorderAttribute(meshData.vertex_normal, 3, newIndex, buffer);
+  reorderAttribute(meshData.vertex_texcoord, 2, newIndex, buffer);
+  reorderAttribute(meshData.vertex_tangent, 3, newIndex, buffer);
+  reorderAttribute(meshData.vertex_binormal, 3, newIndex, buffer);
+}
+
+VertexCacheStats VertexCacheOptimizer::measure(const GLuint *indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize) {
+  VertexCacheStats stats;
+  stats.acmr = 0.0f;
+  stats.atvr = 0.0f;
+  if (indexCount < 3) {
+    return stats;
+  }
+  // FIFO cache -> a vertex is cached while less than 'cacheSize' misses happened since it was loaded //
+  std::vector<size_t> loadedAt(vertexCount, 0);
+  size_t missCount = 0;
+  size_t usedVertexCount = 0;
+  for (size_t i = 0; i < indexCount; ++i) {
+    size_t &loaded = loadedAt[indices[i]];
+    if (loaded == 0 || loaded + cacheSize <= missCount) {
+      usedVertexCount += (loaded == 0) ? 1 : 0;
+      ++missCount;
+      loaded = missCount;
+    }
+  }
+  stats.acmr = (float)missCount / (float)(indexCount / 3);
+  stats.atvr = (float)missCount / (float)usedVertexCount;
+  return stats;
+}
@@ -0,0 +1,79 @@
+#include "VertexWelder.h"
+
+VertexWelder::VertexWelder(size_t expectedVertexCount) {
+  mMask = 0;
+  mVertexCount = 0;
+  reserve(expectedVertexCount);
+}
+
+void VertexWelder::reserve(size_t expectedVertexCount) {
+  // keep the load factor at or below 1/2 //
+  size_t slotCount = 16;
+  while (slotCount < 2 * expectedVertexCount) {
+    slotCount *= 2;
+  }
+  if (slotCount > mSlots.size()) {
+    rehash(slotCount);
+  }
+}
+
+void VertexWelder::clear(void) {
+  Slot empty = {0, 0, 0, EMPTY_SLOT};
+  mSlots.assign(mSlots.size(), empty);
+  mVertexCount = 0;
+}
+
+unsigned int VertexWelder::hash(int vi, int ni, int ti) {
+  // pack the triplet into 64 bit and mix it (murmur3 finalizer) //
+  unsigned long long key = (unsigned long long)(unsigned int)vi * 0x9E3779B97F4A7C15ULL;
+  key ^= (unsigned long long)(unsigned int)ni * 0xC2B2AE3D27D4EB4FULL;
+  key ^= (unsigned long long)(unsigned int)ti * 0x165667B19E3779F9ULL;
+  key ^= key >> 33;
+  key *= 0xFF51AFD7ED558CCDULL;
+  key ^= key >> 33;
+  return (unsigned int)key;
+}
+
+bool VertexWelder::weld(int vi, int ni, int ti, unsigned int &index) {
+  if (2 * (size_t)(mVertexCount + 1) > mSlots.size()) {
+    rehash(2 * mSlots.size());
+  }
+  size_t slot = hash(vi, ni, ti) & mMask;
+  while (true) {
+    Slot &entry = mSlots[slot];
+    if (entry.index == EMPTY_SLOT) {
+      // triplet not known yet -> assign a new index //
+      entry.vi = vi;
+      entry.ni = ni;
+      entry.ti = ti;
+      entry.index = mVertexCount++;
+      index = entry.index;
+      return true;
+    }
+    if (entry.vi == vi && entry.ni == ni && entry.ti == ti) {
+      index = entry.index;
+      return false;
+    }
+    slot = (slot + 1) & mMask;
+  }
+}
+
+void VertexWelder::rehash(size_t slotCount) {
+  std::vector<Slot> oldSlots;
+  oldSlots.swap(mSlots);
+
+  Slot empty = {0, 0, 0, EMPTY_SLOT};
+  mSlots.assign(slotCount, empty);
+  mMask = slotCount - 1;
+
+  for (size_t i = 0; i < oldSlots.size(); ++i) {
+    const Slot &entry = oldSlots[i];
+    if (entry.index != EMPTY_SLOT) {
+      size_t slot = hash(entry.vi, entry.ni, entry.ti) & mMask;
+      while (mSlots[slot].index != EMPTY_SLOT) {
+        slot = (slot + 1) & mMask;
+      }
+      mSlots[slot] = entry;
+    }
+  }
+}
@@ -0,0 +1,497 @@
+// #INFO# benchmark of the OBJ import, runs without a GL context (see MeshObjStub.cpp) //
+// usage: loaderbench [-r runs] [-s scales] [-t threads] [-c] [-o result.json] <.obj file> ...
+//  - every file is imported phase by phase, the best time of 'runs' repetitions is reported
+//  - 'scales' is a comma separated list of copy counts, e.g. "1,4,16" -> synthetic files with
+//    the given number of copies of each mesh are written to /tmp and imported as well
+//  - 'threads' is handed to the processing stages and ObjLoader::setImportThreadCount()
+//  - '-c' builds clusters, in the clusters phase and the end to end import (off by default, as in ObjLoader)
+// phases, from dedup on each one works on the result of the previous one like ObjLoader does:
+//  - read      -> map the file and touch every page
+//  - tokenize  -> scan all records without storing them
+//  - dedup     -> scan, triangulate and weld into indexed MeshData (serial)
+//  - weld      -> merge vertices with equal attributes (MeshWelder)
+//  - normals   -> normals of vertices without one (NormalGenerator)
+//  - tangent   -> tangent space of the welded mesh
+//  - lod       -> simplified levels of detail (MeshSimplifier)
+//  - clusters  -> clusters of the full mesh (ClusterBuilder, only with '-c')
+//  - vcache    -> triangle and vertex reordering for the vertex cache
+//  - end2end   -> ObjLoader::loadObjFile() without mesh cache, including the (stubbed) upload
+// unknown options and files that can not be read are rejected with exit code 1
+// every phase reports MB/s, lines/s, triangles/s, its heap allocation count and the peak RSS
+
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "ObjLoader.h"
+#include "ObjMeshAssembler.h"
+#include "ObjParser.h"
+#include "MeshWelder.h"
+#include "NormalGenerator.h"
+#include "TangentGenerator.h"
+#include "MeshSimplifier.h"
+#include "ClusterBuilder.h"
+#include "VertexCacheOptimizer.h"
+
+// heap allocation counter, import threads allocate as well //
+static std::atomic<size_t> allocationCount(0);
+
+void* operator new(size_t size) {
+  ++allocationCount;
+  void *memory = malloc(size > 0 ? size : 1);
+  if (memory == NULL) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void *memory) noexcept {
+  free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+  free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+  free(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept {
+  free(memory);
+}
+
+// counts the records of a file without storing them //
+class CountingHandler : public ObjRecordHandler {
+  public:
+    CountingHandler() : positionCount(0), normalCount(0), texcoordCount(0), faceCount(0), triangleCount(0) {};
+
+    void addPosition(const glm::vec3 &) { ++positionCount; }
+    void addNormal(const glm::vec3 &) { ++normalCount; }
+    void addTexcoord(const glm::vec2 &) { ++texcoordCount; }
+    void addFace(const int *, const unsigned char *, unsigned int vertexCount) {
+      ++faceCount;
+      triangleCount += vertexCount - 2;
+    }
+    void addMalformedFace(unsigned int) {}
+
+    size_t positionCount;
+    size_t normalCount;
+    size_t texcoordCount;
+    size_t faceCount;
+    size_t triangleCount;
+};
+
+struct PhaseResult {
+  PhaseResult() : seconds(0), allocations(0), peakRssKb(0) {};
+
+  std::string name;
+  double seconds;
+  size_t allocations;
+  long peakRssKb;
+};
+
+struct FileResult {
+  std::string fileName;
+  unsigned int scale;
+  size_t bytes;
+  size_t lines;
+  size_t triangles;
+  size_t vertices;
+  std::vector<PhaseResult> phases;
+};
+
+// resets the peak RSS of the process (Linux >= 4.0), so every phase reports its own peak //
+static void resetPeakRss(void) {
+  FILE *file = fopen("/proc/self/clear_refs", "w");
+  if (file != NULL) {
+    fputs("5", file);
+    fclose(file);
+  }
+}
+
+// peak RSS in KB since the last reset, falls back to the peak of the whole process //
+static long getPeakRssKb(void) {
+  FILE *file = fopen("/proc/self/status", "r");
+  if (file != NULL) {
+    char line[256];
+    long peak = -1;
+    while (fgets(line, sizeof(line), file) != NULL) {
+      if (strncmp(line, "VmHWM:", 6) == 0) {
+        peak = atol(line + 6);
+        break;
+      }
+    }
+    fclose(file);
+    if (peak >= 0) {
+      return peak;
+    }
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// times 'phase' 'runs' times and keeps the best time, allocations and RSS are taken from the first run //
+// 'prepare' runs untimed before every run -> phases changing their input start from the same data each time
+template <typename Prepare, typename Phase>
+static PhaseResult runPhase(const std::string &name, unsigned int runs, Prepare prepare, Phase phase) {
+  PhaseResult result;
+  result.name = name;
+  for (unsigned int run = 0; run < runs; ++run) {
+    prepare();
+    resetPeakRss();
+    size_t allocationsBefore = allocationCount;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    phase();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (run == 0) {
+      result.allocations = allocationCount - allocationsBefore;
+      result.peakRssKb = getPeakRssKb();
+      result.seconds = seconds;
+    } else if (seconds < result.seconds) {
+      result.seconds = seconds;
+    }
+  }
+  return result;
+}
+
+template <typename Phase>
+static PhaseResult runPhase(const std::string &name, unsigned int runs, Phase phase) {
+  return runPhase(name, runs, []() {}, phase);
+}
+
+// times a processing stage on 'meshData', every run starts from the result of the previous stage //
+template <typename Stage>
+static PhaseResult runStage(const std::string &name, unsigned int runs, MeshData &meshData, Stage stage) {
+  const MeshData input = meshData;
+  return runPhase(name, runs, [&]() { meshData = input; }, [&]() { stage(meshData); });
+}
+
+static FileResult benchmarkFile(const std::string &fileName, unsigned int scale, unsigned int runs, unsigned int threadCount,
+                                bool buildClusters) {
+  FileResult result;
+  result.fileName = fileName;
+  result.scale = scale;
+  result.bytes = 0;
+  result.lines = 0;
+  result.triangles = 0;
+  result.vertices = 0;
+
+  result.phases.push_back(runPhase("read", runs, [&]() {
+    MappedFile file;
+    if (!file.open(fileName)) {
+      return;
+    }
+    // touch every page -> the file is actually read //
+    volatile char sum = 0;
+    long pageSize = sysconf(_SC_PAGESIZE);
+    for (size_t offset = 0; offset < file.size(); offset += pageSize) {
+      sum += file.data()[offset];
+    }
+    result.bytes = file.size();
+  }));
+
+  result.phases.push_back(runPhase("tokenize", runs, [&]() {
+    MappedFile file;
+    if (!file.open(fileName)) {
+      return;
+    }
+    CountingHandler counter;
+    result.lines = parseObjLines(file.data(), file.data() + file.size(), counter);
+    result.triangles = counter.triangleCount;
+  }));
+
+  MeshData meshData;
+  result.phases.push_back(runPhase("dedup", runs, [&]() {
+    MappedFile file;
+    if (!file.open(fileName)) {
+      return;
+    }
+    meshData = MeshData();
+    ObjMeshAssembler assembler(meshData, file.size() / 128);
+    parseObjLines(file.data(), file.data() + file.size(), assembler);
+    result.vertices = meshData.vertex_position.size() / 3;
+  }));
+
+  // the stages of ObjLoader::processImportedMesh() with its default settings //
+  result.phases.push_back(runStage("weld", runs, meshData, [&](MeshData &data) {
+    MeshWelder welder;
+    welder.setThreadCount(threadCount);
+    welder.weld(data);
+  }));
+
+  result.phases.push_back(runStage("normals", runs, meshData, [&](MeshData &data) {
+    NormalGenerator normalGenerator;
+    normalGenerator.setThreadCount(threadCount);
+    normalGenerator.generate(data);
+  }));
+
+  result.phases.push_back(runStage("tangent", runs, meshData, [&](MeshData &data) {
+    TangentGenerator tangentGenerator;
+    tangentGenerator.setThreadCount(threadCount);
+    tangentGenerator.generate(data);
+  }));
+
+  result.phases.push_back(runStage("lod", runs, meshData, [&](MeshData &data) {
+    if (!data.indices.empty()) {
+      MeshSimplifier simplifier;
+      simplifier.generateLods(data);
+    }
+  }));
+
+  if (buildClusters) {
+    result.phases.push_back(runStage("clusters", runs, meshData, [&](MeshData &data) {
+      if (!data.indices.empty()) {
+        ClusterBuilder builder;
+        builder.build(data);
+      }
+    }));
+  }
+
+  result.phases.push_back(runStage("vcache", runs, meshData, [&](MeshData &data) {
+    if (!data.indices.empty()) {
+      VertexCacheOptimizer optimizer;
+      optimizer.optimize(data);
+    }
+  }));
+  meshData = MeshData();
+
+  // the loader prints a line per import -> keep the report readable //
+  std::streambuf *coutBuffer = std::cout.rdbuf();
+  std::ostringstream loaderOutput;
+  std::cout.rdbuf(loaderOutput.rdbuf());
+  result.phases.push_back(runPhase("end2end", runs, [&]() {
+    ObjLoader objLoader;
+    objLoader.setMeshCacheEnabled(false);
+    objLoader.setImportThreadCount(threadCount);
+    objLoader.setClusterBuildingEnabled(buildClusters);
+    objLoader.loadObjFile(fileName, "bench");
+  }));
+  std::cout.rdbuf(coutBuffer);
+
+  return result;
+}
+
+// writes a synthetic file with 'scale' copies of the given mesh //
+// absolute indices of every copy are moved behind the records of the preceding copies
+static bool writeScaledCopy(const std::string &fileName, unsigned int scale, const std::string &scaledName) {
+  MappedFile file;
+  if (!file.open(fileName)) {
+    return false;
+  }
+  CountingHandler counter;
+  parseObjLines(file.data(), file.data() + file.size(), counter);
+
+  std::ofstream out(scaledName.c_str(), std::ios::binary);
+  if (!out) {
+    return false;
+  }
+  const char *end = file.data() + file.size();
+  for (unsigned int copy = 0; copy < scale; ++copy) {
+    long offset[3] = {(long)(copy * counter.positionCount), (long)(copy * counter.texcoordCount), (long)(copy * counter.normalCount)};
+    const char *line = file.data();
+    while (line < end) {
+      const char *lineEnd = static_cast<const char*>(memchr(line, '\n', end - line));
+      lineEnd = (lineEnd != NULL) ? lineEnd + 1 : end;
+      if (copy == 0 || lineEnd - line < 2 || line[0] != 'f' || (line[1] != ' ' && line[1] != '\t')) {
+        out.write(line, lineEnd - line);
+      } else {
+        // 'f v/t/n ...' -> shift every positive index by the element count of the preceding copies //
+        out.put('f');
+        const char *cursor = line + 1;
+        unsigned int component = 0;
+        while (cursor < lineEnd) {
+          if (*cursor == '-' || (*cursor >= '0' && *cursor <= '9')) {
+            char *numberEnd;
+            long index = strtol(cursor, &numberEnd, 10);
+            if (index > 0) {
+              index += offset[component];
+            }
+            out << index;
+            cursor = numberEnd;
+          } else {
+            if (*cursor == '/') {
+              component = (component + 1) % 3;
+            } else if (*cursor == ' ' || *cursor == '\t') {
+              component = 0;
+            } else if (*cursor == '#') {
+              out.write(cursor, lineEnd - cursor);
+              break;
+            }
+            out.put(*cursor);
+            ++cursor;
+          }
+        }
+      }
+      // the next copy has to start on a line of its own //
+      if (lineEnd == end && end[-1] != '\n') {
+        out.put('\n');
+      }
+      line = lineEnd;
+    }
+  }
+  return out.good();
+}
+
+static std::string escapeJson(const std::string &text) {
+  std::string escaped;
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '"' || text[i] == '\\') {
+      escaped += '\\';
+    }
+    escaped += text[i];
+  }
+  return escaped;
+}
+
+static double perSecond(double amount, double seconds) {
+  return (seconds > 0.0) ? amount / seconds : 0.0;
+}
+
+static void writeJson(std::ostream &out, const std::vector<FileResult> &results, unsigned int runs, unsigned int threadCount) {
+  out << "{\n  \"runs\": " << runs << ",\n  \"threads\": " << threadCount << ",\n  \"files\": [";
+  for (size_t f = 0; f < results.size(); ++f) {
+    const FileResult &file = results[f];
+    out << (f > 0 ? "," : "") << "\n    {\n";
+    out << "      \"file\": \"" << escapeJson(file.fileName) << "\",\n";
+    out << "      \"scale\": " << file.scale << ",\n";
+    out << "      \"bytes\": " << file.bytes << ",\n";
+    out << "      \"lines\": " << file.lines << ",\n";
+    out << "      \"triangles\": " << file.triangles << ",\n";
+    out << "      \"vertices\": " << file.vertices << ",\n";
+    out << "      \"phases\": {";
+    for (size_t p = 0; p < file.phases.size(); ++p) {
+      const PhaseResult &phase = file.phases[p];
+      out << (p > 0 ? "," : "") << "\n        \"" << phase.name << "\": {"
+          << "\"seconds\": " << phase.seconds
+          << ", \"mb_per_s\": " << perSecond(file.bytes / (1024.0 * 1024.0), phase.seconds)
+          << ", \"lines_per_s\": " << perSecond(file.lines, phase.seconds)
+          << ", \"triangles_per_s\": " << perSecond(file.triangles, phase.seconds)
+          << ", \"allocations\": " << phase.allocations
+          << ", \"peak_rss_kb\": " << phase.peakRssKb << "}";
+    }
+    out << "\n      }\n    }";
+  }
+  out << "\n  ]\n}\n";
+}
+
+static void printResult(const FileResult &file) {
+  printf("%s (x%u): %.2f MB, %zu lines, %zu triangles, %zu vertices\n", file.fileName.c_str(), file.scale,
+         file.bytes / (1024.0 * 1024.0), file.lines, file.triangles, file.vertices);
+  for (size_t p = 0; p < file.phases.size(); ++p) {
+    const PhaseResult &phase = file.phases[p];
+    printf("  %-9s %9.2f ms %9.1f MB/s %12.0f lines/s %12.0f tris/s %9zu allocs %8ld KB peak\n", phase.name.c_str(),
+           phase.seconds * 1000.0, perSecond(file.bytes / (1024.0 * 1024.0), phase.seconds), perSecond(file.lines, phase.seconds),
+           perSecond(file.triangles, phase.seconds), phase.allocations, phase.peakRssKb);
+  }
+}
+
+static void printUsage(const char *program) {
+  std::cout << "usage: " << program << " [-r runs] [-s scales] [-t threads] [-c] [-o result.json] <.obj file> ..." << std::endl;
+}
+
+int main(int argc, char **argv) {
+  unsigned int runs = 3;
+  unsigned int threadCount = 0;
+  bool buildClusters = false;
+  std::vector<unsigned int> scales(1, 1);
+  std::string jsonFileName;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg == "-r" && i + 1 < argc) {
+      runs = std::max(1, atoi(argv[++i]));
+    } else if (arg == "-t" && i + 1 < argc) {
+      threadCount = atoi(argv[++i]);
+    } else if (arg == "-o" && i + 1 < argc) {
+      jsonFileName = argv[++i];
+    } else if (arg == "-s" && i + 1 < argc) {
+      scales.clear();
+      std::stringstream list(argv[++i]);
+      std::string scale;
+      while (std::getline(list, scale, ',')) {
+        if (atoi(scale.c_str()) > 0) {
+          scales.push_back(atoi(scale.c_str()));
+        }
+      }
+    } else if (arg == "-c") {
+      buildClusters = true;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      std::cout << "(loaderbench) - Unknown option or missing value \"" << arg << "\"" << std::endl;
+      printUsage(argv[0]);
+      return 1;
+    } else {
+      files.push_back(arg);
+    }
+  }
+  if (files.empty() || scales.empty()) {
+    printUsage(argv[0]);
+    return 1;
+  }
+  // every phase needs the file -> check them all before spending time on the first one //
+  for (size_t i = 0; i < files.size(); ++i) {
+    MappedFile file;
+    if (!file.open(files[i])) {
+      std::cout << "(loaderbench) - Could not read \"" << files[i] << "\"" << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<FileResult> results;
+  bool failed = false;
+  for (size_t i = 0; i < files.size(); ++i) {
+    for (size_t s = 0; s < scales.size(); ++s) {
+      std::string fileName = files[i];
+      if (scales[s] > 1) {
+        std::string baseName = fileName.substr(fileName.find_last_of('/') + 1);
+        std::ostringstream scaledName;
+        scaledName << "/tmp/loaderbench_x" << scales[s] << "_" << baseName;
+        fileName = scaledName.str();
+        if (!writeScaledCopy(files[i], scales[s], fileName)) {
+          std::cout << "(loaderbench) - Could not write scaled copy \"" << fileName << "\"" << std::endl;
+          unlink(fileName.c_str());
+          failed = true;
+          continue;
+        }
+      }
+      results.push_back(benchmarkFile(fileName, scales[s], runs, threadCount, buildClusters));
+      results.back().fileName = files[i];
+      printResult(results.back());
+      if (scales[s] > 1) {
+        unlink(fileName.c_str());
+      }
+    }
+  }
+
+  if (!jsonFileName.empty()) {
+    std::ofstream json(jsonFileName.c_str());
+    writeJson(json, results, runs, threadCount);
+    if (!json) {
+      std::cout << "(loaderbench) - Could not write \"" << jsonFileName << "\"" << std::endl;
+      return 1;
+    }
+    std::cout << "results written to \"" << jsonFileName << "\"" << std::endl;
+  } else {
+    writeJson(std::cout, results, runs, threadCount);
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,90 @@
+// #INFO# MeshObj without any GL calls -> lets the tools use ObjLoader without a GL context //
+// the mesh data is dropped, nothing is ever rendered
+
+#include "MeshObj.h"
+
+MeshObj::MeshObj() {
+  mVAO = 0;
+  mVBO = 0;
+  mIBO = 0;
+  mIndexCount = 0;
+  mIndexType = GL_UNSIGNED_INT;
+  mIndexSize = sizeof(GLuint);
+  mBufferSize = 0;
+  mVertexFormat = VERTEX_FORMAT_FLOAT;
+  for (unsigned int k = 0; k < 3; ++k) {
+    mPositionOffset[k] = 0.0f;
+    mPositionScale[k] = 1.0f;
+  }
+  setLods(std::vector<MeshLod>());
+}
+
+MeshObj::~MeshObj() {
+}
+
+void MeshObj::setData(const MeshData &data) {
+  mIndexCount = data.indices.size();
+  setLods(data.lods);
+  setGroups(data.groups, data.materialLibraries);
+  setClusters(data.clusters);
+}
+
+void MeshObj::setInterleavedData(const GLfloat *vertexData, GLuint vertexCount, GLuint attributeMask, const GLuint *indices, GLuint indexCount) {
+  (void)vertexData;
+  (void)vertexCount;
+  (void)attributeMask;
+  (void)indices;
+  mIndexCount = indexCount;
+  setLods(std::vector<MeshLod>());
+  setGroups(std::vector<MeshGroup>(), std::vector<std::string>());
+  setClusters(std::vector<MeshCluster>());
+}
+
+void MeshObj::setLods(const std::vector<MeshLod> &lods) {
+  mLods = lods;
+}
+
+void MeshObj::setGroups(const std::vector<MeshGroup> &groups, const std::vector<std::string> &materialLibraries) {
+  mGroups = groups;
+  mMaterialLibraries = materialLibraries;
+}
+
+int MeshObj::findGroup(const std::string &name) const {
+  for (GLuint group = 0; group < mGroups.size(); ++group) {
+    if (mGroups[group].name == name) {
+      return group;
+    }
+  }
+  return -1;
+}
+
+void MeshObj::getBounds(glm::vec3 &boundsMin, glm::vec3 &boundsMax) const {
+  boundsMin = boundsMax = glm::vec3(0.0f);
+}
+
+GLuint MeshObj::selectLod(float pixelsPerUnit, float maxPixelError) const {
+  (void)pixelsPerUnit;
+  (void)maxPixelError;
+  return 0;
+}
+
+void MeshObj::render(void) {
+}
+
+void MeshObj::renderLod(GLuint lod) {
+  (void)lod;
+}
+
+void MeshObj::renderGroup(GLuint group) {
+  (void)group;
+}
+
+void MeshObj::renderGroups(const GLuint *groups, GLuint groupCount) {
+  (void)groups;
+  (void)groupCount;
+}
+
+void MeshObj::renderClusters(const GLuint *clusters, GLuint clusterCount) {
+  (void)clusters;
+  (void)clusterCount;
+}
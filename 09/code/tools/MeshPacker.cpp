@@ -0,0 +1,94 @@
+// #INFO# command line tool to pre-bake the binary mesh caches (see MeshCache) //
+// usage: meshpack [-f] [-c] <directory or mesh file> ...
+//  - directories are searched for .obj, .ply and .stl files (not recursive)
+//  - files with an up to date cache are skipped, unless '-f' is given
+//  - '-c' builds clusters (as Ex09 does), a cache is only used by loaders with the same settings
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "ObjLoader.h"
+#include "MeshCache.h"
+
+static bool hasMeshExtension(const std::string &fileName) {
+  if (fileName.size() <= 4) {
+    return false;
+  }
+  const std::string extension = fileName.substr(fileName.size() - 4);
+  return extension == ".obj" || extension == ".ply" || extension == ".stl";
+}
+
+// collects the mesh files given directly or contained in a given directory //
+static void collectFiles(const std::string &path, std::vector<std::string> &files) {
+  struct stat pathStat;
+  if (stat(path.c_str(), &pathStat) != 0) {
+    std::cout << "(meshpack) - Could not find \"" << path << "\"" << std::endl;
+    return;
+  }
+  if (!S_ISDIR(pathStat.st_mode)) {
+    files.push_back(path);
+    return;
+  }
+  DIR *dir = opendir(path.c_str());
+  if (dir == NULL) {
+    std::cout << "(meshpack) - Could not open directory \"" << path << "\"" << std::endl;
+    return;
+  }
+  std::vector<std::string> dirFiles;
+  for (struct dirent *entry = readdir(dir); entry != NULL; entry = readdir(dir)) {
+    std::string name(entry->d_name);
+    if (hasMeshExtension(name)) {
+      dirFiles.push_back(path + "/" + name);
+    }
+  }
+  closedir(dir);
+  std::sort(dirFiles.begin(), dirFiles.end());
+  files.insert(files.end(), dirFiles.begin(), dirFiles.end());
+}
+
+int main(int argc, char **argv) {
+  bool force = false;
+  bool buildClusters = false;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg == "-f") {
+      force = true;
+    } else if (arg == "-c") {
+      buildClusters = true;
+    } else {
+      collectFiles(arg, files);
+    }
+  }
+  if (files.empty()) {
+    std::cout << "usage: " << argv[0] << " [-f] [-c] <directory or mesh file> ..." << std::endl;
+    return 1;
+  }
+
+  ObjLoader objLoader;
+  objLoader.setClusterBuildingEnabled(buildClusters);
+  const uint64_t settingsHash = objLoader.getImportSettingsHash();
+  int failed = 0;
+  for (size_t i = 0; i < files.size(); ++i) {
+    MeshCache cache;
+    if (!force && cache.open(files[i], settingsHash)) {
+      std::cout << files[i] << ": cache is up to date" << std::endl;
+      continue;
+    }
+    cache.close();
+
+    MeshData meshData;
+    if (!objLoader.importMeshFile(files[i], meshData) || !MeshCache::write(files[i], meshData, settingsHash)) {
+      ++failed;
+      continue;
+    }
+    std::cout << files[i] << ": " << meshData.vertex_position.size() / 3 << " vertices, " << meshData.indices.size() / 3
+              << " triangles -> \"" << MeshCache::getCacheFileName(files[i]) << "\"" << std::endl;
+  }
+  return (failed > 0) ? 1 : 0;
+}
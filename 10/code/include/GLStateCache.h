@@ -0,0 +1,52 @@
+#ifndef __GL_STATE_CACHE__
+#define __GL_STATE_CACHE__
+
+#include <GL/glew.h>
+
+// #INFO# shadow copy of the GL state the exercises change while rendering //
+// program, vertex array, framebuffers, the textures of every unit and the depth / stencil / blend / cull state.
+// all changes of this state go through these functions -> calls that would not change anything are skipped
+// and counted instead. the first call of each kind always reaches the GL, state changed past the cache has
+// to be reported with invalidate(). objects have to be deleted with the delete* functions, the GL unbinds
+// them and may reuse their names.
+class GLStateCache {
+  public:
+    static void useProgram(GLuint program);
+    static void bindVertexArray(GLuint vertexArray);
+    // GL_FRAMEBUFFER sets the draw and the read framebuffer //
+    static void bindFramebuffer(GLenum target, GLuint framebuffer);
+    // binds 'texture' to the texture unit 'unit' (0, 1, ... not GL_TEXTURE0 + i), which stays active //
+    static void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+    // GL_DEPTH_TEST, GL_STENCIL_TEST, GL_BLEND, GL_CULL_FACE, GL_SCISSOR_TEST and GL_POLYGON_OFFSET_FILL //
+    // are cached, other capabilities are passed on
+    static void enable(GLenum capability);
+    static void disable(GLenum capability);
+    static void depthMask(GLboolean flag);
+    static void depthFunc(GLenum func);
+    static void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+    static void blendFunc(GLenum sourceFactor, GLenum destinationFactor);
+    static void cullFace(GLenum mode);
+    static void stencilFunc(GLenum func, GLint reference, GLuint mask);
+    static void stencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass);
+    static void stencilMask(GLuint mask);
+
+    // delete the objects and drop them from the cached bindings //
+    static void deleteProgram(GLuint program);
+    static void deleteVertexArrays(GLsizei count, const GLuint *vertexArrays);
+    static void deleteFramebuffers(GLsizei count, const GLuint *framebuffers);
+    static void deleteTextures(GLsizei count, const GLuint *textures);
+
+    // forgets all cached values, the next call of each kind goes to the GL again //
+    static void invalidate(void);
+
+    // calls sent to the GL and calls skipped because they would not have changed anything //
+    static unsigned long getIssuedCount(void);
+    static unsigned long getElidedCount(void);
+    static void resetCounters(void);
+
+  private:
+    GLStateCache();
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef __GEOMETRY_STORE__
+#define __GEOMETRY_STORE__
+
+#include <cstddef>
+
+#include "MeshObj.h"
+
+// #INFO# read-only CPU copy of the positions and indices of a mesh (shadow volumes, picking, culling) //
+// the data is written to a private file in the temp directory once and mapped into memory only while it is used:
+//  - getPositions() / getIndices() map it again after evict() -> the pages are read back on demand
+//  - mapped pages are clean file pages, the kernel drops them under memory pressure instead of swapping
+// the file is deleted right after it is created, it vanishes with the store (or a crash).
+// if no file can be written the data is kept in anonymous memory instead, evict() keeps it then.
+// a store is shared by reference counting, the last release() deletes it.
+class GeometryStore {
+  public:
+    // copies positions and indices of 'meshData', NULL only if there is not even memory for them //
+    // the new store holds one reference for the caller
+    static GeometryStore* create(const MeshData &meshData);
+
+    void acquire(void) { ++mReferenceCount; }
+    void release(void);
+
+    // 3 floats per vertex, 3 indices per triangle, NULL if the data could not be mapped //
+    const GLfloat* getPositions(void);
+    const GLuint* getIndices(void);
+    GLuint getVertexCount(void) const { return mVertexCount; }
+    GLuint getIndexCount(void) const { return mIndexCount; }
+
+    // unmaps the data, the next get*() maps it again //
+    void evict(void);
+    bool isResident(void) const { return mData != NULL; }
+
+  private:
+    GeometryStore();
+    ~GeometryStore();
+    // not copyable -> the file is owned by exactly one store //
+    GeometryStore(const GeometryStore &);
+    GeometryStore& operator=(const GeometryStore &);
+
+    bool map(void);
+    // unnamed file in the temp directory, -1 if there is none //
+    static int createTempFile(void);
+
+    // descriptor of the deleted file, open as long as the store exists, -1 -> the data is anonymous memory //
+    int mFile;
+    size_t mSize;
+    GLuint mVertexCount;
+    GLuint mIndexCount;
+    unsigned int mReferenceCount;
+    const char *mData;
+};
+
+#endif
@@ -14,6 +14,8 @@
 #include <glm/gtx/rotate_vector.hpp>
 #include <glm/gtx/string_cast.hpp> 
 
+#include "GLStateCache.h"
+
 struct MeshData {
   // data vectors //
   std::vector<GLfloat> vertex_position;
@@ -25,14 +27,22 @@ struct MeshData {
   std::vector<GLuint> indices;
 };
 
+class GeometryStore;
+
 class MeshObj {
   public:
     MeshObj();
     ~MeshObj();
     
+    // uploads 'data', no CPU copy is kept //
     void setData(const MeshData &data);
     void render(void);
     
+    // CPU copy of the geometry for the shadow volumes, the MeshObj holds a reference (NULL -> none) //
+    void setGeometryStore(GeometryStore *store);
+    GeometryStore* getGeometryStore(void) const { return mGeometryStore; }
+    
+    // needs a geometry store (see ObjLoader::setGeometryResidency) //
     void initShadowVolume(glm::vec3 lightPos);
     void renderShadowVolume();
     
@@ -48,9 +58,9 @@ class MeshObj {
     GLuint mIBO;
     GLuint mIndexCount;
     
-    // #INFO# local copy of the original mesh data    //
-    //  - needed to compute shadow volumes on the fly //
-    MeshData mMeshData;
+    // #INFO# positions and indices of the original mesh data //
+    //  - needed to compute shadow volumes on the fly        //
+    GeometryStore *mGeometryStore;
     
     // #INFO# vertex buffer object for shadow volume //
     GLuint mVAO_shadow;
@@ -3,10 +3,20 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <glm/glm.hpp>
 
 #include "MeshObj.h"
+#include "GeometryStore.h"
+
+// what stays on the CPU of a mesh once it is uploaded //
+enum GeometryResidency {
+  // nothing, the mesh can only be rendered //
+  GEOMETRY_DISCARD = 0,
+  // positions and indices in a GeometryStore shared by all MeshObjs of a file (shadow volumes, picking, ...) //
+  GEOMETRY_STORE
+};
 
 class ObjLoader {
   public:
@@ -14,9 +24,15 @@ class ObjLoader {
     ~ObjLoader();
     MeshObj* loadObjFile(std::string fileName, std::string ID = "");
     MeshObj* getMeshObj(std::string ID);
+    // residency of the meshes loaded from now on, GEOMETRY_DISCARD by default //
+    void setGeometryResidency(GeometryResidency residency) { mGeometryResidency = residency; }
   private:
     std::map<std::string, MeshObj*> mMeshMap;
+    // one store per file, the loader holds a reference to each //
+    std::map<std::string, GeometryStore*> mGeometryStores;
+    GeometryResidency mGeometryResidency;
     
+    void computeMissingNormals(MeshData &meshData, const std::vector<int> &positionIds, size_t positionCount);
     void computeTangentSpace(MeshData &meshData);
 };
 
@@ -16,6 +16,8 @@
 
 #include "ObjLoader.h"
 #include "CameraController.h"
+#include "ShaderProgram.h"
+#include "GLStateCache.h"
 
 #include <sstream>
 #include <opencv/cv.h>
@@ -34,18 +36,31 @@ char* loadShaderSource(const char* fileName);
 GLuint loadShaderFile(const char* fileName, GLenum shaderType);
 // the used shader program //
 GLuint shaderProgram = 0;
-// this map stores uniform locations of our shader program //
-std::map<std::string, GLint> uniformLocations;
+// active uniforms of the program, resolved once after linking //
+ShaderProgram shader;
 
-// this struct helps to keep light source parameter uniforms together //
+// these structs help to keep light source and material parameter uniforms together //
 struct UniformLocation_Light {
     GLint ambient_color;
     GLint diffuse_color;
     GLint specular_color;
     GLint position;
 };
-// this map stores the light source uniform locations as 'UniformLocation_Light' structs //
-std::map<std::string, UniformLocation_Light> uniformLocations_Lights;
+struct UniformLocation_Material {
+    GLint ambient;
+    GLint diffuse;
+    GLint specular;
+    GLint shininess;
+};
+// this struct stores uniform locations of our shader program -> no lookups while rendering //
+struct UniformLocations {
+    GLint projection;
+    GLint modelview;
+    GLint drawShadows;
+    UniformLocation_Material material;
+    UniformLocation_Light lightSource;
+};
+UniformLocations uniformLocations;
 
 // these structs are also used in the shader code  //
 // this helps to access the parameters more easily //
@@ -168,7 +183,7 @@ int main (int argc, char **argv) {
 
 void initGL() {
     glClearColor(0.0, 0.0, 0.0, 0.0);
-    glEnable(GL_DEPTH_TEST);
+    GLStateCache::enable(GL_DEPTH_TEST);
 }
 
 std::string getUniformStructLocStr(const std::string &structName, const std::string &memberName, int arrayIndex = -1) {
@@ -291,12 +306,12 @@ GLuint createShader(const char* vertexProgramCode, const char* fragmentProgramCo
     GLuint vertexShader = 0;
     GLuint fragmentShader = 0;
     if (!loadShaderCode(vertexProgramCode, vertexShader, fragmentProgramCode, fragmentShader)) {
-        glDeleteProgram(program);
+        GLStateCache::deleteProgram(program);
         return 0;
     }
 
     if (!attachAndLink(program, vertexShader, fragmentShader)) {
-        glDeleteProgram(program);
+        GLStateCache::deleteProgram(program);
         return 0;
     }
 
@@ -315,30 +330,28 @@ void initShader() {
     glBindFragDataLocation(shaderProgram, 0, "color");
 
     // get uniform locations for common variables //
-    uniformLocations["projection"] = glGetUniformLocation(shaderProgram, "projection");
-    uniformLocations["modelview"] = glGetUniformLocation(shaderProgram, "modelview");
-    uniformLocations["drawShadows"]= glGetUniformLocation(shaderProgram, "drawShadows");
+    shader.setProgram(shaderProgram);
+    uniformLocations.projection = shader.getUniformLocation("projection");
+    uniformLocations.modelview = shader.getUniformLocation("modelview");
+    uniformLocations.drawShadows = shader.getUniformLocation("drawShadows");
 
     // material unform locations //
-    uniformLocations["material.ambient"] = glGetUniformLocation(shaderProgram, "material.ambient_color");
-    uniformLocations["material.diffuse"] = glGetUniformLocation(shaderProgram, "material.diffuse_color");
-    uniformLocations["material.specular"] = glGetUniformLocation(shaderProgram, "material.specular_color");
-    uniformLocations["material.shininess"] = glGetUniformLocation(shaderProgram, "material.specular_shininess");
-
-    uniformLocations["drawShadows"] = glGetUniformLocation(shaderProgram, "drawShadows");
+    uniformLocations.material.ambient = shader.getUniformLocation("material.ambient_color");
+    uniformLocations.material.diffuse = shader.getUniformLocation("material.diffuse_color");
+    uniformLocations.material.specular = shader.getUniformLocation("material.specular_color");
+    uniformLocations.material.shininess = shader.getUniformLocation("material.specular_shininess");
 
     // store the uniform locations for all light source properties
-    UniformLocation_Light lightLocation;
-    lightLocation.ambient_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "ambient_color").c_str());
-    lightLocation.diffuse_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "diffuse_color").c_str());
-    lightLocation.specular_color = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "specular_color").c_str());
-    lightLocation.position = glGetUniformLocation(shaderProgram, getUniformStructLocStr("lightSource", "position").c_str());
-    uniformLocations_Lights["light"] = lightLocation;
+    UniformLocation_Light &lightLocation = uniformLocations.lightSource;
+    lightLocation.ambient_color = shader.getUniformLocation(getUniformStructLocStr("lightSource", "ambient_color").c_str());
+    lightLocation.diffuse_color = shader.getUniformLocation(getUniformStructLocStr("lightSource", "diffuse_color").c_str());
+    lightLocation.specular_color = shader.getUniformLocation(getUniformStructLocStr("lightSource", "specular_color").c_str());
+    lightLocation.position = shader.getUniformLocation(getUniformStructLocStr("lightSource", "position").c_str());
 }
 
 bool enableShader() {
     if (shaderProgram > 0) {
-        glUseProgram(shaderProgram);
+        GLStateCache::useProgram(shaderProgram);
     } else {
         std::cout << "(enableShader) - Shader program not initialized." << std::endl;
     }
@@ -346,14 +359,14 @@ bool enableShader() {
 }
 
 void disableShader() {
-    glUseProgram(0);
+    GLStateCache::useProgram(0);
 }
 
 void deleteShader() {
     // use standard pipeline //
-    glUseProgram(0);
+    GLStateCache::useProgram(0);
     // delete shader program //
-    glDeleteProgram(shaderProgram);
+    GLStateCache::deleteProgram(shaderProgram);
     shaderProgram = 0;
 }
 
@@ -361,6 +374,8 @@ void initScene() {
     camera.setFar(1000.0f);
 
     // load scene.obj from disk and create renderable MeshObj //
+    // the shadow volumes are built from the positions on the CPU -> keep them in a geometry store
+    objLoader.setGeometryResidency(GEOMETRY_STORE);
     objLoader.loadObjFile("../meshes/testbox.obj", "sceneObject");
 
     // init materials //
@@ -384,17 +399,17 @@ void initScene() {
 
 void setupLightAndMaterial() {
     // uploads the properties of the currently active light sources here //
-    UniformLocation_Light &light_uniform = uniformLocations_Lights["light"];
+    const UniformLocation_Light &light_uniform = uniformLocations.lightSource;
     glUniform3fv(light_uniform.position, 1, glm::value_ptr(light.position));
     glUniform3fv(light_uniform.ambient_color, 1, glm::value_ptr(light.ambient_color));
     glUniform3fv(light_uniform.diffuse_color, 1, glm::value_ptr(light.diffuse_color));
     glUniform3fv(light_uniform.specular_color, 1, glm::value_ptr(light.specular_color));
 
     // uploads the chosen material properties here //
-    glUniform3fv(uniformLocations["material.ambient"], 1, glm::value_ptr(materials[materialIndex].ambient_color));
-    glUniform3fv(uniformLocations["material.diffuse"], 1, glm::value_ptr(materials[materialIndex].diffuse_color));
-    glUniform3fv(uniformLocations["material.specular"], 1, glm::value_ptr(materials[materialIndex].specular_color));
-    glUniform1f(uniformLocations["material.shininess"], materials[materialIndex].specular_shininess);
+    glUniform3fv(uniformLocations.material.ambient, 1, glm::value_ptr(materials[materialIndex].ambient_color));
+    glUniform3fv(uniformLocations.material.diffuse, 1, glm::value_ptr(materials[materialIndex].diffuse_color));
+    glUniform3fv(uniformLocations.material.specular, 1, glm::value_ptr(materials[materialIndex].specular_color));
+    glUniform1f(uniformLocations.material.shininess, materials[materialIndex].specular_shininess);
 }
 
 // #INFO# creates a screen filling quad as a new MeshObj (stored in screenQuad) //
@@ -441,13 +456,13 @@ void initScreenFillingQuad(void) {
 
 // #INFO#: this renders the scene object usign material and lighting //
 void renderScene() {
-    glUniform1i(uniformLocations["drawShadows"], 0);
+    glUniform1i(uniformLocations.drawShadows, 0);
     glm_ModelViewMatrix.push(glm_ModelViewMatrix.top());
 
     glm_ModelViewMatrix.top() *= glm::scale(glm::vec3(10));
 
-    glUniformMatrix4fv(uniformLocations["modelview"], 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
-    glUniform1i(uniformLocations["drawShadows"], 0);
+    glUniformMatrix4fv(uniformLocations.modelview, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+    glUniform1i(uniformLocations.drawShadows, 0);
 
     // setup light and material in shader //
     setupLightAndMaterial();
@@ -463,51 +478,56 @@ void renderScene() {
 // #INFO# this renders a screen filling quad                                      //
 // - note that it resets the modelview and projection to an orthogonal projection //
 void renderScreenFillingQuad() {
-    glDisable(GL_DEPTH_TEST);
+    GLStateCache::disable(GL_DEPTH_TEST);
 
     if (!screenQuad) initScreenFillingQuad();
 
     // upload transformation matrices matrix for orthogonal projection //
-    glUniformMatrix4fv(uniformLocations["projection"], 1, false, glm::value_ptr(glm::ortho(0.0f, 1.0f, 0.0f, 1.0f)));
-    glUniformMatrix4fv(uniformLocations["modelview"], 1, false, glm::value_ptr(glm::mat4(1)));
+    glUniformMatrix4fv(uniformLocations.projection, 1, false, glm::value_ptr(glm::ortho(0.0f, 1.0f, 0.0f, 1.0f)));
+    glUniformMatrix4fv(uniformLocations.modelview, 1, false, glm::value_ptr(glm::mat4(1)));
     screenQuad->render();
 
-    glEnable(GL_DEPTH_TEST);
+    GLStateCache::enable(GL_DEPTH_TEST);
 }
 
 // Done TODO: render the shadow volume here using the chosen shadow volume rendering technique //
 void renderShadow() {
-    glUniform1i(uniformLocations["drawShadows"], 1);
+    glUniform1i(uniformLocations.drawShadows, 1);
 
     // #INFO# init shadow volume if light source position has changed //
     if (lightSourcePosUpdate) {
-        objLoader.getMeshObj("sceneObject")->initShadowVolume(light.position);
+        MeshObj *sceneObject = objLoader.getMeshObj("sceneObject");
+        sceneObject->initShadowVolume(light.position);
+        // the positions are needed again only when the light moves -> unmap them until then //
+        if (sceneObject->getGeometryStore()) {
+            sceneObject->getGeometryStore()->evict();
+        }
         lightSourcePosUpdate = false;
     }
 
     //Done TODO: disable drawing to screen (we just want to change the stencil buffer) //
-    glColorMask(GL_FALSE,GL_FALSE,GL_FALSE,GL_FALSE);
-    glDepthMask(GL_FALSE);
+    GLStateCache::colorMask(GL_FALSE,GL_FALSE,GL_FALSE,GL_FALSE);
+    GLStateCache::depthMask(GL_FALSE);
     //Done TODO: enable stencil test and face culling //
     // - we need face culling to separately render front facing and back facing triangles //
-    glEnable(GL_STENCIL_TEST);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
+    GLStateCache::enable(GL_STENCIL_TEST);
+    GLStateCache::enable(GL_CULL_FACE);
+    GLStateCache::cullFace(GL_BACK);
     //Done TODO: implement the shadow volume rendering //
-    glStencilFunc(GL_ALWAYS, 1 , 0xFFFFFFFF);
-    glStencilOp(GL_KEEP,GL_KEEP,GL_INCR);
+    GLStateCache::stencilFunc(GL_ALWAYS, 1 , 0xFFFFFFFF);
+    GLStateCache::stencilOp(GL_KEEP,GL_KEEP,GL_INCR);
 
     glm_ModelViewMatrix.push(glm_ModelViewMatrix.top());
     glm_ModelViewMatrix.top() *= glm::scale(glm::vec3(10));
-    glUniformMatrix4fv(uniformLocations["modelview"], 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
-    glUniform1i(uniformLocations["drawShadows"], 1);
+    glUniformMatrix4fv(uniformLocations.modelview, 1, false, glm::value_ptr(glm_ModelViewMatrix.top()));
+    glUniform1i(uniformLocations.drawShadows, 1);
     
 
     MeshObj *mesh = objLoader.getMeshObj("sceneObject");
     mesh->renderShadowVolume();
 
-    glStencilOp(GL_KEEP,GL_KEEP,GL_DECR);
-    glCullFace(GL_FRONT);
+    GLStateCache::stencilOp(GL_KEEP,GL_KEEP,GL_DECR);
+    GLStateCache::cullFace(GL_FRONT);
 
     mesh->renderShadowVolume();
 
@@ -515,24 +535,24 @@ void renderShadow() {
     glm_ModelViewMatrix.pop();
     //Done TODO: final render pass -> render screen quad with current stencil buffer //
     // - disable face culling and re-enable writing to color and depth buffer    //
-    glDisable(GL_CULL_FACE);
-    glColorMask(GL_TRUE,GL_TRUE, GL_TRUE,GL_TRUE);
+    GLStateCache::disable(GL_CULL_FACE);
+    GLStateCache::colorMask(GL_TRUE,GL_TRUE, GL_TRUE,GL_TRUE);
     // - set stencil operation to only execute, when stencil buffer is not equal to zero //
-    glStencilFunc(GL_NOTEQUAL, 0, 0xFFFFFFFF);
+    GLStateCache::stencilFunc(GL_NOTEQUAL, 0, 0xFFFFFFFF);
     // OPTION: enable blend function to prevent shadows from being pitch black //
     // - uses alpha of color defined when rendering the screen filling quad    //
-    glEnable( GL_BLEND );
-    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+    GLStateCache::enable( GL_BLEND );
+    GLStateCache::blendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
 
     renderScreenFillingQuad();
-    glDisable( GL_BLEND );
+    GLStateCache::disable( GL_BLEND );
 
 
     //Done TODO: disable stencil testing for further rendering and restore original rendering state //
-    glDisable(GL_STENCIL_TEST);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glDepthMask(GL_TRUE);
+    GLStateCache::disable(GL_STENCIL_TEST);
+    GLStateCache::enable(GL_CULL_FACE);
+    GLStateCache::cullFace(GL_BACK);
+    GLStateCache::depthMask(GL_TRUE);
 }
 
 void updateGL() {
@@ -545,7 +565,7 @@ void updateGL() {
     // get projection mat from camera controller //
     glm_ProjectionMatrix.top() = camera.getProjectionMat();
     // upload projection matrix //
-    glUniformMatrix4fv(uniformLocations["projection"], 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
+    glUniformMatrix4fv(uniformLocations.projection, 1, false, glm::value_ptr(glm_ProjectionMatrix.top()));
 
     // init scene graph by cloning the top entry, which can now be manipulated //
     // get modelview mat from camera controller //
@@ -0,0 +1,132 @@
+#include "GeometryStore.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+// writes all 'size' bytes, write() may return early //
+static bool writeAll(int file, const void *data, size_t size) {
+  const char *bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t written = ::write(file, bytes, size);
+    if (written <= 0) {
+      return false;
+    }
+    bytes += written;
+    size -= written;
+  }
+  return true;
+}
+
+GeometryStore::GeometryStore() {
+  mFile = -1;
+  mSize = 0;
+  mVertexCount = 0;
+  mIndexCount = 0;
+  mReferenceCount = 1;
+  mData = NULL;
+}
+
+GeometryStore::~GeometryStore() {
+  if (mFile >= 0) {
+    evict();
+    ::close(mFile);
+  } else if (mData != NULL) {
+    munmap(const_cast<char*>(mData), mSize);
+  }
+}
+
+int GeometryStore::createTempFile(void) {
+  const char *tempDir = getenv("TMPDIR");
+  std::string pattern = std::string((tempDir != NULL && tempDir[0] != '\0') ? tempDir : "/tmp") + "/geometry-XXXXXX";
+  // mkstemp picks a new name and opens it exclusively -> every store has a file of its own //
+  std::vector<char> fileName(pattern.begin(), pattern.end());
+  fileName.push_back('\0');
+  int file = mkstemp(&fileName[0]);
+  if (file >= 0) {
+    // the open descriptor keeps the data alive, nobody else needs the name //
+    ::unlink(&fileName[0]);
+  }
+  return file;
+}
+
+GeometryStore* GeometryStore::create(const MeshData &meshData) {
+  const size_t positionSize = meshData.vertex_position.size() * sizeof(GLfloat);
+  const size_t indexSize = meshData.indices.size() * sizeof(GLuint);
+
+  int file = createTempFile();
+  if (file >= 0 && ((positionSize > 0 && !writeAll(file, &meshData.vertex_position[0], positionSize)) ||
+                    (indexSize > 0 && !writeAll(file, &meshData.indices[0], indexSize)))) {
+    ::close(file);
+    file = -1;
+  }
+
+  GeometryStore *store = new GeometryStore();
+  store->mFile = file;
+  store->mSize = positionSize + indexSize;
+  store->mVertexCount = meshData.vertex_position.size() / 3;
+  store->mIndexCount = meshData.indices.size();
+  if (file < 0 && store->mSize > 0) {
+    // no file (full or read-only temp directory, ...) -> keep the data in anonymous memory //
+    std::cout << "(GeometryStore::create) - WARNING: Could not write a temporary file, the geometry stays in memory" << std::endl;
+    void *mapping = mmap(NULL, store->mSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+      std::cout << "(GeometryStore::create) - ERROR: Could not allocate " << store->mSize << " bytes" << std::endl;
+      delete store;
+      return NULL;
+    }
+    char *data = static_cast<char*>(mapping);
+    if (positionSize > 0) {
+      memcpy(data, &meshData.vertex_position[0], positionSize);
+    }
+    if (indexSize > 0) {
+      memcpy(data + positionSize, &meshData.indices[0], indexSize);
+    }
+    mprotect(mapping, store->mSize, PROT_READ);
+    store->mData = data;
+  }
+  return store;
+}
+
+void GeometryStore::release(void) {
+  if (--mReferenceCount == 0) {
+    delete this;
+  }
+}
+
+bool GeometryStore::map(void) {
+  if (mData != NULL) {
+    return true;
+  }
+  if (mSize == 0 || mFile < 0) {
+    return false;
+  }
+  void *mapping = mmap(NULL, mSize, PROT_READ, MAP_SHARED, mFile, 0);
+  if (mapping == MAP_FAILED) {
+    std::cout << "(GeometryStore::map) - ERROR: Could not map " << mSize << " bytes" << std::endl;
+    return false;
+  }
+  mData = static_cast<const char*>(mapping);
+  return true;
+}
+
+const GLfloat* GeometryStore::getPositions(void) {
+  return map() ? reinterpret_cast<const GLfloat*>(mData) : NULL;
+}
+
+const GLuint* GeometryStore::getIndices(void) {
+  return map() ? reinterpret_cast<const GLuint*>(mData + mVertexCount * 3 * sizeof(GLfloat)) : NULL;
+}
+
+void GeometryStore::evict(void) {
+  // anonymous memory can not be read back -> it stays //
+  if (mData != NULL && mFile >= 0) {
+    munmap(const_cast<char*>(mData), mSize);
+    mData = NULL;
+  }
+}
@@ -1,4 +1,5 @@
 #include "MeshObj.h"
+#include "GeometryStore.h"
 #include <iostream>
 #include <limits>
 
@@ -16,6 +17,7 @@ MeshObj::MeshObj() {
     mVBO_shadow_position = 0;
     mIBO_shadow = 0;
     mIndexCount_shadow = 0;
+    mGeometryStore = NULL;
 }
 
 MeshObj::~MeshObj() {
@@ -25,66 +27,42 @@ MeshObj::~MeshObj() {
     if (mVBO_texcoord) glDeleteBuffers(1, &mVBO_texcoord);
     if (mVBO_tangent) glDeleteBuffers(1, &mVBO_tangent);
     if (mVBO_binormal) glDeleteBuffers(1, &mVBO_binormal);
-    if (mVAO) glDeleteVertexArrays(1, &mVAO);
+    if (mVAO) GLStateCache::deleteVertexArrays(1, &mVAO);
     // clean up shadow volume //
     if (mIBO_shadow) glDeleteBuffers(1, &mIBO_shadow);
     if (mVBO_shadow_position) glDeleteBuffers(1, &mVBO_shadow_position);
-    if (mVAO_shadow) glDeleteVertexArrays(1, &mVAO_shadow);
+    if (mVAO_shadow) GLStateCache::deleteVertexArrays(1, &mVAO_shadow);
+    setGeometryStore(NULL);
 }
 
-void MeshObj::setData(const MeshData &meshData) {
-    // Done TODO: copy mesh data into local mMeshData container (only vertex positions and indices needed) // You will need the vertex data to create shadow volumes later on //
-    mMeshData.vertex_position.clear();
-    mMeshData.vertex_position.assign(meshData.vertex_position.begin(), meshData.vertex_position.end());
-    mMeshData.indices.clear();
-    mMeshData.indices.assign(meshData.indices.begin(), meshData.indices.end());
+void MeshObj::setGeometryStore(GeometryStore *store) {
+    if (store) store->acquire();
+    if (mGeometryStore) mGeometryStore->release();
+    mGeometryStore = store;
+}
 
+void MeshObj::setData(const MeshData &meshData) {
     mIndexCount = meshData.indices.size();
 
-    // create local storage arrays for vertices, normals and indices //
+    // the attributes are uploaded straight from the vectors, nothing is kept on the CPU //
     unsigned int vertexDataSize = meshData.vertex_position.size();
     unsigned int vertexNormalSize = meshData.vertex_normal.size();
     unsigned int vertexTexcoordSize = meshData.vertex_texcoord.size();
     unsigned int vertexTangentSize = meshData.vertex_tangent.size();
     unsigned int vertexBinormalSize = meshData.vertex_binormal.size();
 
-    GLfloat *vertex_position = new GLfloat[vertexDataSize]();
-    std::copy(meshData.vertex_position.begin(), meshData.vertex_position.end(), vertex_position);
-    GLfloat *vertex_normal = NULL;
-    if (vertexNormalSize > 0) {
-        vertex_normal = new GLfloat[vertexNormalSize]();
-        std::copy(meshData.vertex_normal.begin(), meshData.vertex_normal.end(), vertex_normal);
-    }
-    GLfloat *vertex_texcoord = NULL;
-    if (vertexTexcoordSize > 0) {
-        vertex_texcoord = new GLfloat[vertexTexcoordSize]();
-        std::copy(meshData.vertex_texcoord.begin(), meshData.vertex_texcoord.end(), vertex_texcoord);
-    }
-    GLfloat *vertex_tangent = NULL;
-    if (vertexTangentSize > 0) {
-        vertex_tangent = new GLfloat[vertexTangentSize]();
-        std::copy(meshData.vertex_tangent.begin(), meshData.vertex_tangent.end(), vertex_tangent);
-    }
-    GLfloat *vertex_binormal = NULL;
-    if (vertexBinormalSize > 0) {
-        vertex_binormal = new GLfloat[vertexBinormalSize]();
-        std::copy(meshData.vertex_binormal.begin(), meshData.vertex_binormal.end(), vertex_binormal);
-    }
-    GLuint *indices = new GLuint[mIndexCount]();
-    std::copy(meshData.indices.begin(), meshData.indices.end(), indices);
-
     // create VAO //
     if (mVAO == 0) {
         glGenVertexArrays(1, &mVAO);
     }
-    glBindVertexArray(mVAO);
+    GLStateCache::bindVertexArray(mVAO);
 
     // create and bind VBOs and upload data (one VBO per available vertex attribute -> position, normal) //
     if (mVBO_position == 0) {
         glGenBuffers(1, &mVBO_position);
     }
     glBindBuffer(GL_ARRAY_BUFFER, mVBO_position);
-    glBufferData(GL_ARRAY_BUFFER, vertexDataSize * sizeof(GLfloat), &vertex_position[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertexDataSize * sizeof(GLfloat), vertexDataSize > 0 ? &meshData.vertex_position[0] : NULL, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
     glEnableVertexAttribArray(0);
 
@@ -93,7 +71,7 @@ void MeshObj::setData(const MeshData &meshData) {
             glGenBuffers(1, &mVBO_normal);
         }
         glBindBuffer(GL_ARRAY_BUFFER, mVBO_normal);
-        glBufferData(GL_ARRAY_BUFFER, vertexNormalSize * sizeof(GLfloat), &vertex_normal[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, vertexNormalSize * sizeof(GLfloat), vertexNormalSize > 0 ? &meshData.vertex_normal[0] : NULL, GL_STATIC_DRAW);
         glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
         glEnableVertexAttribArray(1);
     }
@@ -103,7 +81,7 @@ void MeshObj::setData(const MeshData &meshData) {
             glGenBuffers(1, &mVBO_texcoord);
         }
         glBindBuffer(GL_ARRAY_BUFFER, mVBO_texcoord);
-        glBufferData(GL_ARRAY_BUFFER, vertexTexcoordSize * sizeof(GLfloat), &vertex_texcoord[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, vertexTexcoordSize * sizeof(GLfloat), vertexTexcoordSize > 0 ? &meshData.vertex_texcoord[0] : NULL, GL_STATIC_DRAW);
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
         glEnableVertexAttribArray(2);
     }
@@ -113,7 +91,7 @@ void MeshObj::setData(const MeshData &meshData) {
             glGenBuffers(1, &mVBO_tangent);
         }
         glBindBuffer(GL_ARRAY_BUFFER, mVBO_tangent);
-        glBufferData(GL_ARRAY_BUFFER, vertexTangentSize * sizeof(GLfloat), &vertex_tangent[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, vertexTangentSize * sizeof(GLfloat), vertexTangentSize > 0 ? &meshData.vertex_tangent[0] : NULL, GL_STATIC_DRAW);
         glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
         glEnableVertexAttribArray(3);
     }
@@ -123,7 +101,7 @@ void MeshObj::setData(const MeshData &meshData) {
             glGenBuffers(1, &mVBO_binormal);
         }
         glBindBuffer(GL_ARRAY_BUFFER, mVBO_binormal);
-        glBufferData(GL_ARRAY_BUFFER, vertexBinormalSize * sizeof(GLfloat), &vertex_binormal[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, vertexBinormalSize * sizeof(GLfloat), vertexBinormalSize > 0 ? &meshData.vertex_binormal[0] : NULL, GL_STATIC_DRAW);
         glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
         glEnableVertexAttribArray(4);
     }
@@ -133,34 +111,17 @@ void MeshObj::setData(const MeshData &meshData) {
         glGenBuffers(1, &mIBO);
     }
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndexCount * sizeof(GLuint), &indices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndexCount * sizeof(GLuint), mIndexCount > 0 ? &meshData.indices[0] : NULL, GL_STATIC_DRAW);
 
     // unbind buffers //
-    glBindVertexArray(0);
-
-    // make sure to clean up temporarily allocated data, if neccessary //
-    delete[] vertex_position;
-    if (vertexNormalSize > 0) {
-        delete[] vertex_normal;
-    }
-    if (vertexTexcoordSize > 0) {
-        delete[] vertex_texcoord;
-    }
-    if (vertexTangentSize > 0) {
-        delete[] vertex_tangent;
-    }
-    if (vertexBinormalSize > 0) {
-        delete[] vertex_binormal;
-    }
-    delete[] indices;
+    GLStateCache::bindVertexArray(0);
 }
 
 void MeshObj::render(void) {
     // render your VAO //
     if (mVAO != 0) {
-        glBindVertexArray(mVAO);
+        GLStateCache::bindVertexArray(mVAO);
         glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, (void*)0);
-        glBindVertexArray(0);
     }
 }
 
@@ -170,10 +131,15 @@ void MeshObj::initShadowVolume(glm::vec3 lightPos) {
     // you might want to use a MeshData container //
     MeshData shadows;
     // TODO: clone existing vertex data into your local storage //
-    shadows.vertex_position.clear();
-    shadows.vertex_position.assign(mMeshData.vertex_position.begin(), mMeshData.vertex_position.end());
-    shadows.indices.clear();
-    shadows.indices.assign(mMeshData.indices.begin(), mMeshData.indices.end());
+    // the store maps its data again if it was evicted //
+    const GLfloat *positions = mGeometryStore ? mGeometryStore->getPositions() : NULL;
+    const GLuint *indices = mGeometryStore ? mGeometryStore->getIndices() : NULL;
+    if (positions == NULL || indices == NULL) {
+        std::cout << "(MeshObj::initShadowVolume) - WARNING: No geometry store, the mesh casts no shadow" << std::endl;
+        return;
+    }
+    shadows.vertex_position.assign(positions, positions + 3 * mGeometryStore->getVertexCount());
+    shadows.indices.assign(indices, indices + mGeometryStore->getIndexCount());
 
     // TODO: for every vertex:                         //
     // - project vertex from lightsource to *infinity* //
@@ -274,7 +240,7 @@ void MeshObj::initShadowVolume(glm::vec3 lightPos) {
     if(mVAO_shadow == 0 ){
         glGenVertexArrays(1, &mVAO_shadow);
     }
-    glBindVertexArray(mVAO_shadow);
+    GLStateCache::bindVertexArray(mVAO_shadow);
 
     if(mVBO_shadow_position == 0){
         glGenBuffers(1,&mVBO_shadow_position);
@@ -291,7 +257,7 @@ void MeshObj::initShadowVolume(glm::vec3 lightPos) {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIBO_shadow);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndexCount_shadow*sizeof(GLuint),&vertexIndices[0],GL_STATIC_DRAW);
 
-    glBindVertexArray(0);
+    GLStateCache::bindVertexArray(0);
 
     if(mIndexCount_shadow > 0){
         delete[] vertexIndices;
@@ -304,8 +270,7 @@ void MeshObj::initShadowVolume(glm::vec3 lightPos) {
 // TODO: render the shadow volume by calling the vertex array object //
 void MeshObj::renderShadowVolume() {
     if(mVAO_shadow != 0 ){
-        glBindVertexArray(mVAO_shadow);
+        GLStateCache::bindVertexArray(mVAO_shadow);
         glDrawElements(GL_TRIANGLES,mIndexCount_shadow,GL_UNSIGNED_INT,(void*)0);
-        glBindVertexArray(0);
     }
 }
@@ -6,6 +6,7 @@
 #include <cmath>
 
 ObjLoader::ObjLoader() {
+  mGeometryResidency = GEOMETRY_DISCARD;
 }
 
 ObjLoader::~ObjLoader() {
@@ -14,6 +15,11 @@ ObjLoader::~ObjLoader() {
     iter->second = NULL;
   }
   mMeshMap.clear();
+  // the MeshObjs are gone -> these are the last references //
+  for (std::map<std::string, GeometryStore*>::iterator iter = mGeometryStores.begin(); iter != mGeometryStores.end(); ++iter) {
+    iter->second->release();
+  }
+  mGeometryStores.clear();
 }
 
 MeshObj* ObjLoader::loadObjFile(std::string fileName, std::string ID) {
@@ -166,6 +172,9 @@ MeshObj* ObjLoader::loadObjFile(std::string fileName, std::string ID) {
     // hint: you might want to use a std::map to remember already known id-triplets and their indices
     MeshData meshData;
     std::map<std::string, unsigned int> vertexIdMap;
+    // position of every new vertex -> needed to fill in missing normals //
+    std::vector<int> vertexPositionIds;
+    bool normalsMissing = false;
     for (std::vector<std::vector<glm::vec3> >::iterator faceIter = localFace.begin(); faceIter != localFace.end(); ++faceIter) {
       std::string vertexId("");
       const char* idPattern = "%08d|%08d|%08d";
@@ -187,13 +196,17 @@ MeshObj* ObjLoader::loadObjFile(std::string fileName, std::string ID) {
           meshData.vertex_position.push_back(position.x);
 	  meshData.vertex_position.push_back(position.y);
 	  meshData.vertex_position.push_back(position.z);
-          // add vertex normal data //
-	  if (ni >= 0) {
-	    glm::vec3 normal = localVertexNormal[ni];
-	    meshData.vertex_normal.push_back(normal.x);
-	    meshData.vertex_normal.push_back(normal.y);
-	    meshData.vertex_normal.push_back(normal.z);
+          vertexPositionIds.push_back(vi);
+          // add vertex normal data, a missing normal is computed below //
+	  glm::vec3 normal(0);
+	  if (ni >= 0 && ni < (int)localVertexNormal.size()) {
+	    normal = localVertexNormal[ni];
+	  } else {
+	    normalsMissing = true;
 	  }
+	  meshData.vertex_normal.push_back(normal.x);
+	  meshData.vertex_normal.push_back(normal.y);
+	  meshData.vertex_normal.push_back(normal.z);
 	  // add vertex texture coord data //
 	  if (ti >= 0) {
 	    glm::vec2 texcoord = localVertexTexcoord[ti];
@@ -210,6 +223,17 @@ MeshObj* ObjLoader::loadObjFile(std::string fileName, std::string ID) {
       }
     }
     
+    if (normalsMissing) {
+      computeMissingNormals(meshData, vertexPositionIds, localVertexPosition.size());
+    }
+    
+    // the parsed lists are not needed anymore -> free them before the upload //
+    std::vector<glm::vec3>().swap(localVertexPosition);
+    std::vector<glm::vec3>().swap(localVertexNormal);
+    std::vector<glm::vec2>().swap(localVertexTexcoord);
+    std::vector<std::vector<glm::vec3> >().swap(localFace);
+    vertexIdMap.clear();
+    
     // compute tangent space //
     if (meshData.vertex_texcoord.size() > 0) {
       computeTangentSpace(meshData);
@@ -219,6 +243,18 @@ MeshObj* ObjLoader::loadObjFile(std::string fileName, std::string ID) {
     meshObj = new MeshObj();
     // assign imported data to this new MeshObj //
     meshObj->setData(meshData);
+    if (mGeometryResidency == GEOMETRY_STORE) {
+      // further MeshObjs of the same file share the store //
+      std::map<std::string, GeometryStore*>::iterator storeIter = mGeometryStores.find(fileName);
+      GeometryStore *store = (storeIter != mGeometryStores.end()) ? storeIter->second : NULL;
+      if (store == NULL) {
+        store = GeometryStore::create(meshData);
+        if (store != NULL) {
+          mGeometryStores.insert(std::make_pair(fileName, store));
+        }
+      }
+      meshObj->setGeometryStore(store);
+    }
     
     // insert MeshObj into map //
     mMeshMap.insert(std::make_pair(ID, meshObj));
@@ -244,85 +280,110 @@ MeshObj* ObjLoader::getMeshObj(std::string ID) {
   return NULL;
 }
 
+// vertices imported without a normal (no 'vn' records) get the smooth normal of their position //
+// the area weighted face normals are summed per position -> copies of a position (texture seams) stay smooth
+void ObjLoader::computeMissingNormals(MeshData &meshData, const std::vector<int> &positionIds, size_t positionCount) {
+  std::vector<glm::vec3> normalSums(positionCount, glm::vec3(0));
+  for (size_t i = 0; i + 2 < meshData.indices.size(); i += 3) {
+    glm::vec3 v[3];
+    for (int j = 0; j < 3; ++j) {
+      GLuint index = meshData.indices[i + j];
+      v[j] = glm::vec3(meshData.vertex_position[3 * index],
+		       meshData.vertex_position[3 * index + 1],
+		       meshData.vertex_position[3 * index + 2]);
+    }
+    // the length of the cross product is twice the area of the triangle //
+    glm::vec3 faceNormal = glm::cross(v[1] - v[0], v[2] - v[0]);
+    for (int j = 0; j < 3; ++j) {
+      normalSums[positionIds[meshData.indices[i + j]]] += faceNormal;
+    }
+  }
+  // given normals are kept //
+  for (size_t vertex = 0; vertex < positionIds.size(); ++vertex) {
+    GLfloat *normal = &meshData.vertex_normal[3 * vertex];
+    if (normal[0] != 0 || normal[1] != 0 || normal[2] != 0) {
+      continue;
+    }
+    glm::vec3 sum = normalSums[positionIds[vertex]];
+    GLfloat length = glm::length(sum);
+    if (length > 0) {
+      for (int j = 0; j < 3; ++j) {
+        normal[j] = sum[j] / length;
+      }
+    }
+  }
+}
+
+// computes a tangent and binormal for every vertex //
+// the tangents of the incident triangles are summed per vertex, then made orthogonal to the normal
 void ObjLoader::computeTangentSpace(MeshData &meshData) {
-  // reserve memory for tangents and binormals -> same count as vertices //
-  meshData.vertex_tangent.resize(meshData.vertex_position.size(), 0);
-  meshData.vertex_binormal.resize(meshData.vertex_position.size(), 0);
+  // one tangent and binormal per vertex //
+  const size_t vertexCount = meshData.vertex_position.size() / 3;
+  meshData.vertex_tangent.assign(3 * vertexCount, 0);
+  meshData.vertex_binormal.assign(3 * vertexCount, 0);
+  if (meshData.vertex_normal.size() != 3 * vertexCount || meshData.vertex_texcoord.size() != 2 * vertexCount) {
+    return;
+  }
   
-  // iterator over faces (given by index triplets) and calculate tangents for each incident vertex //
-  unsigned int indexCount = meshData.indices.size();
-  for (unsigned int i = 0; i < (indexCount - 2); i += 3) {
-    // get the 3 vertices and the 3 texture coordinates for this face //
+  // iterate over faces (given by index triplets) and add their tangent to each incident vertex //
+  for (size_t i = 0; i + 2 < meshData.indices.size(); i += 3) {
     glm::vec3 v[3];
     glm::vec2 t[3];
-    int positionIndex[3];
-    int textureIndex[3];
+    GLuint index[3];
     for (int j = 0; j < 3; ++j) {
-      positionIndex[j] = 3 * meshData.indices[i+j];
-      textureIndex[j] = 2 * meshData.indices[i+j];
-      v[j] = glm::vec3(meshData.vertex_position[positionIndex[j]],
-		       meshData.vertex_position[positionIndex[j] + 1],
-		       meshData.vertex_position[positionIndex[j] + 2]);
-      t[j] = glm::vec2(meshData.vertex_texcoord[textureIndex[j]],
-		       meshData.vertex_texcoord[textureIndex[j] + 1]);
+      index[j] = meshData.indices[i + j];
+      v[j] = glm::vec3(meshData.vertex_position[3 * index[j]],
+		       meshData.vertex_position[3 * index[j] + 1],
+		       meshData.vertex_position[3 * index[j] + 2]);
+      t[j] = glm::vec2(meshData.vertex_texcoord[2 * index[j]],
+		       meshData.vertex_texcoord[2 * index[j] + 1]);
     }
     
-    // compute traingle edges Q1, Q2 //
+    // triangle edges Q1, Q2 and their texture coordinate differences //
     glm::vec3 Q1 = v[1] - v[0];
     glm::vec3 Q2 = v[2] - v[0];
-    
-    // compute dU and dV //
     GLfloat du1 = t[1].x - t[0].x;
     GLfloat dv1 = t[1].y - t[0].y;
     GLfloat du2 = t[2].x - t[0].x;
     GLfloat dv2 = t[2].y - t[0].y;
-                     
-    // compute determinant //
-    GLfloat det = du1 * dv2 - dv1 * du2;
     
-    // compute the tangent for this triangle //
-    glm::vec3 tangent(1, 0, 0);
-    if (det != 0) {
-      GLfloat invDet = 1.0f / det;
-      // compute only tangent (binormal gets recomputed later anyways) //
-      tangent = (Q1 * dv2 - Q2 * dv1) * invDet;
+    // degenerate texture coordinates -> the triangle has no tangent //
+    GLfloat det = du1 * dv2 - dv1 * du2;
+    if (det == 0) {
+      continue;
     }
-    // add tangent to all vertex tangents of this face //
-    // this will average all the tangents from the incident faces for each vertex //
+    // only the tangent is needed, the binormal is computed from it and the normal //
+    glm::vec3 tangent = (Q1 * dv2 - Q2 * dv1) / det;
     for (int j = 0; j < 3; ++j) {
-      meshData.vertex_tangent[positionIndex[j]] += tangent.x;
-      meshData.vertex_tangent[positionIndex[j] + 1] += tangent.y;
-      meshData.vertex_tangent[positionIndex[j] + 2] += tangent.z;
+      for (int k = 0; k < 3; ++k) {
+        meshData.vertex_tangent[3 * index[j] + k] += tangent[k];
+      }
     }
   }
   
   // use gram-schmidt approach to reorthogonalize tangent to normal //
-  unsigned int vertexCount = meshData.vertex_position.size();
-  for (unsigned int i = 0; i < (vertexCount - 2); i += 3) {
-    glm::vec3 tangent = glm::vec3(meshData.vertex_tangent[i],
-				  meshData.vertex_tangent[i + 1],
-				  meshData.vertex_tangent[i + 2]);
-    tangent = glm::normalize(tangent);
-    
-    glm::vec3 normal = glm::vec3(meshData.vertex_normal[i],
-				 meshData.vertex_normal[i + 1],
-				 meshData.vertex_normal[i + 2]);
-    
-    GLfloat NdotT = glm::dot(normal, tangent);
-    
-    for (unsigned int j = 0; j < 3; ++j) {
-      tangent[j] = tangent[j] - NdotT * normal[j];
+  for (size_t i = 0; i < vertexCount; ++i) {
+    glm::vec3 tangent(meshData.vertex_tangent[3 * i],
+		      meshData.vertex_tangent[3 * i + 1],
+		      meshData.vertex_tangent[3 * i + 2]);
+    glm::vec3 normal(meshData.vertex_normal[3 * i],
+		     meshData.vertex_normal[3 * i + 1],
+		     meshData.vertex_normal[3 * i + 2]);
+    tangent = tangent - glm::dot(normal, tangent) * normal;
+    if (glm::length(tangent) == 0) {
+      // no triangle with texture area -> any direction perpendicular to the normal //
+      glm::vec3 axis = (std::fabs(normal.x) < 0.9f) ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+      tangent = axis - glm::dot(normal, axis) * normal;
     }
     tangent = glm::normalize(tangent);
     
     // cross product of tangent and normal yields binormal //
-    glm::vec3 binormal = glm::cross(tangent, normal);
-    binormal = glm::normalize(binormal);
+    glm::vec3 binormal = glm::normalize(glm::cross(tangent, normal));
     
     // set values back into meshData //
-    for (int j = 0; j < 3; ++j) {
-      meshData.vertex_tangent[i+j] = tangent[j];
-      meshData.vertex_binormal[i+j] = binormal[j];
+    for (int k = 0; k < 3; ++k) {
+      meshData.vertex_tangent[3 * i + k] = tangent[k];
+      meshData.vertex_binormal[3 * i + k] = binormal[k];
     }
   }
 }